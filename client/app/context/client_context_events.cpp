@@ -309,7 +309,7 @@ bool handle_events(ClientContext& ctx) {
         bool return_to_menu = false;
         for (const auto& id : ctx.ui_system.consume_pressed()) {
             if (id == kConnectId) {
-                ctx.net_client = std::make_unique<NetworkClient>(ctx.lobby_data.host, ctx.lobby_data.port);
+                ctx.net_client = std::make_unique<NetworkClient>(ctx.lobby_data.host, ctx.lobby_data.port, ctx.lobby_data.room_id);
                 if (ctx.net_client->connect(ctx.lobby_data.player_name, ctx.lobby_data.selected_level, static_cast<std::uint8_t>(ctx.settings.difficulty))) {
                     ctx.game_state = GameState::InGame;
                     ctx.had_player_before = false;
@@ -337,7 +337,7 @@ bool handle_events(ClientContext& ctx) {
         if (rebuild_connect_ui) build_connect_ui(ctx.connect_ui_registry, ctx.window.getSize(), ctx.lobby_data);
         if (ctx.connect_on_start) {
             ctx.connect_on_start = false;
-            ctx.net_client = std::make_unique<NetworkClient>(ctx.lobby_data.host, ctx.lobby_data.port);
+            ctx.net_client = std::make_unique<NetworkClient>(ctx.lobby_data.host, ctx.lobby_data.port, ctx.lobby_data.room_id);
             if (ctx.net_client->connect(ctx.lobby_data.player_name, ctx.lobby_data.selected_level, static_cast<std::uint8_t>(ctx.settings.difficulty))) {
                 ctx.game_state = GameState::InGame;
                 ctx.had_player_before = false;
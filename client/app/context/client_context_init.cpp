@@ -83,6 +83,15 @@ void initialize_context(ClientContext& ctx, int argc, char** argv) {
             ctx.lobby_data.player_name = argv[2];
         }
     }
+    if (argc >= 5) {
+        try {
+            int potential_room = std::stoi(argv[4]);
+            if (potential_room >= 0 && potential_room <= 65535) {
+                ctx.lobby_data.room_id = static_cast<std::uint16_t>(potential_room);
+            }
+        } catch (const std::invalid_argument&) {
+        }
+    }
 
     const auto window_state = ctx.settings.fullscreen ? sf::State::Fullscreen : sf::State::Windowed;
     ctx.window.create(sf::VideoMode({1280U, 720U}), "R-TYPE Client", sf::Style::Close, window_state);
@@ -123,7 +132,7 @@ void initialize_context(ClientContext& ctx, int argc, char** argv) {
     ctx.leaderboard.load("config/leaderboard.cfg");
 
     if (ctx.connect_on_start) {
-        ctx.net_client = std::make_unique<NetworkClient>(ctx.lobby_data.host, ctx.lobby_data.port);
+        ctx.net_client = std::make_unique<NetworkClient>(ctx.lobby_data.host, ctx.lobby_data.port, ctx.lobby_data.room_id);
         if (!ctx.net_client->connect(ctx.lobby_data.player_name, ctx.lobby_data.selected_level, static_cast<std::uint8_t>(ctx.settings.difficulty))) {
             ctx.net_client.reset();
         } else {
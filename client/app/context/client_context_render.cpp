@@ -1,6 +1,7 @@
 #include "client_context.hpp"
 
 #include <algorithm>
+#include <utility>
 
 #include "../ui/ui_helpers.hpp"
 
@@ -31,6 +32,12 @@ static void handle_snapshots(ClientContext& ctx) {
                     }
                 });
         }
+        ctx.net_client->release_snapshot(std::move(*snapshot));
+    }
+    while (auto bytes = ctx.net_client->poll_event()) {
+        if (auto event = rtype::game::decode_game_event(*bytes)) {
+            ctx.snapshot_system.apply_event(ctx.registry, *event);
+        }
     }
     ctx.registry.view<engine::game::components::GameStats>(
         [&](std::size_t /*eid*/, const auto& gs) {
@@ -1,16 +1,29 @@
 #include "network_client.hpp"
 
+#include <algorithm>
 #include <array>
 #include <chrono>
+#include <cmath>
 #include <iostream>
 #include <cstdio>
 
 namespace {
 constexpr std::uint8_t kSnapshotLogLimit = 5;
+// Inputs are only sent on change; while snapshots keep arriving, resend the last mask
+// this often so the server's delta baseline for us keeps moving forward.
+constexpr std::chrono::milliseconds kAckRefreshInterval{33};
+// Pause toggles on every Input the server receives, so it must never be repeated.
+constexpr std::uint16_t kInputPause = 1 << 5;
+
+std::uint32_t steady_now_ms() {
+    return static_cast<std::uint32_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
 }
 
-NetworkClient::NetworkClient(std::string host, std::uint16_t port)
-    : host_(std::move(host)), port_(port), socket_(io_ctx_) {}
+NetworkClient::NetworkClient(std::string host, std::uint16_t port, std::uint16_t room_id)
+    : host_(std::move(host)), port_(port), room_id_(room_id), socket_(io_ctx_) {}
 
 NetworkClient::~NetworkClient() {
     shutdown();
@@ -30,6 +43,8 @@ bool NetworkClient::connect(const std::string& player_name, std::uint16_t start_
     std::snprintf(hello_msg.player_name, sizeof(hello_msg.player_name), "%s", player_name.c_str());
     hello_msg.start_level = start_level;
     hello_msg.difficulty = difficulty;
+    hello_msg.room_id = room_id_;
+    hello_msg.features = engine::net::kFeatureSnapshotCompression;
     engine::net::encode_hello_payload(hello_msg, hello.payload);
     auto bytes = engine::net::serialize(hello);
     socket_.send_to(std::span<const std::uint8_t>(bytes.data(), bytes.size()), server_endpoint_);
@@ -55,7 +70,10 @@ bool NetworkClient::connect(const std::string& player_name, std::uint16_t start_
         return false;
     }
     player_id_ = welcome->player_id;
-    std::cout << "[client] Connected as #" << player_id_ << " tickrate=" << welcome->tick_rate << std::endl;
+    newest_server_sequence_ = packet->header.sequence;
+    std::cout << "[client] Connected as #" << player_id_ << " tickrate=" << welcome->tick_rate
+              << " compression=" << ((welcome->features & engine::net::kFeatureSnapshotCompression) != 0 ? "on" : "off")
+              << std::endl;
 
     running_ = true;
     listen_thread_ = std::thread([this] { listen_loop(); });
@@ -67,26 +85,52 @@ void NetworkClient::send_input(std::uint16_t mask) {
     if (player_id_ == 0) {
         return;
     }
-    engine::net::Packet packet;
-    packet.header.type = static_cast<std::uint8_t>(engine::net::MessageType::Input);
-    packet.header.sequence = sequence_counter_++;
+    last_input_mask_ = static_cast<std::uint16_t>(mask & ~kInputPause);
+    send_input_packet(mask);
+}
+
+void NetworkClient::send_input_packet(std::uint16_t mask) {
+    engine::net::PacketHeader header;
+    header.type = static_cast<std::uint8_t>(engine::net::MessageType::Input);
+    header.sequence = sequence_counter_++;
     engine::net::InputMessage msg{
         .player_id = player_id_,
         .input_mask = mask,
-        .client_time_ms = static_cast<std::uint32_t>(
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now().time_since_epoch())
-                .count()),
+        .client_time_ms = steady_now_ms(),
+        .ack_tick = decoded_tick_.load(std::memory_order_relaxed),
     };
-    engine::net::encode_input_payload(msg, packet.payload);
-    auto bytes = engine::net::serialize(packet);
-    socket_.send_to(std::span<const std::uint8_t>(bytes.data(), bytes.size()), server_endpoint_);
+    // Repeat the previous inputs so the server recovers any one that was lost.
+    for (std::uint8_t i = 0; i < sent_input_count_; ++i) {
+        const auto& sent = sent_inputs_[i];
+        msg.previous[i] = engine::net::PreviousInput{header.sequence - sent.sequence, sent.mask, sent.client_time_ms};
+    }
+    msg.previous_count = sent_input_count_;
+    std::copy_backward(sent_inputs_.begin(), sent_inputs_.end() - 1, sent_inputs_.end());
+    sent_inputs_[0] = SentInput{header.sequence, mask, msg.client_time_ms};
+    sent_input_count_ = static_cast<std::uint8_t>(std::min<std::size_t>(sent_input_count_ + 1u, sent_inputs_.size()));
+    last_acked_tick_ = msg.ack_tick;
+    last_input_sent_ = std::chrono::steady_clock::now();
+    engine::net::begin_packet(input_datagram_, header);
+    engine::net::append_input_payload(msg, input_datagram_);
+    socket_.send_to(input_datagram_.bytes(), server_endpoint_);
 }
 
 std::optional<engine::net::SnapshotMessage> NetworkClient::poll_snapshot() {
+    if (player_id_ != 0 && decoded_tick_.load(std::memory_order_relaxed) != last_acked_tick_ &&
+        std::chrono::steady_clock::now() - last_input_sent_ >= kAckRefreshInterval) {
+        send_input_packet(last_input_mask_);
+    }
     return snapshot_queue_.try_pop();
 }
 
+void NetworkClient::release_snapshot(engine::net::SnapshotMessage&& snapshot) {
+    free_snapshots_.push(std::move(snapshot));  // When full, this one is simply freed
+}
+
+std::optional<std::vector<std::uint8_t>> NetworkClient::poll_event() {
+    return event_queue_.try_pop();
+}
+
 void NetworkClient::shutdown() {
     if (!running_) {
         return;
@@ -123,42 +167,165 @@ void NetworkClient::listen_loop() {
             }
             break;  // Exit immediately on error (socket closed)
         }
-        auto packet = engine::net::deserialize(
+        auto packet = engine::net::parse_packet(
             std::span<const std::uint8_t>(buffer.data(), static_cast<std::size_t>(received)));
         if (!packet) {
             continue;
         }
-        if (packet->header.type == static_cast<std::uint8_t>(engine::net::MessageType::Snapshot)) {
-            auto snapshot =
-                engine::net::decode_snapshot_payload(
-                    std::span<const std::uint8_t>(packet->payload.data(),
-                                                packet->payload.size()));
-            if (snapshot) {
-
-                // ✅ STEP 3 — store pause state from server
-                paused_ = snapshot->paused;
-
-                if (snapshot_counter++ % kSnapshotLogLimit == 0) {
-                    std::cout << "[client] Snapshot tick=" << snapshot->tick
-                            << " paused=" << snapshot->paused
-                            << " payload=" << snapshot->blob.size() << " bytes" << std::endl;
-                }
-
-                snapshot_queue_.push(std::move(*snapshot));
+        const auto type = static_cast<engine::net::MessageType>(packet->header.type);
+        if (type == engine::net::MessageType::Ping) {
+            handle_ping_echo(packet->payload);  // Our own datagram back: not in the server's sequence
+            continue;
+        }
+        note_server_sequence(packet->header.sequence);
+        if (type == engine::net::MessageType::Snapshot) {
+            handle_snapshot_payload(packet->payload, snapshot_counter);
+        } else if (type == engine::net::MessageType::SnapshotFragment) {
+            auto fragment = engine::net::decode_fragment_payload(packet->payload);
+            if (!fragment) {
+                continue;
+            }
+            if (auto payload = reassembler_.add(*fragment, std::chrono::steady_clock::now())) {
+                handle_snapshot_payload(std::span<const std::uint8_t>(payload->data(), payload->size()),
+                                        snapshot_counter);
             }
+        } else if (type == engine::net::MessageType::Reliable) {
+            handle_reliable_payload(packet->payload);
+        }
+    }
+}
+
+void NetworkClient::note_server_sequence(std::uint32_t sequence) {
+    server_datagrams_.fetch_add(1, std::memory_order_relaxed);
+    const auto newest = newest_server_sequence_.load(std::memory_order_relaxed);
+    if (static_cast<std::int32_t>(sequence - newest) > 0) {
+        newest_server_sequence_.store(sequence, std::memory_order_relaxed);
+    }
+}
+
+void NetworkClient::handle_ping_echo(std::span<const std::uint8_t> payload) {
+    auto pong = engine::net::decode_pong_payload(payload);
+    if (!pong) {
+        return;
+    }
+    const auto now = steady_now_ms();
+    if (pong->has_server_time) {
+        if (!clock_.on_exchange(pong->ping.client_time_ms, pong->server_receive_ms, pong->server_send_ms, now)) {
+            return;
+        }
+        server_offset_ms_.store(static_cast<std::int32_t>(std::llround(clock_.offset_ms())), std::memory_order_relaxed);
+        clock_synced_.store(true, std::memory_order_release);
+    } else {
+        clock_.on_round_trip(static_cast<double>(static_cast<std::int32_t>(now - pong->ping.client_time_ms)));
+    }
+    auto to_ms = [](double ms) { return static_cast<std::uint16_t>(std::clamp(std::lround(ms), 0L, 0xFFFFL)); };
+    rtt_ms_.store(std::max<std::uint16_t>(to_ms(clock_.last_rtt_ms()), 1), std::memory_order_relaxed);
+    smoothed_rtt_ms_.store(std::max<std::uint16_t>(to_ms(clock_.rtt_ms()), 1), std::memory_order_relaxed);
+    rtt_jitter_ms_.store(to_ms(clock_.jitter_ms()), std::memory_order_relaxed);
+}
+
+std::optional<std::int32_t> NetworkClient::server_clock_offset_ms() const {
+    if (!clock_synced_.load(std::memory_order_acquire)) {
+        return std::nullopt;
+    }
+    return server_offset_ms_.load(std::memory_order_relaxed);
+}
+
+std::uint32_t NetworkClient::server_time_ms() const {
+    return steady_now_ms() + static_cast<std::uint32_t>(server_offset_ms_.load(std::memory_order_relaxed));
+}
+
+void NetworkClient::handle_reliable_payload(std::span<const std::uint8_t> payload) {
+    if (!events_.read_packet(payload)) {
+        return;
+    }
+    while (true) {
+        if (!pending_event_) {
+            pending_event_ = events_.receive();
         }
+        if (!pending_event_ || !event_queue_.push(*pending_event_)) {
+            break;
+        }
+        pending_event_.reset();
+    }
+
+    // Ack straight away so the server stops resending.
+    if (!events_.write_packet(reliable_payload_, std::chrono::steady_clock::now(),
+                              engine::net::kMaxPacketSize - engine::net::kPacketHeaderSize)) {
+        return;
     }
+    engine::net::PacketHeader header;
+    header.type = static_cast<std::uint8_t>(engine::net::MessageType::Reliable);
+    header.sequence = sequence_counter_++;
+    engine::net::begin_packet(ack_datagram_, header);
+    engine::net::write_bytes(ack_datagram_, reliable_payload_);
+    std::error_code ec;
+    socket_.native().send_to(asio::buffer(ack_datagram_.data(), ack_datagram_.size()), server_endpoint_, 0, ec);
+}
+
+void NetworkClient::handle_snapshot_payload(std::span<const std::uint8_t> payload, std::uint8_t& snapshot_counter) {
+    auto received = engine::net::decode_snapshot_view(payload);
+    if (!received) {
+        return;
+    }
+    if (!engine::net::inflate_snapshot(*received, inflated_blob_)) {
+        std::cerr << "[client] Dropped snapshot tick=" << received->tick << " (corrupt compressed blob)" << std::endl;
+        return;
+    }
+    // Deltas are rebuilt against our copy of their baseline; the game thread only sees full snapshots,
+    // decoded into a blob it handed back earlier.
+    auto& snapshot = spare_snapshot_;
+    if (!snapshot) {
+        snapshot = free_snapshots_.try_pop();
+    }
+    if (!snapshot) {
+        snapshot.emplace();
+    }
+    if (!delta_decoder_.decode(*received, *snapshot)) {
+        std::cerr << "[client] Dropped snapshot tick=" << received->tick << " (unknown baseline)" << std::endl;
+        return;
+    }
+    if (snapshot->tick > decoded_tick_.load(std::memory_order_relaxed)) {
+        decoded_tick_.store(snapshot->tick, std::memory_order_relaxed);
+    }
+
+    // ✅ STEP 3 — store pause state from server
+    paused_ = snapshot->paused;
+
+    if (snapshot_counter++ % kSnapshotLogLimit == 0) {
+        std::cout << "[client] Snapshot tick=" << snapshot->tick
+                << " paused=" << snapshot->paused
+                << " payload=" << snapshot->blob.size() << " bytes" << std::endl;
+    }
+
+    snapshot_queue_.push(std::move(*snapshot));
+    snapshot.reset();
 }
 
 void NetworkClient::ping_loop() {
     using namespace std::chrono_literals;
+    engine::net::PacketBuffer datagram;
+    std::uint32_t reported_datagrams = server_datagrams_.load(std::memory_order_relaxed);
+    std::uint32_t reported_sequence = newest_server_sequence_.load(std::memory_order_relaxed);
     while (running_) {
-        engine::net::Packet packet;
-        packet.header.type = static_cast<std::uint8_t>(engine::net::MessageType::Ping);
-        packet.header.sequence = sequence_counter_++;
-        auto bytes = engine::net::serialize(packet);
+        engine::net::PacketHeader header;
+        header.type = static_cast<std::uint8_t>(engine::net::MessageType::Ping);
+        header.sequence = sequence_counter_++;
+        // What arrived since the last ping, against what the server's sequence numbers say it sent.
+        const auto datagrams = server_datagrams_.load(std::memory_order_relaxed);
+        const auto sequence = newest_server_sequence_.load(std::memory_order_relaxed);
+        const engine::net::PingMessage ping{
+            .client_time_ms = steady_now_ms(),
+            .rtt_ms = rtt_ms_.load(std::memory_order_relaxed),
+            .received = static_cast<std::uint16_t>(std::min<std::uint32_t>(datagrams - reported_datagrams, 0xFFFF)),
+            .expected = static_cast<std::uint16_t>(std::min<std::uint32_t>(sequence - reported_sequence, 0xFFFF)),
+        };
+        reported_datagrams = datagrams;
+        reported_sequence = sequence;
+        engine::net::begin_packet(datagram, header);
+        engine::net::append_ping_payload(ping, datagram);
         std::error_code ec;
-        socket_.native().send_to(asio::buffer(bytes.data(), bytes.size()), server_endpoint_, 0, ec);
+        socket_.native().send_to(asio::buffer(datagram.data(), datagram.size()), server_endpoint_, 0, ec);
         std::this_thread::sleep_for(500ms);  // Send ping every 0.5s (well below 2s timeout)
     }
 }
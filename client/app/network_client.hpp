@@ -1,38 +1,61 @@
 #pragma once
 
 #include <asio.hpp>
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <string>
 #include <optional>
+#include <span>
 #include <thread>
 
+#include "engine/net/clock_sync.hpp"
+#include "engine/net/compression.hpp"
 #include "engine/net/packet.hpp"
-#include "engine/net/thread_safe_queue.hpp"
+#include "engine/net/reliable_channel.hpp"
+#include "engine/net/ring_queue.hpp"
 #include "engine/net/udp_socket.hpp"
 #include "engine/net/network_client_interface.hpp"
+#include "engine/game/systems/network/snapshot_codec.hpp"
 
 class NetworkClient : public engine::net::INetworkClient {
 public:
-    NetworkClient(std::string host, std::uint16_t port);
+    NetworkClient(std::string host, std::uint16_t port, std::uint16_t room_id = 0);
     ~NetworkClient();
 
     bool connect(const std::string& player_name, std::uint16_t start_level = 1, std::uint8_t difficulty = 1) override;
     void send_input(std::uint16_t mask) override;
     std::optional<engine::net::SnapshotMessage> poll_snapshot() override;
+    void release_snapshot(engine::net::SnapshotMessage&& snapshot) override;
+    std::optional<std::vector<std::uint8_t>> poll_event() override;
     void shutdown() override;
     bool is_paused() const override { return paused_; }
 
     std::uint16_t get_player_id() const override { return player_id_; }
     std::uint32_t get_last_input_sequence() const { return sequence_counter_ - 1; }
 
+    // Link timing measured over the Ping/Pong exchange; any thread. 0 until the first Pong.
+    std::uint16_t rtt_ms() const { return smoothed_rtt_ms_.load(std::memory_order_relaxed); }
+    std::uint16_t rtt_jitter_ms() const { return rtt_jitter_ms_.load(std::memory_order_relaxed); }
+    // Server clock minus ours (ms), once the server has timestamped a Pong.
+    std::optional<std::int32_t> server_clock_offset_ms() const;
+    // Our estimate of the server's clock right now, on the base of its Pong timestamps.
+    std::uint32_t server_time_ms() const;
+
 private:
     void listen_loop();
     void ping_loop();
+    void handle_snapshot_payload(std::span<const std::uint8_t> payload, std::uint8_t& snapshot_counter);
+    void handle_reliable_payload(std::span<const std::uint8_t> payload);
+    void handle_ping_echo(std::span<const std::uint8_t> payload);
+    void note_server_sequence(std::uint32_t sequence);
+    void send_input_packet(std::uint16_t mask);
     bool paused_ = false;
 
     std::string host_;
     std::uint16_t port_;
+    std::uint16_t room_id_;
     asio::io_context io_ctx_;
     engine::net::UdpSocket socket_;
     asio::ip::udp::endpoint server_endpoint_;
@@ -41,5 +64,44 @@ private:
     std::thread ping_thread_;
     std::uint16_t player_id_{0};
     std::atomic<std::uint32_t> sequence_counter_{0};
-    engine::net::ThreadSafeQueue<engine::net::SnapshotMessage> snapshot_queue_;
+    // Network thread -> game thread. Only recent snapshots matter, so overflow drops the oldest.
+    engine::net::SpscRingQueue<engine::net::SnapshotMessage> snapshot_queue_{64, engine::net::OverflowPolicy::DropOldest};
+    // Game thread -> network thread: applied snapshots whose blobs the next decode reuses.
+    engine::net::SpscRingQueue<engine::net::SnapshotMessage> free_snapshots_{64, engine::net::OverflowPolicy::Reject};
+    std::optional<engine::net::SnapshotMessage> spare_snapshot_;  // Listen thread only: taken, not yet queued
+    engine::net::SnapshotReassembler reassembler_;  // Listen thread only
+    rtype::game::SnapshotDeltaDecoder delta_decoder_;  // Listen thread only
+    std::vector<std::uint8_t> inflated_blob_;  // Listen thread only: decompressed snapshot blob
+    // Game events: the channel lives on the listen thread, which acks every Reliable packet right away.
+    // Events must not be lost, so a full queue holds the next one back in pending_event_.
+    engine::net::ReliableChannel events_;  // Listen thread only
+    std::optional<std::vector<std::uint8_t>> pending_event_;  // Listen thread only
+    std::vector<std::uint8_t> reliable_payload_;  // Listen thread only
+    engine::net::PacketBuffer ack_datagram_;  // Listen thread only
+    engine::net::PacketBuffer input_datagram_;  // Game thread only
+    engine::net::SpscRingQueue<std::vector<std::uint8_t>> event_queue_{256, engine::net::OverflowPolicy::Reject};
+    // Newest decoded snapshot tick, acknowledged to the server on Input packets as the delta baseline.
+    std::atomic<std::uint32_t> decoded_tick_{0};
+    // Link report for the server's send rate control: written by the listen thread, read by the ping thread.
+    std::atomic<std::uint32_t> server_datagrams_{0};  // Received, excluding ping echoes
+    std::atomic<std::uint32_t> newest_server_sequence_{0};
+    std::atomic<std::uint16_t> rtt_ms_{0};  // Latest sample, as reported
+    // Filtered from the Pongs by the listen thread, published for the other threads.
+    engine::net::ClockSync clock_;  // Listen thread only
+    std::atomic<std::uint16_t> smoothed_rtt_ms_{0};
+    std::atomic<std::uint16_t> rtt_jitter_ms_{0};
+    std::atomic<std::int32_t> server_offset_ms_{0};
+    std::atomic_bool clock_synced_{false};
+    // Game thread only: last mask sent and when, to refresh the ack while the mask is unchanged.
+    std::uint16_t last_input_mask_{0};
+    std::uint32_t last_acked_tick_{0};
+    std::chrono::steady_clock::time_point last_input_sent_{};
+    // Game thread only: the inputs sent before the newest one, newest first, repeated on every Input.
+    struct SentInput {
+        std::uint32_t sequence{0};
+        std::uint16_t mask{0};
+        std::uint32_t client_time_ms{0};
+    };
+    std::array<SentInput, engine::net::kInputRedundancy> sent_inputs_{};
+    std::uint8_t sent_input_count_{0};
 };
@@ -41,6 +41,7 @@ struct LobbyData {
     std::uint16_t port = 4242;
     std::string player_name = "Player";
     std::uint16_t selected_level = 1;
+    std::uint16_t room_id = 0;  // Match to join on a multi-room server
 };
 
 constexpr int kMainMenuButtonCount = 5;
@@ -17,6 +17,7 @@
 #include "engine/game/components/core/sprite.hpp"
 #include "engine/game/components/core/position.hpp"
 #include "engine/game/components/visual/sprite_id.hpp"
+#include "engine/game/systems/network/game_events.hpp"
 
 namespace client::systems {
 
@@ -41,6 +42,10 @@ public:
     //     u8  ultimate_ready
     // If snapshot.flags != 0, entities missing from the blob are removed.
     void apply(rtype::ecs::registry& registry, const engine::net::SnapshotMessage& snapshot);
+
+    // Play the effects of a reliable game event (explosions and death sounds).
+    // Snapshots no longer infer these from HP drops or disappearing entities.
+    void apply_event(rtype::ecs::registry& registry, const rtype::game::GameEvent& event);
     
     // Set volume for sound effects (0-100)
     void set_sfx_volume(float volume);
@@ -51,12 +56,7 @@ private:
     std::int16_t read_int16(const std::uint8_t* data);
     std::uint32_t last_snapshot_tick_ = 0;
 
-    // Only ships should trigger explosions (not projectiles)
-    bool is_ship_sprite(std::uint16_t sprite_id) const {
-        using engine::game::components::SpriteId;
-        return (sprite_id == static_cast<std::uint16_t>(SpriteId::Player) ||
-                sprite_id == static_cast<std::uint16_t>(SpriteId::EnemyBasic));
-    }
+    void spawn_explosion(rtype::ecs::registry& registry, float x, float y);
 
     // Sound functions
     void play_sound(const sf::SoundBuffer& buffer);
@@ -66,12 +66,8 @@ private:
     void play_enemy_destroy();
     void play_player_death();
 
-    std::unordered_map<std::uint16_t, engine::game::components::Position> last_positions_;
     std::unordered_map<std::uint16_t, std::uint16_t> last_sprite_ids_;
 
-    // Track last known HP to detect death transitions and avoid exploding projectiles.
-    std::unordered_map<std::uint16_t, std::int16_t> last_hp_;
-
     std::unordered_set<std::uint16_t> logged_missing_sprite_ids_;
 
     // Current level for applying level-specific sprites
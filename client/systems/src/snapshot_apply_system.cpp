@@ -17,6 +17,7 @@
 #include "engine/game/components/network/owner.hpp"
 #include "engine/game/components/visual/animation.hpp"
 #include "engine/game/components/visual/particle_effect.hpp"
+#include "engine/game/systems/network/snapshot_codec.hpp"
 
 namespace {
 
@@ -452,9 +453,7 @@ std::int16_t SnapshotApplySystem::read_int16(const std::uint8_t* data) {
 
 void SnapshotApplySystem::reset() {
     last_snapshot_tick_ = 0;
-    last_positions_.clear();
     last_sprite_ids_.clear();
-    last_hp_.clear();
     logged_missing_sprite_ids_.clear();
     current_level_ = 1;
 }
@@ -557,6 +556,49 @@ void SnapshotApplySystem::play_player_death() {
     }
 }
 
+void SnapshotApplySystem::spawn_explosion(rtype::ecs::registry& registry, float x, float y) {
+    auto entity = registry.spawn_entity();
+    registry.emplace_component<engine::game::components::Position>(entity, x, y);
+
+    engine::game::components::Sprite sprite{};
+    sprite.texture_id = "explosion-sheet";
+    sprite.texture_rect = {0, 0, kExplosionFrameSize, kExplosionFrameSize};
+    sprite.scale_x = kExplosionScale;
+    sprite.scale_y = kExplosionScale;
+    sprite.origin_x = static_cast<float>(kExplosionFrameSize) * 0.5f;
+    sprite.origin_y = static_cast<float>(kExplosionFrameSize) * 0.5f;
+    sprite.z_index = 0.9f;
+    sprite.visible = true;
+    registry.add_component(entity, std::move(sprite));
+
+    Animation anim;
+    anim.frames.assign(kExplosionFrames.begin(), kExplosionFrames.end());
+    anim.frame_duration_seconds = kExplosionFrameDuration;
+    anim.loop = false;
+    anim.playing = true;
+    registry.add_component(entity, std::move(anim));
+
+    registry.add_component(entity, ParticleEffect{kExplosionLifetime, 0.0f, true});
+}
+
+void SnapshotApplySystem::apply_event(rtype::ecs::registry& registry, const rtype::game::GameEvent& event) {
+    switch (event.type) {
+        case rtype::game::GameEventType::EnemyKilled:
+            spawn_explosion(registry, event.x, event.y);
+            play_enemy_destroy();
+            break;
+        case rtype::game::GameEventType::PlayerDied:
+            spawn_explosion(registry, event.x, event.y);
+            play_player_death();
+            break;
+        case rtype::game::GameEventType::LevelUp:
+        case rtype::game::GameEventType::GameOver:
+        case rtype::game::GameEventType::BossPhase:
+            // Level, game over and boss state are also in every snapshot; nothing one-shot to play yet.
+            break;
+    }
+}
+
 void SnapshotApplySystem::apply(rtype::ecs::registry& registry, const engine::net::SnapshotMessage& snapshot) {
     // SNAPSHOT STABILITY GUARD
     if (snapshot.paused) {
@@ -567,32 +609,6 @@ void SnapshotApplySystem::apply(rtype::ecs::registry& registry, const engine::ne
     }
     last_snapshot_tick_ = snapshot.tick;
 
-
-    auto spawn_explosion = [&](float x, float y) {
-        auto entity = registry.spawn_entity();
-        registry.emplace_component<engine::game::components::Position>(entity, x, y);
-
-        engine::game::components::Sprite sprite{};
-        sprite.texture_id = "explosion-sheet";
-        sprite.texture_rect = {0, 0, kExplosionFrameSize, kExplosionFrameSize};
-        sprite.scale_x = kExplosionScale;
-        sprite.scale_y = kExplosionScale;
-        sprite.origin_x = static_cast<float>(kExplosionFrameSize) * 0.5f;
-        sprite.origin_y = static_cast<float>(kExplosionFrameSize) * 0.5f;
-        sprite.z_index = 0.9f;
-        sprite.visible = true;
-        registry.add_component(entity, std::move(sprite));
-
-        Animation anim;
-        anim.frames.assign(kExplosionFrames.begin(), kExplosionFrames.end());
-        anim.frame_duration_seconds = kExplosionFrameDuration;
-        anim.loop = false;
-        anim.playing = true;
-        registry.add_component(entity, std::move(anim));
-
-        registry.add_component(entity, ParticleEffect{kExplosionLifetime, 0.0f, true});
-    };
-
     const auto& blob = snapshot.blob;
     if (blob.size() < 2) {
         std::cerr << "[SnapshotApplySystem] Blob too small: " << blob.size() << " bytes" << std::endl;
@@ -607,7 +623,8 @@ void SnapshotApplySystem::apply(rtype::ecs::registry& registry, const engine::ne
     std::size_t actual_data_size = blob.size() >= (2 + stats_size) ? blob.size() - 2 - stats_size : 0;
     std::uint16_t actual_entity_count = static_cast<std::uint16_t>(actual_data_size / per_entity);
 
-    if (actual_entity_count != entity_count) {
+    // Trust the header unless the blob is too short for it; despawn records may follow the stats.
+    if (actual_entity_count < entity_count) {
         entity_count = actual_entity_count;
     }
 
@@ -642,8 +659,6 @@ void SnapshotApplySystem::apply(rtype::ecs::registry& registry, const engine::ne
         float x = read_float(&blob[offset]); offset += 4;
         float y = read_float(&blob[offset]); offset += 4;
 
-        last_positions_[entity_id] = engine::game::components::Position{x, y};
-
         float vx = read_float(&blob[offset]); offset += 4;
         float vy = read_float(&blob[offset]); offset += 4;
 
@@ -808,28 +823,8 @@ void SnapshotApplySystem::apply(rtype::ecs::registry& registry, const engine::ne
             vel->vy = vy;
         }
 
-        // HEALTH + death detection (only ships)
+        // HEALTH (deaths arrive as game events, see apply_event)
         if (hp_cur >= 0 && hp_max > 0) {
-            // Detect transition: alive -> dead
-            const auto itPrev = last_hp_.find(entity_id);
-            const std::int16_t prev_hp = (itPrev != last_hp_.end()) ? itPrev->second : hp_cur;
-
-            const bool was_alive = (prev_hp > 0);
-            const bool is_dead   = (hp_cur <= 0);
-
-            if (was_alive && is_dead && is_ship_sprite(sprite_id)) {
-                spawn_explosion(x, y);
-                using engine::game::components::SpriteId;
-                if (sprite_id == static_cast<std::uint16_t>(SpriteId::EnemyBasic)) {
-                    play_enemy_destroy();
-                } else if (sprite_id == static_cast<std::uint16_t>(SpriteId::Player)) {
-                    play_player_death();
-                }
-            }
-
-            // Update stored hp
-            last_hp_[entity_id] = hp_cur;
-
             // Sync Health component
             auto* health = registry.try_get<engine::game::components::Health>(entity);
             if (!health) {
@@ -842,8 +837,6 @@ void SnapshotApplySystem::apply(rtype::ecs::registry& registry, const engine::ne
                 health->current = hp_cur;
                 health->max = hp_max;
             }
-        } else {
-            // No health in snapshot -> keep last_hp_ as-is (don't invent explosions)
         }
 
         // Owner
@@ -958,41 +951,46 @@ void SnapshotApplySystem::apply(rtype::ecs::registry& registry, const engine::ne
         }
     }
 
-    // FULL snapshot removal: explode ONLY if it was a ship AND last_hp <= 0
+    // FULL snapshot removal. Only entities that came from the server are culled; local effects (explosions) live on.
     if (snapshot.flags != 0) {
-        auto& positions = registry.get_components<engine::game::components::Position>();
-        for (std::size_t idx = 0; idx < positions.size(); ++idx) {
-            if (!positions[idx].has_value())
-                continue;
-
-            const auto eid = static_cast<std::uint16_t>(idx);
-            if (std::find(seen.begin(), seen.end(), eid) != seen.end())
-                continue;
-
-            // Entity disappeared from full snapshot
-            const auto itSpr = last_sprite_ids_.find(eid);
-            const std::uint16_t last_sprite = (itSpr != last_sprite_ids_.end()) ? itSpr->second : 9999;
-
-            const bool should_explode = is_ship_sprite(last_sprite);
-
-            if (should_explode) {
-                auto itPos = last_positions_.find(eid);
-                if (itPos != last_positions_.end()) {
-                    spawn_explosion(itPos->second.x, itPos->second.y);
-                }
-                using engine::game::components::SpriteId;
-                if (last_sprite == static_cast<std::uint16_t>(SpriteId::EnemyBasic)) {
-                    play_enemy_destroy();
-                } else if (last_sprite == static_cast<std::uint16_t>(SpriteId::Player)) {
-                    play_player_death();
+        std::sort(seen.begin(), seen.end());
+        std::vector<std::uint16_t> missing;
+        for (const auto& [eid, _] : last_sprite_ids_) {
+            if (!std::binary_search(seen.begin(), seen.end(), eid)) {
+                missing.push_back(eid);
+            }
+        }
+        // Despawn records (only after a delta) say why; kills play their effects from game events.
+        std::span<const std::uint8_t> despawns;
+        std::span<const std::uint8_t> trailer(blob);
+        trailer = trailer.subspan(2 + static_cast<std::size_t>(entity_count) * per_entity + stats_size);
+        if (!trailer.empty() && !rtype::game::parse_despawns(trailer, despawns)) {
+            despawns = {};
+        }
+        auto reason_of = [&despawns](std::uint16_t eid) {
+            for (std::size_t i = 0; i + rtype::game::kDespawnRecordSize <= despawns.size();
+                 i += rtype::game::kDespawnRecordSize) {
+                if (rtype::game::load_u16(&despawns[i]) == eid) {
+                    return static_cast<rtype::game::DespawnReason>(despawns[i + 2]);
                 }
             }
+            return rtype::game::DespawnReason::OffScreen;  // Unknown: remove quietly
+        };
 
-            last_positions_.erase(eid);
+        for (const auto eid : missing) {
+            using engine::game::components::SpriteId;
+            const rtype::ecs::entity_t entity{eid};
+            const auto sprite = static_cast<SpriteId>(last_sprite_ids_[eid]);
+            // Hazards shot down or crashed into have no game event of their own.
+            if ((sprite == SpriteId::LavaDrop || sprite == SpriteId::Asteroid) &&
+                reason_of(eid) == rtype::game::DespawnReason::Destroyed) {
+                if (const auto* pos = registry.try_get<engine::game::components::Position>(entity)) {
+                    spawn_explosion(registry, pos->x, pos->y);
+                }
+            }
             last_sprite_ids_.erase(eid);
-            last_hp_.erase(eid);
 
-            registry.kill_entity(rtype::ecs::entity_t{eid});
+            registry.kill_entity(entity);
         }
     }
 }
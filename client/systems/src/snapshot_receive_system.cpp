@@ -15,6 +15,7 @@ void SnapshotReceiveSystem::run(NetworkClient& client,
         if (!snapshot->paused) {
             apply.apply(reg, *snapshot);
         }
+        client.release_snapshot(std::move(*snapshot));
     }
 }
 
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace engine::core {
+
+/**
+ * @brief Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3").
+ *
+ * A keyed bijection of a 128-bit counter: the same (counter, key) always gives the same
+ * four words, on every compiler and platform, and nearby counters give unrelated words.
+ */
+inline std::array<std::uint32_t, 4> philox4x32(std::array<std::uint32_t, 4> counter,
+                                               std::array<std::uint32_t, 2> key) {
+    constexpr std::uint32_t kMultiplier0 = 0xD2511F53u;
+    constexpr std::uint32_t kMultiplier1 = 0xCD9E8D57u;
+    constexpr std::uint32_t kWeyl0 = 0x9E3779B9u;
+    constexpr std::uint32_t kWeyl1 = 0xBB67AE85u;
+
+    for (int round = 0; round < 10; ++round) {
+        if (round > 0) {
+            key[0] += kWeyl0;
+            key[1] += kWeyl1;
+        }
+        const std::uint64_t product0 = static_cast<std::uint64_t>(kMultiplier0) * counter[0];
+        const std::uint64_t product1 = static_cast<std::uint64_t>(kMultiplier1) * counter[2];
+        counter = {static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                   static_cast<std::uint32_t>(product1),
+                   static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                   static_cast<std::uint32_t>(product0)};
+    }
+    return counter;
+}
+
+/**
+ * @brief One system's sequence of random numbers: Philox keyed by the seed, counting
+ * through the stream's own half of the counter space.
+ *
+ * Draw n is a pure function of (seed, stream, n), so the whole state is position():
+ * save it to rewind, seek() to restore. uniform() and uniform_int() are computed here
+ * rather than by <random> distributions, whose output differs between standard
+ * libraries. Also a UniformRandomBitGenerator, for std::shuffle and the like.
+ */
+class RandomStream {
+public:
+    using result_type = std::uint32_t;
+
+    RandomStream() = default;
+    RandomStream(std::uint64_t seed, std::uint64_t stream)
+        : key_{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)},
+          stream_(stream) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const std::uint64_t block = position_ / 4;
+        if (block != cached_block_) {
+            block_ = philox4x32({static_cast<std::uint32_t>(block), static_cast<std::uint32_t>(block >> 32),
+                                 static_cast<std::uint32_t>(stream_), static_cast<std::uint32_t>(stream_ >> 32)},
+                                key_);
+            cached_block_ = block;
+        }
+        return block_[position_++ % 4];
+    }
+
+    // Uniform in [lo, hi), from the top 24 bits of one draw (a float's full precision).
+    float uniform(float lo, float hi) {
+        return lo + (hi - lo) * (static_cast<float>((*this)() >> 8) * 0x1p-24f);
+    }
+
+    // Uniform in [lo, hi], both inclusive, from one draw.
+    int uniform_int(int lo, int hi) {
+        const auto range = static_cast<std::uint64_t>(static_cast<std::int64_t>(hi) - lo) + 1;
+        return static_cast<int>(lo + static_cast<std::int64_t>((range * (*this)()) >> 32));
+    }
+
+    // Draws taken so far.
+    std::uint64_t position() const { return position_; }
+    void seek(std::uint64_t position) { position_ = position; }
+
+private:
+    std::array<std::uint32_t, 2> key_{};
+    std::uint64_t stream_{0};
+    std::uint64_t position_{0};
+    std::array<std::uint32_t, 4> block_{};
+    std::uint64_t cached_block_{std::numeric_limits<std::uint64_t>::max()};
+};
+
+/**
+ * @brief Hands out the independent streams of one seeded simulation.
+ *
+ * Streams of the same seed never overlap (the stream id is part of the counter), so
+ * adding draws to one system never shifts what another sees.
+ */
+class RandomSource {
+public:
+    explicit RandomSource(std::uint64_t seed = 0) : seed_(seed) {}
+
+    std::uint64_t seed() const { return seed_; }
+
+    RandomStream stream(std::uint64_t id) const { return RandomStream(seed_, id); }
+
+    template <typename Id>
+        requires std::is_enum_v<Id>
+    RandomStream stream(Id id) const {
+        return stream(static_cast<std::uint64_t>(id));
+    }
+
+private:
+    std::uint64_t seed_;
+};
+
+}  // namespace engine::core
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <thread>
+
+namespace engine::core {
+
+// What a fixed-rate loop does when a tick ends after the next one was due.
+enum class OverrunPolicy : std::uint8_t {
+    CatchUp,   // Run the late ticks back to back until on schedule (at most max_catch_up behind)
+    Skip,      // Drop the late ticks and wait for the next slot of the original schedule
+    SlowDown,  // Start the next tick now and shift the schedule: the simulation runs slower
+};
+
+/**
+ * @brief Fixed-resolution histogram of tick timings, for percentiles without storing samples.
+ *
+ * kBucket wide buckets up to kBuckets * kBucket; anything longer lands in the last one,
+ * whose percentile is reported as the exact maximum.
+ */
+class TickHistogram {
+public:
+    static constexpr std::chrono::microseconds kBucket{50};
+    static constexpr std::size_t kBuckets = 1000;  // 50 ms
+
+    void record(std::chrono::nanoseconds value) {
+        const auto bucket = static_cast<std::size_t>(std::max<std::int64_t>(value / kBucket, 0));
+        ++buckets_[std::min(bucket, kBuckets - 1)];
+        ++count_;
+        sum_ += value;
+        max_ = std::max(max_, value);
+    }
+
+    // Upper bound of the bucket holding the `fraction` quantile (0.5 = median).
+    std::chrono::nanoseconds percentile(double fraction) const {
+        if (count_ == 0) {
+            return {};
+        }
+        const auto rank = static_cast<std::uint64_t>(fraction * static_cast<double>(count_ - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i + 1 < kBuckets; ++i) {
+            seen += buckets_[i];
+            if (seen >= rank) {
+                return std::min<std::chrono::nanoseconds>(kBucket * static_cast<std::int64_t>(i + 1), max_);
+            }
+        }
+        return max_;
+    }
+
+    // Samples no longer than `bound`, at bucket resolution (bound rounded down to a bucket edge).
+    std::uint64_t count_at_most(std::chrono::nanoseconds bound) const {
+        const auto edge = static_cast<std::size_t>(std::max<std::int64_t>(bound / kBucket, 0));
+        std::uint64_t count = 0;
+        for (std::size_t i = 0; i < std::min(edge, kBuckets - 1); ++i) {
+            count += buckets_[i];
+        }
+        return count;
+    }
+
+    std::uint64_t count() const { return count_; }
+    std::chrono::nanoseconds sum() const { return sum_; }
+    std::chrono::nanoseconds max() const { return max_; }
+
+private:
+    std::array<std::uint32_t, kBuckets> buckets_{};
+    std::uint64_t count_{0};
+    std::chrono::nanoseconds sum_{0};
+    std::chrono::nanoseconds max_{0};
+};
+
+struct TickStats {
+    TickHistogram work;      // From a tick's start to the end of its work
+    TickHistogram interval;  // Between consecutive tick starts: the spacing clients see
+    std::uint64_t overruns{0};  // Ticks whose work ended after the next tick was due
+    std::uint64_t skipped{0};   // Ticks dropped by Skip, or by CatchUp beyond max_catch_up
+};
+
+/**
+ * @brief Absolute-deadline schedule for a fixed-rate loop.
+ *
+ * Tick n is due at start + n / rate, computed from the tick count rather than by adding a
+ * rounded period each time, so the average rate is exact and sleep overshoot does not
+ * accumulate. Typical loop:
+ *
+ *     clock.reset(Clock::now());
+ *     while (running) {
+ *         clock.wait();
+ *         const auto started = Clock::now();
+ *         step();
+ *         clock.finish_tick(started, Clock::now());
+ *     }
+ *
+ * wait() sleeps until shortly before the deadline and spins the rest (`spin`, 0 = plain
+ * sleep_until) to absorb the OS wake-up latency. Not thread-safe.
+ */
+class TickClock {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::uint32_t ticks_per_second{60};
+        OverrunPolicy policy{OverrunPolicy::Skip};
+        std::chrono::microseconds spin{0};
+        std::uint32_t max_catch_up{4};  // CatchUp: most ticks run late back to back
+    };
+
+    TickClock() : TickClock(Options{}) {}
+    explicit TickClock(const Options& options) : options_(options) {
+        options_.ticks_per_second = std::max<std::uint32_t>(options_.ticks_per_second, 1);
+    }
+
+    const Options& options() const { return options_; }
+    std::chrono::nanoseconds period() const { return offset(1); }
+
+    // Tick 0 is due at `now`.
+    void reset(Clock::time_point now) {
+        epoch_ = now;
+        index_ = 0;
+        last_start_.reset();
+    }
+
+    // When the next tick is due.
+    Clock::time_point deadline() const { return epoch_ + offset(index_); }
+
+    // Blocks until deadline().
+    void wait() const {
+        const auto due = deadline();
+        if (options_.spin.count() > 0) {
+            std::this_thread::sleep_until(due - options_.spin);
+            while (Clock::now() < due) {
+                std::this_thread::yield();
+            }
+        } else {
+            std::this_thread::sleep_until(due);
+        }
+    }
+
+    // Records a tick that started at `started` and finished at `finished`, and schedules the
+    // next one according to the overrun policy.
+    void finish_tick(Clock::time_point started, Clock::time_point finished) {
+        stats_.work.record(finished - started);
+        if (last_start_) {
+            stats_.interval.record(started - *last_start_);
+        }
+        last_start_ = started;
+
+        ++index_;
+        const auto next = deadline();
+        if (finished <= next) {
+            return;
+        }
+        ++stats_.overruns;
+        // Slots that went by entirely while this tick ran.
+        const auto behind = static_cast<std::uint64_t>((finished - next) / period());
+        switch (options_.policy) {
+            case OverrunPolicy::CatchUp:
+                if (behind > options_.max_catch_up) {
+                    const auto dropped = behind - options_.max_catch_up;
+                    index_ += dropped;
+                    stats_.skipped += dropped;
+                }
+                break;
+            case OverrunPolicy::Skip:
+                index_ += behind + 1;
+                stats_.skipped += behind + 1;
+                break;
+            case OverrunPolicy::SlowDown:
+                reset(finished);
+                last_start_ = started;
+                break;
+        }
+    }
+
+    const TickStats& stats() const { return stats_; }
+    void reset_stats() { stats_ = TickStats{}; }
+
+private:
+    std::chrono::nanoseconds offset(std::uint64_t ticks) const {
+        return std::chrono::nanoseconds(static_cast<std::int64_t>(ticks * 1'000'000'000ull / options_.ticks_per_second));
+    }
+
+    Options options_;
+    Clock::time_point epoch_{};
+    std::uint64_t index_{0};
+    std::optional<Clock::time_point> last_start_;
+    TickStats stats_{};
+};
+
+}  // namespace engine::core
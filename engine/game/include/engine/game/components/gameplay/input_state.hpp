@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 namespace engine::game::components {
 
     struct InputState {
@@ -9,6 +11,14 @@ namespace engine::game::components {
         bool right{false};
         bool shoot{false};
         bool ultimate{false};
+        // Set by the server from the inputs received during the tick: the trigger went down
+        // at some point (a tap shorter than a tick still fires), and for how long it had been
+        // down by the end of the tick, so the shot starts where it would be by then.
+        bool shoot_tapped{false};
+        float shoot_lead{0.0f};
+        // Server ticks between the world the player was looking at and the one its input
+        // is applied to; shots are lag-compensated by that much (see CollisionSystem).
+        std::uint8_t view_delay_ticks{0};
     };
 
 }  // namespace engine::game::components
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 namespace engine::game::components {
 
     /**
@@ -17,6 +19,7 @@ namespace engine::game::components {
         bool is_boss{false};         // True if this is a boss projectile (homing, high damage)
         bool is_homing{false};       // True if projectile tracks the player
         float homing_strength{0.0f}; // How strongly the projectile tracks (radians/sec)
+        std::uint8_t rewind_ticks{0}; // Shooter's view delay: hits are tested against enemies that many ticks back
     };
 
 }  // namespace engine::game::components
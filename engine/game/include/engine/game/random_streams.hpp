@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+namespace engine::game {
+
+// Random stream of each gameplay system in a match's engine::core::RandomSource.
+// Recorded replays depend on these values: add new ones at the end, never renumber.
+enum class RandomStreamId : std::uint32_t {
+    EnemySpawn = 1,
+    EnemyShooting = 2,
+    LavaDropSpawn = 3,
+    AsteroidSpawn = 4,
+    IceEnemySpawn = 5,
+    BossBehavior = 6,
+};
+
+}  // namespace engine::game
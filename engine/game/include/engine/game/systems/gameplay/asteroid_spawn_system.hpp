@@ -9,8 +9,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
-#include <random>
+#include "engine/core/random.hpp"
 
 namespace rtype::ecs { class registry; }
 namespace engine::game { class GameSettings; }
@@ -26,7 +27,8 @@ namespace rtype::game {
  */
 class AsteroidSpawnSystem {
 public:
-    AsteroidSpawnSystem();
+    // Spawn heights, speeds and sizes are drawn from `rng`.
+    explicit AsteroidSpawnSystem(engine::core::RandomStream rng);
     ~AsteroidSpawnSystem() = default;
 
     /**
@@ -78,10 +80,7 @@ private:
     std::uint16_t active_level_{3};     // Level with asteroids
     
     // Random number generation
-    std::mt19937 rng_;
-    std::uniform_real_distribution<float> y_distribution_;
-    std::uniform_real_distribution<float> speed_distribution_;
-    std::uniform_real_distribution<float> size_distribution_;
+    engine::core::RandomStream rng_;
     
     // Asteroid configuration
     static constexpr float SPAWN_X = 1350.0f;       // Right of screen
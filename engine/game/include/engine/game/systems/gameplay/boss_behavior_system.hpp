@@ -1,7 +1,7 @@
 #pragma once
 
 #include <cstdint>
-#include <random>
+#include "engine/core/random.hpp"
 #include "engine/core/registry.hpp"
 #include "engine/game/game_settings.hpp"
 
@@ -21,7 +21,8 @@ namespace rtype::game {
  */
 class BossBehaviorSystem {
 public:
-    BossBehaviorSystem();
+    // Movement targets and minion offsets are drawn from `rng`.
+    explicit BossBehaviorSystem(engine::core::RandomStream rng);
 
     /**
      * @brief Run boss behavior update
@@ -37,7 +38,7 @@ public:
     void reset();
 
 private:
-    std::mt19937 rng_;
+    engine::core::RandomStream rng_;
     
     // Phase timing constants
     static constexpr float PHASE_1_SHOOT_INTERVAL = 2.5f;    // Slow shooting
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <cstdint>
-#include <random>
 #include <optional>
 #include "engine/core/registry.hpp"
 #include "engine/game/game_settings.hpp"
@@ -60,7 +59,6 @@ private:
 
     std::optional<std::size_t> boss_entity_;
     float shoot_timer_;
-    std::mt19937 rng_;
 
     void spawnBoss(rtype::ecs::registry& reg, const engine::game::GameSettings& settings);
     void updateBossShooting(rtype::ecs::registry& reg, float dt);
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 #include "engine/game/components/core/position.hpp"
 #include "engine/game/components/gameplay/collider.hpp"
 #include "engine/game/components/gameplay/projectile.hpp"
@@ -20,9 +23,17 @@ namespace rtype::game {
  * using AABB (Axis-Aligned Bounding Box) collision detection. When a
  * collision is detected, it destroys the projectile and applies damage
  * to the enemy entity.
+ *
+ * Player projectiles are lag-compensated: clients see enemies a few ticks
+ * late, so a projectile with Projectile::rewind_ticks is tested against the
+ * enemy colliders recorded that many ticks ago (see record_history), up to
+ * kMaxRewindTicks. Enemies spawned since are tested where they are now.
  */
 class CollisionSystem {
 public:
+    // Longest rewind: 12 ticks, 200 ms at 60 Hz.
+    static constexpr std::size_t kMaxRewindTicks = 12;
+
     CollisionSystem() = default;
     ~CollisionSystem() = default;
 
@@ -33,7 +44,37 @@ public:
      */
     void run(rtype::ecs::registry& reg, float dt);
 
+    /**
+     * @brief Record where enemy colliders are at the end of tick `tick`
+     *
+     * Call once per tick, when the world is in the state snapshots show; the
+     * next run() counts rewinds from the tick after it. Storage is reused, so
+     * this does not allocate once the enemy count has peaked.
+     * @param reg The ECS registry containing all entities and components
+     * @param tick Server tick just simulated
+     */
+    void record_history(const rtype::ecs::registry& reg, std::uint32_t tick);
+
 private:
+    struct PastCollider {
+        std::size_t entity_id{0};
+        std::uint32_t since_tick{0};  // Recorded in every frame since; an id reused later starts over
+        float x{0.f};
+        float y{0.f};
+        float w{0.f};
+        float h{0.f};
+    };
+
+    struct HistoryFrame {
+        std::uint32_t tick{0};
+        bool recorded{false};
+        std::vector<PastCollider> colliders;  // Sorted by entity_id
+    };
+
+    // Box of enemy `entity_id` `rewind_ticks` ticks before the current one, or
+    // nullptr if there is none to rewind to (too old, or spawned since).
+    const PastCollider* find_past_collider(std::size_t entity_id, std::uint8_t rewind_ticks) const;
+
     /**
      * @brief Check if two axis-aligned bounding boxes intersect
      * @param x1 X position of first entity
@@ -68,6 +109,10 @@ private:
 
     bool projectiles_collide(const engine::game::components::FactionComponent* a_faction,
                              const engine::game::components::FactionComponent* b_faction) const;
+
+    std::array<HistoryFrame, kMaxRewindTicks> history_{};  // Indexed by tick % kMaxRewindTicks
+    std::uint32_t newest_tick_{0};
+    bool has_history_{false};
 };
 
 }  // namespace rtype::game
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "engine/core/registry.hpp"
-#include <random>
+#include "engine/core/random.hpp"
 
 namespace engine::game {
     struct GameSettings;
@@ -17,7 +17,8 @@ namespace rtype::game {
  */
 class EnemyShootingSystem {
 public:
-    EnemyShootingSystem();
+    // `rng` jitters each enemy's shot timing.
+    explicit EnemyShootingSystem(engine::core::RandomStream rng);
 
     /**
      * @brief Set the shooting interval for enemies.
@@ -43,8 +44,7 @@ private:
 
     float shoot_interval_;                          ///< Base interval between shots
     float projectile_speed_;                        ///< Speed of enemy projectiles
-    std::mt19937 rng_;                             ///< Random number generator
-    std::uniform_real_distribution<float> variance_dist_;  ///< Variance for shoot timing
+    engine::core::RandomStream rng_;                ///< Shot timing jitter
 
     static constexpr float DEFAULT_SHOOT_INTERVAL = 2.5f;
     static constexpr float DEFAULT_PROJECTILE_SPEED = -300.0f;  // Negative = towards left
@@ -1,7 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
-#include <random>
+#include "engine/core/random.hpp"
 
 namespace rtype::ecs {
     class registry;
@@ -23,7 +24,8 @@ namespace rtype::game {
  */
 class EnemySpawnSystem {
 public:
-    EnemySpawnSystem();
+    // Spawn heights, cooldowns and movement patterns are drawn from `rng`.
+    explicit EnemySpawnSystem(engine::core::RandomStream rng);
     ~EnemySpawnSystem() = default;
 
     /**
@@ -61,8 +63,7 @@ private:
     size_t total_spawned_{0};           // Total enemies ever spawned (for stats)
     
     // Random number generation
-    std::mt19937 rng_;                  // Random number generator
-    std::uniform_real_distribution<float> y_distribution_;  // Random Y position
+    engine::core::RandomStream rng_;    // Random number generator
     
     // Enemy configuration
     static constexpr float SPAWN_X = 1300.0f;      // Just outside right edge (screen width 1280)
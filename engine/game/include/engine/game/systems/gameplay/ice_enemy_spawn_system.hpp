@@ -1,7 +1,7 @@
 #pragma once
 
 #include <cstdint>
-#include <random>
+#include "engine/core/random.hpp"
 #include "engine/core/registry.hpp"
 #include "engine/game/game_settings.hpp"
 
@@ -15,7 +15,8 @@ namespace rtype::game {
  */
 class IceEnemySpawnSystem {
 public:
-    IceEnemySpawnSystem();
+    // Crab heights, shot cooldowns and patterns are drawn from `rng`.
+    explicit IceEnemySpawnSystem(engine::core::RandomStream rng);
 
     /**
      * @brief Run the spawn system
@@ -44,8 +45,7 @@ private:
     float spawn_timer_;
     float spawn_interval_;
     std::size_t max_enemies_;
-    std::mt19937 rng_;
-    std::uniform_real_distribution<float> y_distribution_;
+    engine::core::RandomStream rng_;
 
     std::size_t countIceEnemies(rtype::ecs::registry& reg) const;
     void spawnIceEnemy(rtype::ecs::registry& reg, const engine::game::GameSettings& settings);
@@ -8,8 +8,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
-#include <random>
+#include "engine/core/random.hpp"
 
 namespace rtype::ecs { class registry; }
 namespace engine::game { class GameSettings; }
@@ -25,7 +26,8 @@ namespace rtype::game {
  */
 class LavaDropSpawnSystem {
 public:
-    LavaDropSpawnSystem();
+    // Drop positions are drawn from `rng`.
+    explicit LavaDropSpawnSystem(engine::core::RandomStream rng);
     ~LavaDropSpawnSystem() = default;
 
     /**
@@ -77,8 +79,7 @@ private:
     std::uint16_t min_level_{2};        // First level with lava drops
     
     // Random number generation
-    std::mt19937 rng_;
-    std::uniform_real_distribution<float> x_distribution_;
+    engine::core::RandomStream rng_;
     
     // Lava drop configuration
     static constexpr float SPAWN_Y = -20.0f;        // Above screen
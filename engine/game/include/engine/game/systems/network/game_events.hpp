@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "engine/net/serializer.hpp"
+
+namespace rtype::game {
+
+// One-shot gameplay events sent to clients over the reliable channel, so they are
+// neither lost with a snapshot nor inferred from snapshot diffs.
+enum class GameEventType : std::uint8_t {
+    EnemyKilled = 0,  // entity_id, player_id = killer (0 = none), x/y
+    PlayerDied = 1,   // entity_id, player_id, value = lives left, x/y
+    LevelUp = 2,      // value = new level
+    GameOver = 3,
+    BossPhase = 4,    // entity_id, value = new phase
+};
+
+struct GameEvent {
+    GameEventType type{GameEventType::EnemyKilled};
+    std::uint32_t tick{0};  // Server tick the event happened on
+    std::uint16_t entity_id{0};
+    std::uint16_t player_id{0};
+    std::uint16_t value{0};
+    float x{0.f};  // Where it happened; the entity may already be gone from snapshots
+    float y{0.f};
+};
+
+inline constexpr std::size_t kGameEventSize = 1 + 4 + 2 + 2 + 2 + 4 + 4;
+
+inline void encode_game_event(const GameEvent& event, std::vector<std::uint8_t>& out) {
+    out.clear();
+    engine::net::write_value(out, static_cast<std::uint8_t>(event.type));
+    engine::net::write_value(out, event.tick);
+    engine::net::write_value(out, event.entity_id);
+    engine::net::write_value(out, event.player_id);
+    engine::net::write_value(out, event.value);
+    engine::net::write_value(out, event.x);
+    engine::net::write_value(out, event.y);
+}
+
+inline std::optional<GameEvent> decode_game_event(std::span<const std::uint8_t> data) {
+    GameEvent event;
+    std::uint8_t type = 0;
+    if (!engine::net::read_value(data, type) || type > static_cast<std::uint8_t>(GameEventType::BossPhase) ||
+        !engine::net::read_value(data, event.tick) || !engine::net::read_value(data, event.entity_id) ||
+        !engine::net::read_value(data, event.player_id) || !engine::net::read_value(data, event.value) ||
+        !engine::net::read_value(data, event.x) || !engine::net::read_value(data, event.y)) {
+        return std::nullopt;
+    }
+    event.type = static_cast<GameEventType>(type);
+    return event;
+}
+
+}  // namespace rtype::game
@@ -7,16 +7,92 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <cstring>
+#include <optional>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #include "engine/core/registry.hpp"
 #include "engine/net/packet.hpp"
+#include "engine/game/systems/network/snapshot_codec.hpp"
 
 namespace rtype::game {
 
+/**
+ * @brief Builds per-client snapshots from the registry.
+ *
+ * Every tick the world is captured once into a ring of recent states. Each client
+ * then gets a delta against the last tick it acknowledged (entities that changed
+ * since, plus the ids removed since) or a full snapshot when it has not
+ * acknowledged anything yet or its baseline has left the ring.
+ *
+ * With a replication budget (the default), each client also has its own view:
+ * the entities it holds after every snapshot we sent it. Entities that differ
+ * from the acknowledged view accumulate priority each tick (by type, and by
+ * distance to the client's ship) until they are sent, and each snapshot takes
+ * the highest-priority changes that fit in the budget. Removals and the
+ * client's own ship go first.
+ * Without a budget, encodings are cached per baseline and clients sharing a
+ * baseline share the blob. See snapshot_codec.hpp for the blob layout.
+ *
+ * Removals carry a DespawnReason: the one passed to note_despawn() before the
+ * entity disappeared, else Left for a player ship, OffScreen when it was
+ * leaving the play area, or Destroyed.
+ *
+ * capture() is sample() then commit(). The two halves share no state, so the
+ * game thread can sample() (and note_despawn()) while another thread commits
+ * the previous Capture and encodes it with snapshot_for().
+ */
 class NetworkSendSystem {
 public:
+    static constexpr std::size_t kHistorySize = 64;  // ~1 s of baselines at 60 Hz
+    static constexpr std::size_t kDefaultReplicationBudget = 1024;  // Blob bytes per client per tick
+
+    struct StatsSnapshot {
+        std::uint32_t score{0};
+        std::uint16_t wave{1};
+        std::uint16_t current_level{1};
+        std::uint16_t kills_this_level{0};
+        std::uint16_t kills_to_next_level{15};
+        std::uint16_t total_kills{0};
+    };
+
+    // One tick's replicated data, read out of the registry: all that encoding needs.
+    struct Capture {
+        std::uint32_t tick{0};
+        bool paused{false};
+        std::vector<std::pair<std::uint16_t, EntityState>> entities;  // Sorted by entity id, quantized
+        StatsSnapshot stats;
+        std::unordered_map<std::uint16_t, DespawnReason> noted_despawns;  // note_despawn() since the last sample
+    };
+
+    // Game thread: samples the registry for `tick` into `out`, reusing its buffers.
+    void sample(rtype::ecs::registry& reg, std::uint32_t tick, bool paused, Capture& out);
+    // Encoding thread: makes `capture` the current tick for snapshot_for(), and drops the
+    // encodings cached for the previous one and the views of clients not served for
+    // kHistorySize ticks. Takes the entity buffer and hands back an evicted one.
+    void commit(Capture& capture);
+    // For a Capture that will never be committed: moves its despawn reasons into the
+    // next one, which sees those entities gone.
+    static void fold(Capture& superseded, Capture& next);
+
+    // sample() and commit() on one thread.
+    void capture(rtype::ecs::registry& reg, std::uint32_t tick, bool paused);
+
+    // Snapshot of the last captured tick for a client whose last acknowledged tick is
+    // `acked_tick` (0 = none). The reference stays valid until the next capture().
+    const engine::net::SnapshotMessage& snapshot_for(std::uint32_t acked_tick);
+
+    // Budgeted snapshot of the last captured tick for client `client_id` (its ship is
+    // the Player entity it owns), using `budget_percent` of the replication budget.
+    // Falls back to snapshot_for(acked_tick) without a budget.
+    const engine::net::SnapshotMessage& snapshot_for(std::uint16_t client_id,
+                                                     std::uint32_t acked_tick,
+                                                     std::uint8_t budget_percent = 100);
+
+    // Captures `tick` and returns its full snapshot.
     engine::net::SnapshotMessage build_snapshot(
         rtype::ecs::registry& reg, 
         std::uint32_t tick,
@@ -25,37 +101,81 @@ public:
 
     void set_debug_logging(bool enabled) { debug_logging_ = enabled; }
     void set_delta_compression(bool enabled) { delta_compression_enabled_ = enabled; }
-    void set_full_snapshot_interval(std::uint32_t interval) { full_snapshot_interval_ = interval; }
+    // Blob bytes per client per tick; 0 sends every entity to every client.
+    void set_replication_budget(std::size_t bytes) { replication_budget_ = bytes; }
+
+    // Tags an entity removed before the next sample() with why it went away.
+    void note_despawn(std::uint16_t entity_id, DespawnReason reason) { noted_despawns_[entity_id] = reason; }
 
 private:
-    struct EntitySnapshot {
-        float x{0.0f};
-        float y{0.0f};
-        float vx{0.0f};
-        float vy{0.0f};
-        std::int16_t hp_cur{0};
-        std::int16_t hp_max{0};
-        std::uint16_t sprite_id{0};
-        std::uint16_t owner_id{0};
-        std::int16_t lives_remaining{-1};
-        std::int16_t lives_max{-1};
-        std::uint8_t is_spectating{0};
-        std::uint8_t ultimate_frame{0};
-        std::uint8_t ultimate_ready{0};
+    struct WorldState {
+        std::uint32_t tick{0};
+        bool valid{false};
+        bool paused{false};
+        std::vector<std::pair<std::uint16_t, EntityState>> entities;  // Sorted by entity id, quantized
+        StatsSnapshot stats;
     };
 
+    // A change that may go into a client's next snapshot.
+    struct Candidate {
+        std::uint16_t entity_id{0};
+        const EntityState* state{nullptr};  // nullptr = removal
+        float priority{0.0f};
+        std::size_t bits{0};
+        bool selected{false};
+    };
+
+    struct Despawn {
+        std::uint32_t tick{0};  // First captured tick without the entity
+        DespawnReason reason{DespawnReason::Destroyed};
+    };
+
+    struct ClientReplication {
+        std::array<WorldState, kHistorySize> views{};  // What the client holds after each tick sent to it
+        std::vector<std::pair<std::uint16_t, float>> priorities;  // Sorted by id: unsent changes
+        engine::net::SnapshotMessage snapshot;
+        std::uint32_t last_served_tick{0};
+    };
+
     bool debug_logging_ = false;
     bool delta_compression_enabled_ = true;  // Enable by default
-    std::uint32_t full_snapshot_interval_ = 60;  // Send full snapshot every N ticks
-    std::uint32_t last_full_snapshot_tick_ = 0;
-    std::unordered_map<std::uint16_t, EntitySnapshot> previous_state_;
+    std::array<WorldState, kHistorySize> history_{};
+    std::uint32_t current_tick_ = 0;
+    // Full snapshot of current_tick_, encoded on first use: budgeted clients get their own.
+    engine::net::SnapshotMessage full_snapshot_;
+    bool full_snapshot_stale_ = false;
+    // Baseline tick -> delta for the current tick (nullopt when the full snapshot is smaller).
+    std::unordered_map<std::uint32_t, std::optional<engine::net::SnapshotMessage>> delta_snapshots_;
+    std::size_t replication_budget_ = kDefaultReplicationBudget;
+    std::unordered_map<std::uint16_t, ClientReplication> clients_;
+    std::unordered_map<std::uint16_t, DespawnReason> noted_despawns_;  // Game thread, until the next sample()
+    Capture capture_;  // capture()'s own
+    std::unordered_map<std::uint16_t, Despawn> despawns_;  // Removed within the last kHistorySize ticks
+    // Reused between clients and ticks.
+    std::vector<Candidate> candidates_;
+    std::vector<std::pair<std::uint16_t, float>> next_priorities_;
+    std::vector<std::uint8_t> delta_entities_;
+    std::vector<std::uint16_t> delta_removed_;
 
     void serialize_float(std::vector<std::uint8_t>& blob, float value);
     void serialize_uint16(std::vector<std::uint8_t>& blob, std::uint16_t value);
     void serialize_uint32(std::vector<std::uint8_t>& blob, std::uint32_t value);
     void serialize_int16(std::vector<std::uint8_t>& blob, std::int16_t value);
+    void serialize_stats(std::vector<std::uint8_t>& blob, const StatsSnapshot& stats);
     std::uint16_t pick_sprite_id(rtype::ecs::registry& reg, std::size_t entity_id) const;
-    bool entity_changed(std::uint16_t entity_id, const EntitySnapshot& current) const;
+    const WorldState* find_state(std::uint32_t tick) const;
+    const engine::net::SnapshotMessage& full_snapshot();
+    static float entity_priority(const EntityState& entity, const EntityState* ship);
+    static DespawnReason infer_despawn(const EntityState& last);
+    void record_despawns(const WorldState& previous,
+                         const WorldState& state,
+                         const std::unordered_map<std::uint16_t, DespawnReason>& noted_despawns);
+    DespawnReason despawn_reason(std::uint16_t entity_id) const;
+    void collect_candidates(const WorldState& state, const WorldState* baseline, std::uint16_t client_id,
+                            ClientReplication& client);
+    void build_view(const WorldState& state, const WorldState* baseline, WorldState& view);
+    void encode_full(const WorldState& state, engine::net::SnapshotMessage& snapshot);
+    void encode_delta(const WorldState& state, const WorldState& baseline, engine::net::SnapshotMessage& snapshot);
 };
 
 }  // namespace rtype::game
@@ -0,0 +1,522 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "engine/net/packet.hpp"
+#include "engine/net/serializer.hpp"
+
+namespace rtype::game {
+
+// Snapshot blob layouts. All integers are little-endian.
+//
+// Unpacked (flags without kSnapshotFlagPacked) - what SnapshotApplySystem reads:
+//   u16 entity_count
+//   entity_count x kEntityRecordSize bytes (see append_entity_record)
+//   kSnapshotStatsSize bytes of game stats
+//   optional: u16 removed_count, removed_count x despawn record (what the last delta removed)
+//
+// Packed (kSnapshotFlagPacked) - what the server sends:
+//   u16 entity_count
+//   kSnapshotStatsSize bytes of game stats
+//   only when flags & kSnapshotFlagDelta:
+//     u32 baseline_tick                 (tick the entities are relative to)
+//     u16 removed_count, removed_count x despawn record
+//   bit stream of entity_count entities (see write_entity), padded to a byte
+//
+// Despawn record: u16 entity_id, u8 DespawnReason.
+// In a delta, an entity the baseline does not hold is a spawn record: written against
+// EntityState{}, so it carries its archetype (sprite id) and every non-default field.
+inline constexpr std::size_t kEntityRecordSize = 2 + 4 + 4 + 4 + 4 + 2 + 2 + 2 + 2 + 2 + 2 + 1 + 1 + 1;
+inline constexpr std::size_t kSnapshotStatsSize = 4 + 2 + 2 + 2 + 2 + 2;
+
+inline constexpr std::uint8_t kSnapshotFlagFull = 1 << 0;    // Every live entity is listed
+inline constexpr std::uint8_t kSnapshotFlagDelta = 1 << 1;   // Only changes since baseline_tick
+inline constexpr std::uint8_t kSnapshotFlagPacked = 1 << 2;  // Bit-packed entities
+
+using SnapshotStats = std::array<std::uint8_t, kSnapshotStatsSize>;
+
+// Why an entity left the world, so clients pick the effect instead of guessing.
+enum class DespawnReason : std::uint8_t {
+    Destroyed = 0,  // Removed in play (collision, expired)
+    Killed = 1,     // Died from damage; the matching game event carries the effects
+    OffScreen = 2,  // Left the play area
+    Left = 3,       // Its player disconnected
+    Cleared = 4,    // Level transition or match reset
+};
+inline constexpr std::size_t kDespawnRecordSize = 2 + 1;
+
+// Replicated state of one entity.
+struct EntityState {
+    float x{0.0f};
+    float y{0.0f};
+    float vx{0.0f};
+    float vy{0.0f};
+    std::int16_t hp_cur{-1};
+    std::int16_t hp_max{-1};
+    std::uint16_t sprite_id{0};
+    std::uint16_t owner_id{0};
+    std::int16_t lives_remaining{-1};
+    std::int16_t lives_max{-1};
+    std::uint8_t is_spectating{0};
+    std::uint8_t ultimate_frame{0};
+    std::uint8_t ultimate_ready{0};
+
+    bool operator==(const EntityState&) const = default;
+};
+
+// Wire precision: ~1/8 px for positions, ~1/8 px/s for velocities.
+inline constexpr engine::net::QuantizedRange kPositionXRange{-512.0f, 3584.0f, 15};
+inline constexpr engine::net::QuantizedRange kPositionYRange{-512.0f, 1536.0f, 14};
+inline constexpr engine::net::QuantizedRange kVelocityRange{-1024.0f, 1024.0f, 14};
+
+// Field groups of a packed entity; a group is only written when it differs from the reference.
+enum EntityFieldBits : std::uint32_t {
+    kFieldPosition = 1u << 0,
+    kFieldVelocity = 1u << 1,
+    kFieldHealth = 1u << 2,
+    kFieldSprite = 1u << 3,
+    kFieldOwner = 1u << 4,
+    kFieldLives = 1u << 5,
+    kFieldStatus = 1u << 6,  // Spectating + ultimate frame/ready
+};
+inline constexpr unsigned kEntityFieldCount = 7;
+
+// Rounds the float fields to what the wire can carry, so the sender's copy matches the receiver's.
+inline void quantize(EntityState& state) {
+    state.x = kPositionXRange.snap(state.x);
+    state.y = kPositionYRange.snap(state.y);
+    state.vx = kVelocityRange.snap(state.vx);
+    state.vy = kVelocityRange.snap(state.vy);
+}
+
+inline std::uint32_t changed_fields(const EntityState& state, const EntityState& reference) {
+    std::uint32_t mask = 0;
+    if (state.x != reference.x || state.y != reference.y) mask |= kFieldPosition;
+    if (state.vx != reference.vx || state.vy != reference.vy) mask |= kFieldVelocity;
+    if (state.hp_cur != reference.hp_cur || state.hp_max != reference.hp_max) mask |= kFieldHealth;
+    if (state.sprite_id != reference.sprite_id) mask |= kFieldSprite;
+    if (state.owner_id != reference.owner_id) mask |= kFieldOwner;
+    if (state.lives_remaining != reference.lives_remaining || state.lives_max != reference.lives_max) {
+        mask |= kFieldLives;
+    }
+    if (state.is_spectating != reference.is_spectating || state.ultimate_frame != reference.ultimate_frame ||
+        state.ultimate_ready != reference.ultimate_ready) {
+        mask |= kFieldStatus;
+    }
+    return mask;
+}
+
+// Packed entity: u16 id, kEntityFieldCount-bit field mask, then each present group.
+// Fields absent from the mask keep the reference value (baseline copy, or EntityState{} if new).
+inline void write_entity(engine::net::BitWriter& writer,
+                         std::uint16_t entity_id,
+                         const EntityState& state,
+                         const EntityState& reference) {
+    const auto mask = changed_fields(state, reference);
+    writer.write_bits(entity_id, 16);
+    writer.write_bits(mask, kEntityFieldCount);
+    if (mask & kFieldPosition) {
+        writer.write_bits(kPositionXRange.quantize(state.x), kPositionXRange.bits);
+        writer.write_bits(kPositionYRange.quantize(state.y), kPositionYRange.bits);
+    }
+    if (mask & kFieldVelocity) {
+        writer.write_bits(kVelocityRange.quantize(state.vx), kVelocityRange.bits);
+        writer.write_bits(kVelocityRange.quantize(state.vy), kVelocityRange.bits);
+    }
+    if (mask & kFieldHealth) {
+        writer.write_bits(static_cast<std::uint16_t>(state.hp_cur), 16);
+        writer.write_bits(static_cast<std::uint16_t>(state.hp_max), 16);
+    }
+    if (mask & kFieldSprite) {
+        writer.write_bits(state.sprite_id, 8);
+    }
+    if (mask & kFieldOwner) {
+        writer.write_bits(state.owner_id, 16);
+    }
+    if (mask & kFieldLives) {
+        // -1 (no lives) .. 254, offset by one
+        writer.write_bits(static_cast<std::uint32_t>(std::clamp<int>(state.lives_remaining + 1, 0, 255)), 8);
+        writer.write_bits(static_cast<std::uint32_t>(std::clamp<int>(state.lives_max + 1, 0, 255)), 8);
+    }
+    if (mask & kFieldStatus) {
+        writer.write_bool(state.is_spectating != 0);
+        writer.write_bits(state.ultimate_frame, 8);
+        writer.write_bool(state.ultimate_ready != 0);
+    }
+}
+
+// Size in bits of write_entity(state, reference), for packet budgeting.
+inline std::size_t packed_entity_bits(const EntityState& state, const EntityState& reference) {
+    const auto mask = changed_fields(state, reference);
+    std::size_t bits = 16 + kEntityFieldCount;
+    if (mask & kFieldPosition) bits += kPositionXRange.bits + kPositionYRange.bits;
+    if (mask & kFieldVelocity) bits += 2 * kVelocityRange.bits;
+    if (mask & kFieldHealth) bits += 32;
+    if (mask & kFieldSprite) bits += 8;
+    if (mask & kFieldOwner) bits += 16;
+    if (mask & kFieldLives) bits += 16;
+    if (mask & kFieldStatus) bits += 10;
+    return bits;
+}
+
+inline bool read_entity_id(engine::net::BitReader& reader, std::uint16_t& entity_id) {
+    std::uint32_t value = 0;
+    if (!reader.read_bits(16, value)) {
+        return false;
+    }
+    entity_id = static_cast<std::uint16_t>(value);
+    return true;
+}
+
+// Reads the field mask and present groups into `state`, which holds the reference on entry.
+inline bool read_entity_fields(engine::net::BitReader& reader, EntityState& state) {
+    std::uint32_t mask = 0;
+    if (!reader.read_bits(kEntityFieldCount, mask)) {
+        return false;
+    }
+    std::uint32_t a = 0;
+    std::uint32_t b = 0;
+    if (mask & kFieldPosition) {
+        if (!reader.read_bits(kPositionXRange.bits, a) || !reader.read_bits(kPositionYRange.bits, b)) return false;
+        state.x = kPositionXRange.dequantize(a);
+        state.y = kPositionYRange.dequantize(b);
+    }
+    if (mask & kFieldVelocity) {
+        if (!reader.read_bits(kVelocityRange.bits, a) || !reader.read_bits(kVelocityRange.bits, b)) return false;
+        state.vx = kVelocityRange.dequantize(a);
+        state.vy = kVelocityRange.dequantize(b);
+    }
+    if (mask & kFieldHealth) {
+        if (!reader.read_bits(16, a) || !reader.read_bits(16, b)) return false;
+        state.hp_cur = static_cast<std::int16_t>(static_cast<std::uint16_t>(a));
+        state.hp_max = static_cast<std::int16_t>(static_cast<std::uint16_t>(b));
+    }
+    if (mask & kFieldSprite) {
+        if (!reader.read_bits(8, a)) return false;
+        state.sprite_id = static_cast<std::uint16_t>(a);
+    }
+    if (mask & kFieldOwner) {
+        if (!reader.read_bits(16, a)) return false;
+        state.owner_id = static_cast<std::uint16_t>(a);
+    }
+    if (mask & kFieldLives) {
+        if (!reader.read_bits(8, a) || !reader.read_bits(8, b)) return false;
+        state.lives_remaining = static_cast<std::int16_t>(static_cast<int>(a) - 1);
+        state.lives_max = static_cast<std::int16_t>(static_cast<int>(b) - 1);
+    }
+    if (mask & kFieldStatus) {
+        bool spectating = false;
+        bool ready = false;
+        if (!reader.read_bool(spectating) || !reader.read_bits(8, a) || !reader.read_bool(ready)) return false;
+        state.is_spectating = spectating ? 1 : 0;
+        state.ultimate_frame = static_cast<std::uint8_t>(a);
+        state.ultimate_ready = ready ? 1 : 0;
+    }
+    return true;
+}
+
+inline std::uint16_t load_u16(const std::uint8_t* data) {
+    return static_cast<std::uint16_t>(data[0] | (data[1] << 8));
+}
+
+inline std::uint32_t load_u32(const std::uint8_t* data) {
+    return static_cast<std::uint32_t>(data[0]) | (static_cast<std::uint32_t>(data[1]) << 8) |
+           (static_cast<std::uint32_t>(data[2]) << 16) | (static_cast<std::uint32_t>(data[3]) << 24);
+}
+
+// Unpacked 35-byte entity record:
+//   u16 entity_id, f32 x, f32 y, f32 vx, f32 vy, i16 hp_cur, i16 hp_max, u16 sprite_id,
+//   u16 owner_id, i16 lives_remaining, i16 lives_max, u8 is_spectating, u8 ultimate_frame,
+//   u8 ultimate_ready
+inline void append_entity_record(std::vector<std::uint8_t>& blob, std::uint16_t entity_id, const EntityState& state) {
+    auto put16 = [&blob](std::uint16_t value) {
+        blob.push_back(static_cast<std::uint8_t>(value & 0xFF));
+        blob.push_back(static_cast<std::uint8_t>((value >> 8) & 0xFF));
+    };
+    auto put_float = [&blob](float value) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(float));
+        for (int shift = 0; shift < 32; shift += 8) {
+            blob.push_back(static_cast<std::uint8_t>((bits >> shift) & 0xFF));
+        }
+    };
+    put16(entity_id);
+    put_float(state.x);
+    put_float(state.y);
+    put_float(state.vx);
+    put_float(state.vy);
+    put16(static_cast<std::uint16_t>(state.hp_cur));
+    put16(static_cast<std::uint16_t>(state.hp_max));
+    put16(state.sprite_id);
+    put16(state.owner_id);
+    put16(static_cast<std::uint16_t>(state.lives_remaining));
+    put16(static_cast<std::uint16_t>(state.lives_max));
+    blob.push_back(state.is_spectating);
+    blob.push_back(state.ultimate_frame);
+    blob.push_back(state.ultimate_ready);
+}
+
+inline EntityState load_entity_record(std::span<const std::uint8_t> record) {
+    auto get_float = [&record](std::size_t offset) {
+        const auto bits = load_u32(record.data() + offset);
+        float value;
+        std::memcpy(&value, &bits, sizeof(float));
+        return value;
+    };
+    EntityState state;
+    state.x = get_float(2);
+    state.y = get_float(6);
+    state.vx = get_float(10);
+    state.vy = get_float(14);
+    state.hp_cur = static_cast<std::int16_t>(load_u16(record.data() + 18));
+    state.hp_max = static_cast<std::int16_t>(load_u16(record.data() + 20));
+    state.sprite_id = load_u16(record.data() + 22);
+    state.owner_id = load_u16(record.data() + 24);
+    state.lives_remaining = static_cast<std::int16_t>(load_u16(record.data() + 26));
+    state.lives_max = static_cast<std::int16_t>(load_u16(record.data() + 28));
+    state.is_spectating = record[30];
+    state.ultimate_frame = record[31];
+    state.ultimate_ready = record[32];
+    return state;
+}
+
+// Non-owning view over a parsed snapshot blob.
+struct SnapshotBlobView {
+    bool packed{false};
+    std::size_t entity_count{0};
+    std::span<const std::uint8_t> entities;  // Records (unpacked) or bit stream (packed)
+    std::span<const std::uint8_t> stats;
+    std::uint32_t baseline_tick{0};
+    std::span<const std::uint8_t> removed;
+
+    std::span<const std::uint8_t> record(std::size_t index) const {
+        return entities.subspan(index * kEntityRecordSize, kEntityRecordSize);
+    }
+    std::uint16_t record_id(std::size_t index) const { return load_u16(entities.data() + index * kEntityRecordSize); }
+    std::size_t removed_count() const { return removed.size() / kDespawnRecordSize; }
+    std::uint16_t removed_id(std::size_t index) const { return load_u16(removed.data() + index * kDespawnRecordSize); }
+    DespawnReason removed_reason(std::size_t index) const {
+        const auto reason = removed[index * kDespawnRecordSize + 2];
+        return reason <= static_cast<std::uint8_t>(DespawnReason::Cleared) ? static_cast<DespawnReason>(reason)
+                                                                          : DespawnReason::Destroyed;
+    }
+};
+
+// Reads `u16 count, count x despawn record` from the front of `data`; false if truncated.
+inline bool parse_despawns(std::span<const std::uint8_t>& data, std::span<const std::uint8_t>& removed) {
+    if (data.size() < 2) {
+        return false;
+    }
+    const std::size_t count = load_u16(data.data());
+    if (data.size() < 2 + count * kDespawnRecordSize) {
+        return false;
+    }
+    removed = data.subspan(2, count * kDespawnRecordSize);
+    data = data.subspan(2 + count * kDespawnRecordSize);
+    return true;
+}
+
+inline std::optional<SnapshotBlobView> parse_snapshot_blob(std::span<const std::uint8_t> blob, std::uint8_t flags) {
+    if (blob.size() < 2 + kSnapshotStatsSize) {
+        return std::nullopt;
+    }
+    SnapshotBlobView view;
+    view.entity_count = load_u16(blob.data());
+    view.packed = (flags & kSnapshotFlagPacked) != 0;
+    if (!view.packed) {
+        if ((flags & kSnapshotFlagDelta) != 0) {
+            return std::nullopt;  // Deltas are always packed
+        }
+        const std::size_t records_size = view.entity_count * kEntityRecordSize;
+        if (blob.size() < 2 + records_size + kSnapshotStatsSize) {
+            return std::nullopt;
+        }
+        view.entities = blob.subspan(2, records_size);
+        view.stats = blob.subspan(2 + records_size, kSnapshotStatsSize);
+        auto rest = blob.subspan(2 + records_size + kSnapshotStatsSize);
+        if (!rest.empty() && !parse_despawns(rest, view.removed)) {
+            return std::nullopt;
+        }
+        return view;
+    }
+
+    view.stats = blob.subspan(2, kSnapshotStatsSize);
+    auto rest = blob.subspan(2 + kSnapshotStatsSize);
+    if ((flags & kSnapshotFlagDelta) != 0) {
+        if (rest.size() < 4) {
+            return std::nullopt;
+        }
+        view.baseline_tick = load_u32(rest.data());
+        rest = rest.subspan(4);
+        if (!parse_despawns(rest, view.removed)) {
+            return std::nullopt;
+        }
+    }
+    view.entities = rest;
+    return view;
+}
+
+/**
+ * @brief Client side of per-client delta snapshots.
+ *
+ * Keeps the full entity state of the last kHistorySize decoded ticks so a delta
+ * can be applied to the exact baseline the server encoded it against, whatever
+ * arrived in between. Every decoded snapshot is returned as an unpacked full
+ * snapshot, the format SnapshotApplySystem reads; a delta's despawn records are
+ * passed along after the stats.
+ */
+class SnapshotDeltaDecoder {
+public:
+    static constexpr std::size_t kHistorySize = 64;
+
+    // Returns the full snapshot for `snapshot`, or nullopt if the blob is malformed
+    // or it is a delta against a tick we no longer (or never did) hold.
+    std::optional<engine::net::SnapshotMessage> decode(const engine::net::SnapshotMessage& snapshot) {
+        engine::net::SnapshotMessage full;
+        const engine::net::SnapshotView view{snapshot.tick, snapshot.flags, snapshot.paused,
+                                             snapshot.last_processed_input, snapshot.blob};
+        if (!decode(view, full)) {
+            return std::nullopt;
+        }
+        return full;
+    }
+
+    // Same, writing into `full` (false on failure). Frames and scratch lists are reused,
+    // so once `full.blob` and the history have grown to the world's size this does not allocate.
+    bool decode(const engine::net::SnapshotView& snapshot, engine::net::SnapshotMessage& full) {
+        auto view = parse_snapshot_blob(snapshot.blob, snapshot.flags);
+        if (!view) {
+            return false;
+        }
+        const bool delta = (snapshot.flags & kSnapshotFlagDelta) != 0;
+        const Frame* baseline = nullptr;
+        if (delta) {
+            baseline = find(view->baseline_tick);
+            if (!baseline || view->baseline_tick % kHistorySize == snapshot.tick % kHistorySize) {
+                return false;  // Unknown, or in the very slot this frame is about to overwrite
+            }
+        }
+
+        auto& frame = frames_[snapshot.tick % kHistorySize];
+        frame.valid = false;  // Until it is complete
+        frame.tick = snapshot.tick;
+        std::copy(view->stats.begin(), view->stats.end(), frame.stats.begin());
+        auto& entities = baseline ? changed_ : frame.entities;
+        entities.clear();
+        if (view->packed) {
+            engine::net::BitReader reader(view->entities);
+            for (std::size_t i = 0; i < view->entity_count; ++i) {
+                std::uint16_t entity_id = 0;
+                if (!read_entity_id(reader, entity_id)) {
+                    return false;
+                }
+                EntityState state = baseline ? baseline_state(*baseline, entity_id) : EntityState{};
+                if (!read_entity_fields(reader, state)) {
+                    return false;
+                }
+                entities.emplace_back(entity_id, state);
+            }
+        } else {
+            for (std::size_t i = 0; i < view->entity_count; ++i) {
+                entities.emplace_back(view->record_id(i), load_entity_record(view->record(i)));
+            }
+        }
+        std::sort(entities.begin(), entities.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        removed_.clear();
+        if (baseline) {
+            for (std::size_t i = 0; i < view->removed_count(); ++i) {
+                removed_.push_back(view->removed_id(i));
+            }
+            std::sort(removed_.begin(), removed_.end());
+            merge(baseline->entities, changed_, removed_, frame.entities);
+        }
+        frame.valid = true;
+
+        full.tick = snapshot.tick;
+        full.flags = kSnapshotFlagFull;
+        full.paused = snapshot.paused;
+        full.last_processed_input = snapshot.last_processed_input;
+        encode(frame, full.blob);
+        if (!removed_.empty()) {
+            const auto count = static_cast<std::uint16_t>(view->removed_count());
+            full.blob.push_back(static_cast<std::uint8_t>(count & 0xFF));
+            full.blob.push_back(static_cast<std::uint8_t>((count >> 8) & 0xFF));
+            full.blob.insert(full.blob.end(), view->removed.begin(), view->removed.end());
+        }
+        return true;
+    }
+
+    void reset() { frames_ = {}; }
+
+private:
+    using Entities = std::vector<std::pair<std::uint16_t, EntityState>>;
+
+    struct Frame {
+        std::uint32_t tick{0};
+        bool valid{false};
+        Entities entities;  // Sorted by entity id
+        SnapshotStats stats{};
+    };
+
+    const Frame* find(std::uint32_t tick) const {
+        const auto& frame = frames_[tick % kHistorySize];
+        return frame.valid && frame.tick == tick ? &frame : nullptr;
+    }
+
+    static EntityState baseline_state(const Frame& baseline, std::uint16_t entity_id) {
+        auto it = std::lower_bound(baseline.entities.begin(), baseline.entities.end(), entity_id,
+                                   [](const auto& entry, std::uint16_t id) { return entry.first < id; });
+        return it != baseline.entities.end() && it->first == entity_id ? it->second : EntityState{};
+    }
+
+    // Baseline entities, minus `removed`, overwritten/extended by `changed`, into `out`.
+    static void merge(const Entities& baseline, const Entities& changed, const std::vector<std::uint16_t>& removed,
+                      Entities& out) {
+        out.clear();
+        auto base = baseline.begin();
+        auto delta = changed.begin();
+        while (base != baseline.end() || delta != changed.end()) {
+            if (delta == changed.end() || (base != baseline.end() && base->first < delta->first)) {
+                if (!std::binary_search(removed.begin(), removed.end(), base->first)) {
+                    out.push_back(*base);
+                }
+                ++base;
+            } else {
+                if (base != baseline.end() && base->first == delta->first) {
+                    ++base;
+                }
+                out.push_back(*delta);
+                ++delta;
+            }
+        }
+    }
+
+    static void encode(const Frame& frame, std::vector<std::uint8_t>& blob) {
+        blob.clear();
+        blob.reserve(2 + frame.entities.size() * kEntityRecordSize + kSnapshotStatsSize);
+        const auto count = static_cast<std::uint16_t>(frame.entities.size());
+        blob.push_back(static_cast<std::uint8_t>(count & 0xFF));
+        blob.push_back(static_cast<std::uint8_t>((count >> 8) & 0xFF));
+        for (const auto& [entity_id, state] : frame.entities) {
+            append_entity_record(blob, entity_id, state);
+        }
+        blob.insert(blob.end(), frame.stats.begin(), frame.stats.end());
+    }
+
+    std::array<Frame, kHistorySize> frames_{};
+    // Reused by every decode().
+    Entities changed_;
+    std::vector<std::uint16_t> removed_;
+};
+
+}  // namespace rtype::game
@@ -1,9 +1,14 @@
 #pragma once
 
 #include "engine/core/ISystem.hpp"
+#include "engine/game/components/core/velocity.hpp"
+#include "engine/game/components/gameplay/input_state.hpp"
 
 namespace rtype::game {
 
+// Velocity a player ship moves at while `input` is held.
+engine::game::components::Velocity player_velocity(const engine::game::components::InputState& input);
+
 /**
  * @brief Updates entity positions based on their velocities
  * 
@@ -17,15 +17,12 @@
 
 namespace rtype::game {
 
-AsteroidSpawnSystem::AsteroidSpawnSystem()
+AsteroidSpawnSystem::AsteroidSpawnSystem(engine::core::RandomStream rng)
     : spawn_timer_(0.0f)
     , spawn_interval_(0.8f)       // Much faster spawning
     , max_asteroids_(15)          // Many more asteroids on screen
     , active_level_(3)
-    , rng_(std::random_device{}())
-    , y_distribution_(MIN_Y, MAX_Y)
-    , speed_distribution_(MAX_SPEED, MIN_SPEED)  // Note: both negative, MAX is more negative
-    , size_distribution_(0.8f, 1.5f)
+    , rng_(rng)
 {}
 
 void AsteroidSpawnSystem::setSpawnInterval(float interval) {
@@ -55,9 +52,9 @@ size_t AsteroidSpawnSystem::countAsteroids(rtype::ecs::registry& reg) const {
 
 void AsteroidSpawnSystem::spawnAsteroid(rtype::ecs::registry& reg) {
     // Generate random Y position and size
-    float spawn_y = y_distribution_(rng_);
-    float speed = speed_distribution_(rng_);
-    float size_mult = size_distribution_(rng_);
+    float spawn_y = rng_.uniform(MIN_Y, MAX_Y);
+    float speed = rng_.uniform(MAX_SPEED, MIN_SPEED);  // Note: both negative, MAX is more negative
+    float size_mult = rng_.uniform(0.8f, 1.5f);
     
     // Create new asteroid entity
     auto asteroid = reg.spawn_entity();
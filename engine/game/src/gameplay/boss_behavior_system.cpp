@@ -26,8 +26,8 @@
 
 namespace rtype::game {
 
-BossBehaviorSystem::BossBehaviorSystem()
-    : rng_(std::random_device{}())
+BossBehaviorSystem::BossBehaviorSystem(engine::core::RandomStream rng)
+    : rng_(rng)
 {}
 
 void BossBehaviorSystem::reset() {
@@ -123,8 +123,7 @@ void BossBehaviorSystem::updateMovement(rtype::ecs::registry& reg, std::size_t b
     phase->movement_timer -= dt;
     if (phase->movement_timer <= 0.0f) {
         // Pick new target Y
-        std::uniform_real_distribution<float> dist(MIN_Y, MAX_Y);
-        phase->target_y = dist(rng_);
+        phase->target_y = rng_.uniform(MIN_Y, MAX_Y);
         phase->movement_timer = MOVEMENT_INTERVAL;
     }
     
@@ -392,8 +391,7 @@ void BossBehaviorSystem::spawnMinion(rtype::ecs::registry& reg, float boss_x, fl
     auto minion = reg.spawn_entity();
     
     // Spawn near boss with random offset
-    std::uniform_real_distribution<float> y_offset(-100.0f, 100.0f);
-    float spawn_y = boss_y + y_offset(rng_);
+    float spawn_y = boss_y + rng_.uniform(-100.0f, 100.0f);
     spawn_y = std::clamp(spawn_y, MIN_Y, MAX_Y);
     
     reg.add_component(minion, engine::game::components::Position{boss_x - 150.0f, spawn_y});
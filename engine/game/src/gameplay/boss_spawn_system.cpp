@@ -27,7 +27,6 @@ namespace rtype::game {
 BossSpawnSystem::BossSpawnSystem()
     : boss_entity_(std::nullopt)
     , shoot_timer_(0.0f)
-    , rng_(std::random_device{}())
 {}
 
 void BossSpawnSystem::reset() {
@@ -11,6 +11,7 @@
 #include "engine/game/components/gameplay/enemy_type.hpp"
 #include "engine/game/components/gameplay/ultimate_projectile.hpp"
 #include "engine/game/components/network/owner.hpp"
+#include <algorithm>
 #include <vector>
 
 namespace rtype::game {
@@ -46,6 +47,72 @@ bool CollisionSystem::projectiles_collide(const engine::game::components::Factio
     return a_faction->faction_value != b_faction->faction_value;
 }
 
+void CollisionSystem::record_history(const rtype::ecs::registry& reg, std::uint32_t tick) {
+    const HistoryFrame* previous = nullptr;
+    if (has_history_ && newest_tick_ + 1 == tick) {
+        previous = &history_[newest_tick_ % kMaxRewindTicks];
+    }
+    auto& frame = history_[tick % kMaxRewindTicks];
+    frame.tick = tick;
+    frame.recorded = true;
+    frame.colliders.clear();
+
+    // The view walks entities in id order, so frames come out sorted and one pass
+    // over the previous frame carries each enemy's since_tick forward.
+    std::size_t carried = 0;
+    reg.view<engine::game::components::Position, engine::game::components::Collider, engine::game::components::FactionComponent>(
+        [&](size_t enemy_id, const auto& enemy_pos, const auto& enemy_col, const auto& faction) {
+            if (faction.faction_value != engine::game::components::Faction::ENEMY) {
+                return;
+            }
+            PastCollider past{};
+            past.entity_id = enemy_id;
+            past.since_tick = tick;
+            if (previous) {
+                while (carried < previous->colliders.size() && previous->colliders[carried].entity_id < enemy_id) {
+                    ++carried;
+                }
+                if (carried < previous->colliders.size() && previous->colliders[carried].entity_id == enemy_id) {
+                    past.since_tick = previous->colliders[carried].since_tick;
+                }
+            }
+            getCollisionBox(enemy_pos, enemy_col, past.x, past.y, past.w, past.h);
+            frame.colliders.push_back(past);
+        });
+    newest_tick_ = tick;
+    has_history_ = true;
+}
+
+const CollisionSystem::PastCollider* CollisionSystem::find_past_collider(std::size_t entity_id,
+                                                                         std::uint8_t rewind_ticks) const {
+    if (!has_history_ || rewind_ticks == 0) {
+        return nullptr;
+    }
+    // run() simulates the tick after the newest recorded one: rewinding by 1 is that frame.
+    const std::uint32_t rewind = std::min<std::uint32_t>(rewind_ticks, kMaxRewindTicks);
+    if (rewind > newest_tick_ + 1) {
+        return nullptr;
+    }
+    const std::uint32_t target_tick = newest_tick_ + 1 - rewind;
+
+    auto find = [entity_id](const HistoryFrame& frame) -> const PastCollider* {
+        auto it = std::lower_bound(frame.colliders.begin(), frame.colliders.end(), entity_id,
+                                   [](const PastCollider& past, std::size_t id) { return past.entity_id < id; });
+        return (it != frame.colliders.end() && it->entity_id == entity_id) ? &*it : nullptr;
+    };
+    // The newest frame tells whether this enemy existed back then, and not some
+    // other entity that had its id.
+    const auto* newest = find(history_[newest_tick_ % kMaxRewindTicks]);
+    if (!newest || newest->since_tick > target_tick) {
+        return nullptr;
+    }
+    const auto& frame = history_[target_tick % kMaxRewindTicks];
+    if (!frame.recorded || frame.tick != target_tick) {
+        return nullptr;
+    }
+    return find(frame);
+}
+
 void CollisionSystem::run(rtype::ecs::registry& reg, float /*dt*/) {
     // Track entities to destroy (projectiles that hit)
     std::vector<rtype::ecs::entity_t> projectiles_to_destroy;
@@ -80,6 +147,14 @@ void CollisionSystem::run(rtype::ecs::registry& reg, float /*dt*/) {
                     // Get enemy collision box with offset
                     float enemy_x, enemy_y, enemy_w, enemy_h;
                     getCollisionBox(enemy_pos, enemy_col, enemy_x, enemy_y, enemy_w, enemy_h);
+
+                    // Lag compensation: where the shooter saw this enemy
+                    if (const auto* past = find_past_collider(enemy_id, proj.rewind_ticks)) {
+                        enemy_x = past->x;
+                        enemy_y = past->y;
+                        enemy_w = past->w;
+                        enemy_h = past->h;
+                    }
                     
                     // Check AABB collision
                     if (checkAABBCollision(
@@ -14,11 +14,10 @@
 
 namespace rtype::game {
 
-EnemyShootingSystem::EnemyShootingSystem()
+EnemyShootingSystem::EnemyShootingSystem(engine::core::RandomStream rng)
     : shoot_interval_(DEFAULT_SHOOT_INTERVAL)
     , projectile_speed_(DEFAULT_PROJECTILE_SPEED)
-    , rng_(std::random_device{}())
-    , variance_dist_(-TIMING_VARIANCE, TIMING_VARIANCE)
+    , rng_(rng)
 {}
 
 void EnemyShootingSystem::setShootInterval(float interval) {
@@ -141,7 +140,7 @@ void EnemyShootingSystem::run(rtype::ecs::registry& reg, float dt, const engine:
                 
                 // Reset cooldown with some variance
                 const float interval = (cooldown.cooldown_seconds > 0.0f) ? cooldown.cooldown_seconds : base_interval;
-                cooldown.remaining_seconds = std::max(0.0f, interval + variance_dist_(rng_));
+                cooldown.remaining_seconds = std::max(0.0f, interval + rng_.uniform(-TIMING_VARIANCE, TIMING_VARIANCE));
             }
         }
     );
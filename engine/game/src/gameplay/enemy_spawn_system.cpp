@@ -12,17 +12,14 @@
 #include "engine/game/game_settings.hpp"
 #include <algorithm>
 #include <cmath>
-#include <random>
 
 namespace rtype::game {
 
-EnemySpawnSystem::EnemySpawnSystem()
+EnemySpawnSystem::EnemySpawnSystem(engine::core::RandomStream rng)
     : spawn_timer_(2.0f)  // Start above interval for immediate first spawn
     , spawn_interval_(1.0f)  // Faster spawning: 1 enemy per second
     , max_enemies_(50)
-    , rng_(std::random_device{}())
-    , y_distribution_(MIN_Y, MAX_Y)
-    , total_spawned_(0)
+    , rng_(rng)
 {}
 
 void EnemySpawnSystem::setSpawnInterval(float interval) {
@@ -48,7 +45,7 @@ size_t EnemySpawnSystem::countEnemies(rtype::ecs::registry& reg) const {
 
 void EnemySpawnSystem::spawnEnemy(rtype::ecs::registry& reg, const engine::game::GameSettings& settings) {
     // Generate random Y position
-    float spawn_y = y_distribution_(rng_);
+    float spawn_y = rng_.uniform(MIN_Y, MAX_Y);
     
     // Create new enemy entity
     auto enemy = reg.spawn_entity();
@@ -92,12 +89,10 @@ void EnemySpawnSystem::spawnEnemy(rtype::ecs::registry& reg, const engine::game:
         });
 
     const float base_cooldown = ENEMY_SHOOT_COOLDOWN * settings.enemy_shoot_cooldown_multiplier();
-    std::uniform_real_distribution<float> cooldown_dist(base_cooldown * 0.5f,
-                                                        base_cooldown * 1.5f);
     reg.add_component(enemy,
         engine::game::components::ShootCooldown{
             base_cooldown,
-            cooldown_dist(rng_),
+            rng_.uniform(base_cooldown * 0.5f, base_cooldown * 1.5f),
             true
         });
 
@@ -120,15 +115,11 @@ void EnemySpawnSystem::spawnEnemy(rtype::ecs::registry& reg, const engine::game:
         });
 
     // Add random movement pattern
-    std::uniform_int_distribution<int> pattern_dist(0, 4);
-    std::uniform_real_distribution<float> phase_dist(0.0f, 6.28318f);
-
-    auto pattern_type = static_cast<engine::game::components::MovementPatternType>(pattern_dist(rng_));
+    auto pattern_type = static_cast<engine::game::components::MovementPatternType>(rng_.uniform_int(0, 4));
     const float max_vertical_room = std::max(20.0f, std::min(spawn_y - MIN_Y, MAX_Y - spawn_y));
 
     auto clamp_amplitude = [&](float min_val, float max_val) {
-        std::uniform_real_distribution<float> dist(min_val, max_val);
-        float raw = dist(rng_);
+        float raw = rng_.uniform(min_val, max_val);
         return std::min(raw, max_vertical_room);
     };
 
@@ -142,19 +133,19 @@ void EnemySpawnSystem::spawnEnemy(rtype::ecs::registry& reg, const engine::game:
             break;
         case engine::game::components::MovementPatternType::SINE_WAVE:
             amplitude = clamp_amplitude(50.0f, 110.0f);
-            frequency = std::uniform_real_distribution<float>(0.35f, 0.8f)(rng_);
+            frequency = rng_.uniform(0.35f, 0.8f);
             break;
         case engine::game::components::MovementPatternType::ZIGZAG:
             amplitude = clamp_amplitude(70.0f, 130.0f);
-            frequency = std::uniform_real_distribution<float>(0.5f, 1.0f)(rng_);
+            frequency = rng_.uniform(0.5f, 1.0f);
             break;
         case engine::game::components::MovementPatternType::DIVE:
             amplitude = clamp_amplitude(80.0f, 150.0f);
-            frequency = std::uniform_real_distribution<float>(0.25f, 0.55f)(rng_);
+            frequency = rng_.uniform(0.25f, 0.55f);
             break;
         case engine::game::components::MovementPatternType::CIRCLE:
             amplitude = clamp_amplitude(45.0f, 90.0f);
-            frequency = std::uniform_real_distribution<float>(0.35f, 0.7f)(rng_);
+            frequency = rng_.uniform(0.35f, 0.7f);
             break;
     }
 
@@ -163,7 +154,7 @@ void EnemySpawnSystem::spawnEnemy(rtype::ecs::registry& reg, const engine::game:
             pattern_type,
             amplitude,              // amplitude
             frequency,              // frequency
-            phase_dist(rng_),       // initial phase
+            rng_.uniform(0.0f, 6.28318f),  // initial phase
             spawn_y,                // base_y (center line)
             0.0f,                   // elapsed
             0.0f,                   // offset_x
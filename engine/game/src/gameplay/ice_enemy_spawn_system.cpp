@@ -23,12 +23,11 @@
 
 namespace rtype::game {
 
-IceEnemySpawnSystem::IceEnemySpawnSystem()
+IceEnemySpawnSystem::IceEnemySpawnSystem(engine::core::RandomStream rng)
     : spawn_timer_(0.0f)
     , spawn_interval_(1.2f)   // Faster spawning (was 3.0)
     , max_enemies_(10)        // More ice crabs at once (was 4)
-    , rng_(std::random_device{}())
-    , y_distribution_(MIN_Y, MAX_Y)
+    , rng_(rng)
 {}
 
 void IceEnemySpawnSystem::setSpawnInterval(float interval) {
@@ -55,7 +54,7 @@ std::size_t IceEnemySpawnSystem::countIceEnemies(rtype::ecs::registry& reg) cons
 
 void IceEnemySpawnSystem::spawnIceEnemy(rtype::ecs::registry& reg, 
                                          const engine::game::GameSettings& settings) {
-    float spawn_y = y_distribution_(rng_);
+    float spawn_y = rng_.uniform(MIN_Y, MAX_Y);
     
     auto enemy = reg.spawn_entity();
     
@@ -87,9 +86,8 @@ void IceEnemySpawnSystem::spawnIceEnemy(rtype::ecs::registry& reg,
     reg.add_component(enemy, engine::game::components::Health{clamped_hp, clamped_hp});
     
     // Shooting cooldown
-    std::uniform_real_distribution<float> cooldown_dist(SHOOT_COOLDOWN * 0.8f, SHOOT_COOLDOWN * 1.2f);
     reg.add_component(enemy, engine::game::components::ShootCooldown{
-        SHOOT_COOLDOWN, cooldown_dist(rng_), true
+        SHOOT_COOLDOWN, rng_.uniform(SHOOT_COOLDOWN * 0.8f, SHOOT_COOLDOWN * 1.2f), true
     });
     
     // Track screen entry
@@ -106,11 +104,8 @@ void IceEnemySpawnSystem::spawnIceEnemy(rtype::ecs::registry& reg,
     });
     
     // Movement pattern - slower, more menacing
-    std::uniform_int_distribution<int> pattern_dist(0, 2);  // Fewer pattern types
-    std::uniform_real_distribution<float> phase_dist(0.0f, 6.28318f);
-    
     auto pattern_type = engine::game::components::MovementPatternType::SINE_WAVE;
-    int pattern_roll = pattern_dist(rng_);
+    int pattern_roll = rng_.uniform_int(0, 2);  // Fewer pattern types
     if (pattern_roll == 1) {
         pattern_type = engine::game::components::MovementPatternType::LINEAR;
     } else if (pattern_roll == 2) {
@@ -141,7 +136,7 @@ void IceEnemySpawnSystem::spawnIceEnemy(rtype::ecs::registry& reg,
         pattern_type,
         amplitude,
         frequency,
-        phase_dist(rng_),
+        rng_.uniform(0.0f, 6.28318f),
         spawn_y,
         0.0f,
         0.0f,
@@ -17,13 +17,12 @@
 
 namespace rtype::game {
 
-LavaDropSpawnSystem::LavaDropSpawnSystem()
+LavaDropSpawnSystem::LavaDropSpawnSystem(engine::core::RandomStream rng)
     : spawn_timer_(0.0f)
     , spawn_interval_(1.5f)
     , max_drops_(8)
     , min_level_(2)
-    , rng_(std::random_device{}())
-    , x_distribution_(MIN_X, MAX_X)
+    , rng_(rng)
 {}
 
 void LavaDropSpawnSystem::setSpawnInterval(float interval) {
@@ -53,7 +52,7 @@ size_t LavaDropSpawnSystem::countLavaDrops(rtype::ecs::registry& reg) const {
 
 void LavaDropSpawnSystem::spawnLavaDrop(rtype::ecs::registry& reg) {
     // Generate random X position
-    float spawn_x = x_distribution_(rng_);
+    float spawn_x = rng_.uniform(MIN_X, MAX_X);
     
     // Create new lava drop entity
     auto drop = reg.spawn_entity();
@@ -9,6 +9,8 @@
 #include "engine/game/components/core/sprite.hpp"
 #include "engine/game/components/network/owner.hpp"
 #include "engine/game/game_settings.hpp"
+
+#include <utility>
 
 namespace rtype::game {
 
@@ -31,16 +33,18 @@ void ShootingSystem::run(rtype::ecs::registry& reg, float dt, const engine::game
             }
             
             // Verificar si el botón de disparo está presionado y el cooldown ha expirado
-            if (input.shoot && cooldowns_[entity_id] <= 0.0f) {
+            if ((input.shoot || input.shoot_tapped) && cooldowns_[entity_id] <= 0.0f) {
                 // Crear una nueva entidad de proyectil
                 auto projectile_entity = reg.spawn_entity();
                 const rtype::ecs::entity_t player_entity{static_cast<rtype::ecs::entity_id_t>(entity_id)};
                 auto* player_owner = reg.try_get<engine::game::components::Owner>(player_entity);
                 
                 // Añadir componente de posición (generar proyectil en la posición del jugador)
+                // Pressed mid-tick: the shot has been flying since, move it along.
+                const float lead = input.shoot_tapped ? input.shoot_lead : 0.0f;
                 reg.add_component(projectile_entity, 
                     engine::game::components::Position{
-                        position.x + 30.0f,  // Offset to spawn in front of player
+                        position.x + 30.0f + PROJECTILE_SPEED * lead,  // Offset to spawn in front of player
                         position.y
                     });
                 
@@ -58,13 +62,15 @@ void ShootingSystem::run(rtype::ecs::registry& reg, float dt, const engine::game
                     });
                 
                 // Añadir componente de proyectil con metadata
-                reg.add_component(projectile_entity,
-                    engine::game::components::Projectile{
-                        10,                          // damage
-                        static_cast<int>(entity_id), // owner_id
-                        5.0f,                        // lifetime
-                        0.0f                         // elapsed_time
-                    });
+                engine::game::components::Projectile projectile{
+                    10,                          // damage
+                    static_cast<int>(entity_id), // owner_id
+                    5.0f,                        // lifetime
+                    0.0f                         // elapsed_time
+                };
+                // Hit what the shooter saw: enemies as they were when its view was current.
+                projectile.rewind_ticks = input.view_delay_ticks;
+                reg.add_component(projectile_entity, std::move(projectile));
                 
                 if (player_owner) {
                     reg.add_component(projectile_entity,
@@ -6,6 +6,7 @@
 */
 
 #include "engine/game/systems/network/network_send_system.hpp"
+#include "engine/game/systems/network/snapshot_codec.hpp"
 #include "engine/game/components/core/position.hpp"
 #include "engine/game/components/core/velocity.hpp"
 #include "engine/game/components/core/sprite.hpp"
@@ -20,8 +21,10 @@
 #include "engine/game/components/gameplay/ultimate_projectile.hpp"
 #include "engine/game/components/network/owner.hpp"
 #include "engine/game/components/visual/sprite_id.hpp"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
-#include <cmath>
+#include <limits>
 #include <unordered_map>
 
 namespace rtype::game {
@@ -121,60 +124,25 @@ std::uint16_t NetworkSendSystem::pick_sprite_id(rtype::ecs::registry& reg, std::
     return static_cast<std::uint16_t>(SpriteId::Player);
 }
 
-bool NetworkSendSystem::entity_changed(std::uint16_t entity_id, const EntitySnapshot& current) const {
-    auto it = previous_state_.find(entity_id);
-    if (it == previous_state_.end()) {
-        return true;  // New entity, include it
-    }
-    
-    const auto& prev = it->second;
-    const float position_threshold = 0.5f;  // 0.5 pixels
-    
-    // Check if any significant values changed
-    if (std::abs(current.x - prev.x) > position_threshold ||
-        std::abs(current.y - prev.y) > position_threshold ||
-        std::abs(current.vx - prev.vx) > position_threshold ||
-        std::abs(current.vy - prev.vy) > position_threshold ||
-        current.hp_cur != prev.hp_cur ||
-        current.hp_max != prev.hp_max ||
-        current.sprite_id != prev.sprite_id ||
-        current.owner_id != prev.owner_id ||
-        current.lives_remaining != prev.lives_remaining ||
-        current.lives_max != prev.lives_max ||
-        current.is_spectating != prev.is_spectating ||
-        current.ultimate_frame != prev.ultimate_frame ||
-        current.ultimate_ready != prev.ultimate_ready) {
-        return true;
-    }
-    
-    return false;  // No significant change
+void NetworkSendSystem::serialize_stats(std::vector<std::uint8_t>& blob, const StatsSnapshot& stats) {
+    serialize_uint32(blob, stats.score);
+    serialize_uint16(blob, stats.wave);
+    serialize_uint16(blob, stats.current_level);
+    serialize_uint16(blob, stats.kills_this_level);
+    serialize_uint16(blob, stats.kills_to_next_level);
+    serialize_uint16(blob, stats.total_kills);
 }
 
-engine::net::SnapshotMessage NetworkSendSystem::build_snapshot(
-    rtype::ecs::registry& reg,
-    std::uint32_t tick,
-    bool paused
-) {
-    engine::net::SnapshotMessage snapshot;
-    snapshot.tick = tick;
-    snapshot.paused = paused;
-    
-    // Determine if we should send a full snapshot (baseline) or delta
-    bool send_full_snapshot = !delta_compression_enabled_ || 
-                             (tick - last_full_snapshot_tick_) >= full_snapshot_interval_;
-    
-    if (send_full_snapshot) {
-        last_full_snapshot_tick_ = tick;
-        snapshot.flags = 1;  // 1 = full snapshot (client can clean missing entities)
-    } else {
-        snapshot.flags = 0;  // 0 = delta snapshot (only changed entities)
-    }
-    
-    snapshot.blob.clear();
+const NetworkSendSystem::WorldState* NetworkSendSystem::find_state(std::uint32_t tick) const {
+    const auto& state = history_[tick % kHistorySize];
+    return state.valid && state.tick == tick ? &state : nullptr;
+}
+
+void NetworkSendSystem::sample(rtype::ecs::registry& reg, std::uint32_t tick, bool paused, Capture& out) {
+    out.tick = tick;
+    out.paused = paused;
+    out.entities.clear();
 
-    // Collect entities to send (all for full snapshot, only changed for delta)
-    std::vector<std::pair<std::uint16_t, EntitySnapshot>> entities_to_send;
-    
     reg.view<engine::game::components::Position>(
         [&](size_t entity_id, auto& pos) {
             const rtype::ecs::entity_t ent{static_cast<rtype::ecs::entity_id_t>(entity_id)};
@@ -183,10 +151,9 @@ engine::net::SnapshotMessage NetworkSendSystem::build_snapshot(
             const auto owner = reg.try_get<engine::game::components::Owner>(ent);
             const auto lives = reg.try_get<engine::game::components::Lives>(ent);
             const auto spectator = reg.try_get<engine::game::components::Spectator>(ent);
-            const auto projectile = reg.try_get<engine::game::components::Projectile>(ent);
             const auto ultimate_charge = reg.try_get<engine::game::components::UltimateCharge>(ent);
 
-            EntitySnapshot current;
+            EntityState current;
             current.x = pos.x;
             current.y = pos.y;
             current.vx = vel ? vel->vx : 0.0f;
@@ -200,58 +167,134 @@ engine::net::SnapshotMessage NetworkSendSystem::build_snapshot(
             current.is_spectating = (spectator && spectator->is_spectating) ? 1 : 0;
             current.ultimate_frame = ultimate_charge ? ultimate_charge->ui_frame : 0;
             current.ultimate_ready = (ultimate_charge && ultimate_charge->ready) ? 1 : 0;
-            
-            // Projectiles are always sent (critical for gameplay, fast-moving)
-            bool always_send = (projectile != nullptr);
-            
-            // For delta snapshots, only include if changed (or always send projectiles)
-            if (send_full_snapshot || always_send || entity_changed(static_cast<std::uint16_t>(entity_id), current)) {
-                entities_to_send.emplace_back(static_cast<std::uint16_t>(entity_id), current);
-                // Update previous state
-                previous_state_[static_cast<std::uint16_t>(entity_id)] = current;
-            }
+            // Keep exactly what the client will decode, so deltas compare like with like.
+            quantize(current);
+
+            out.entities.emplace_back(static_cast<std::uint16_t>(entity_id), current);
         }
     );
-    
-    // Clean up previous_state_ for deleted entities (on full snapshots)
-    if (send_full_snapshot) {
-        std::unordered_map<std::uint16_t, EntitySnapshot> new_state;
-        for (const auto& [entity_id, _] : entities_to_send) {
-            auto it = previous_state_.find(entity_id);
-            if (it != previous_state_.end()) {
-                new_state[entity_id] = it->second;
-            }
+    // The view walks entities in index order; sort anyway so deltas can merge-walk two states.
+    if (!std::is_sorted(out.entities.begin(), out.entities.end(),
+                        [](const auto& a, const auto& b) { return a.first < b.first; })) {
+        std::sort(out.entities.begin(), out.entities.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+    }
+
+    // Global stats (score + wave + level info) if present
+    out.stats = StatsSnapshot{};
+    const auto& stats = reg.get_components<engine::game::components::GameStats>();
+    for (std::size_t idx = 0; idx < stats.size(); ++idx) {
+        if (stats[idx].has_value()) {
+            out.stats.score = stats[idx]->score;
+            out.stats.wave = stats[idx]->wave;
+            out.stats.current_level = stats[idx]->current_level;
+            out.stats.kills_this_level = stats[idx]->kills_this_level;
+            out.stats.kills_to_next_level = stats[idx]->kills_to_next_level;
+            out.stats.total_kills = stats[idx]->total_kills;
+            break;
         }
-        previous_state_ = std::move(new_state);
     }
 
-    std::uint16_t entity_count = static_cast<std::uint16_t>(entities_to_send.size());
-    
+    // Hand over the reasons noted since the last sample; keep the (cleared) map it held.
+    out.noted_despawns.clear();
+    out.noted_despawns.swap(noted_despawns_);
+}
+
+void NetworkSendSystem::fold(Capture& superseded, Capture& next) {
+    next.noted_despawns.merge(superseded.noted_despawns);  // Keeps next's reason on a clash
+    superseded.noted_despawns.clear();
+}
+
+void NetworkSendSystem::commit(Capture& capture) {
+    const auto tick = capture.tick;
+    auto& state = history_[tick % kHistorySize];
+    state.tick = tick;
+    state.valid = true;
+    state.paused = capture.paused;
+    state.entities.swap(capture.entities);
+    state.stats = capture.stats;
+
+    if (const auto* previous = find_state(current_tick_); previous && previous != &state) {
+        record_despawns(*previous, state, capture.noted_despawns);
+    }
+    capture.noted_despawns.clear();
+    std::erase_if(despawns_, [tick](const auto& entry) { return tick - entry.second.tick > kHistorySize; });
+
+    current_tick_ = tick;
+    delta_snapshots_.clear();
+    std::erase_if(clients_, [tick](const auto& entry) { return tick - entry.second.last_served_tick > kHistorySize; });
+    full_snapshot_stale_ = true;
+}
+
+const engine::net::SnapshotMessage& NetworkSendSystem::full_snapshot() {
+    if (full_snapshot_stale_) {
+        if (const auto* state = find_state(current_tick_)) {
+            encode_full(*state, full_snapshot_);
+        }
+        full_snapshot_stale_ = false;
+    }
+    return full_snapshot_;
+}
+
+void NetworkSendSystem::capture(rtype::ecs::registry& reg, std::uint32_t tick, bool paused) {
+    sample(reg, tick, paused, capture_);
+    commit(capture_);
+}
+
+DespawnReason NetworkSendSystem::infer_despawn(const EntityState& last) {
+    using engine::game::components::SpriteId;
+    if (last.sprite_id == static_cast<std::uint16_t>(SpriteId::Player) && last.owner_id != 0) {
+        return DespawnReason::Left;  // Ships turn into spectators, they are only removed on disconnect
+    }
+    // Where it would be one tick later, against the 1920x1080 screen.
+    constexpr float kStep = 1.0f / 60.0f;
+    const float x = last.x + last.vx * kStep;
+    const float y = last.y + last.vy * kStep;
+    if (x < 0.0f || x > 1920.0f || y < 0.0f || y > 1080.0f) {
+        return DespawnReason::OffScreen;
+    }
+    return DespawnReason::Destroyed;
+}
+
+void NetworkSendSystem::record_despawns(const WorldState& previous,
+                                        const WorldState& state,
+                                        const std::unordered_map<std::uint16_t, DespawnReason>& noted_despawns) {
+    auto current = state.entities.begin();
+    for (const auto& [entity_id, last] : previous.entities) {
+        while (current != state.entities.end() && current->first < entity_id) {
+            ++current;
+        }
+        if (current != state.entities.end() && current->first == entity_id) {
+            continue;
+        }
+        const auto noted = noted_despawns.find(entity_id);
+        despawns_[entity_id] = Despawn{state.tick, noted != noted_despawns.end() ? noted->second : infer_despawn(last)};
+    }
+}
+
+DespawnReason NetworkSendSystem::despawn_reason(std::uint16_t entity_id) const {
+    const auto it = despawns_.find(entity_id);
+    return it != despawns_.end() ? it->second.reason : DespawnReason::Destroyed;
+}
+
+void NetworkSendSystem::encode_full(const WorldState& state, engine::net::SnapshotMessage& snapshot) {
+    snapshot.tick = state.tick;
+    snapshot.paused = state.paused;
+    snapshot.flags = kSnapshotFlagFull | kSnapshotFlagPacked;  // Client can clean missing entities
+    snapshot.blob.clear();
+
+    std::uint16_t entity_count = static_cast<std::uint16_t>(state.entities.size());
     if (debug_logging_) {
-        std::cout << "[NetworkSendSystem] Tick=" << tick
-                  << " type=" << (send_full_snapshot ? "FULL" : "DELTA")
-                  << " entities=" << entity_count << std::endl;
+        std::cout << "[NetworkSendSystem] Tick=" << state.tick
+                  << " type=FULL entities=" << entity_count << std::endl;
     }
 
-    // Write entity count
     serialize_uint16(snapshot.blob, entity_count);
-
-    // Serialize entities
-    for (const auto& [entity_id, entity_data] : entities_to_send) {
-        serialize_uint16(snapshot.blob, entity_id);
-        serialize_float(snapshot.blob, entity_data.x);
-        serialize_float(snapshot.blob, entity_data.y);
-        serialize_float(snapshot.blob, entity_data.vx);
-        serialize_float(snapshot.blob, entity_data.vy);
-        serialize_int16(snapshot.blob, entity_data.hp_cur);
-        serialize_int16(snapshot.blob, entity_data.hp_max);
-        serialize_uint16(snapshot.blob, entity_data.sprite_id);
-        serialize_uint16(snapshot.blob, entity_data.owner_id);
-        serialize_int16(snapshot.blob, entity_data.lives_remaining);
-        serialize_int16(snapshot.blob, entity_data.lives_max);
-        snapshot.blob.push_back(entity_data.is_spectating);
-        snapshot.blob.push_back(entity_data.ultimate_frame);
-        snapshot.blob.push_back(entity_data.ultimate_ready);
+    serialize_stats(snapshot.blob, state.stats);
+    engine::net::BitWriter writer(snapshot.blob);
+    const EntityState defaults{};
+    for (const auto& [entity_id, entity_data] : state.entities) {
+        write_entity(writer, entity_id, entity_data, defaults);
 
         if (debug_logging_) {
             std::cout << "  Entity #" << entity_id
@@ -261,42 +304,266 @@ engine::net::SnapshotMessage NetworkSendSystem::build_snapshot(
                       << " sprite_id=" << entity_data.sprite_id << std::endl;
         }
     }
+    writer.flush();
 
-    // Append global stats (score + wave + level info) if present
-    std::uint32_t score = 0;
-    std::uint16_t wave = 1;
-    std::uint16_t current_level = 1;
-    std::uint16_t kills_this_level = 0;
-    std::uint16_t kills_to_next_level = 15;
-    std::uint16_t total_kills = 0;
+    if (debug_logging_) {
+        std::cout << "[NetworkSendSystem] Snapshot size: " << snapshot.blob.size()
+                  << " bytes, Level=" << state.stats.current_level
+                  << " Kills=" << state.stats.kills_this_level << "/" << state.stats.kills_to_next_level << std::endl;
+    }
+}
 
-    const auto& stats = reg.get_components<engine::game::components::GameStats>();
-    for (std::size_t idx = 0; idx < stats.size(); ++idx) {
-        if (stats[idx].has_value()) {
-            score = stats[idx]->score;
-            wave = stats[idx]->wave;
-            current_level = stats[idx]->current_level;
-            kills_this_level = stats[idx]->kills_this_level;
-            kills_to_next_level = stats[idx]->kills_to_next_level;
-            total_kills = stats[idx]->total_kills;
+void NetworkSendSystem::encode_delta(const WorldState& state,
+                                     const WorldState& baseline,
+                                     engine::net::SnapshotMessage& snapshot) {
+    snapshot.tick = state.tick;
+    snapshot.paused = state.paused;
+    snapshot.flags = kSnapshotFlagDelta | kSnapshotFlagPacked;
+
+    // Both lists are sorted by id: walk them together. Values are compared exactly
+    // (both sides hold the same quantized values) so the baselines never drift apart.
+    auto& entities = delta_entities_;
+    auto& removed = delta_removed_;
+    entities.clear();
+    removed.clear();
+    engine::net::BitWriter writer(entities);
+    std::uint16_t changed = 0;
+    const EntityState defaults{};
+    auto base = baseline.entities.begin();
+    for (const auto& [entity_id, entity_data] : state.entities) {
+        while (base != baseline.entities.end() && base->first < entity_id) {
+            removed.push_back(base->first);
+            ++base;
+        }
+        const bool known = base != baseline.entities.end() && base->first == entity_id;
+        if (!known || !(base->second == entity_data)) {
+            write_entity(writer, entity_id, entity_data, known ? base->second : defaults);
+            ++changed;
+        }
+        if (known) {
+            ++base;
+        }
+    }
+    for (; base != baseline.entities.end(); ++base) {
+        removed.push_back(base->first);
+    }
+    writer.flush();
+
+    snapshot.blob.clear();
+    serialize_uint16(snapshot.blob, changed);
+    serialize_stats(snapshot.blob, state.stats);
+    serialize_uint32(snapshot.blob, baseline.tick);
+    serialize_uint16(snapshot.blob, static_cast<std::uint16_t>(removed.size()));
+    for (const auto entity_id : removed) {
+        serialize_uint16(snapshot.blob, entity_id);
+        snapshot.blob.push_back(static_cast<std::uint8_t>(despawn_reason(entity_id)));
+    }
+    snapshot.blob.insert(snapshot.blob.end(), entities.begin(), entities.end());
+}
+
+const engine::net::SnapshotMessage& NetworkSendSystem::snapshot_for(std::uint32_t acked_tick) {
+    if (!delta_compression_enabled_ || acked_tick == 0 || acked_tick >= current_tick_) {
+        return full_snapshot();
+    }
+    const auto* baseline = find_state(acked_tick);
+    const auto* state = find_state(current_tick_);
+    if (!baseline || !state) {
+        return full_snapshot();  // Baseline expired: resync with a full snapshot
+    }
+
+    auto [it, inserted] = delta_snapshots_.try_emplace(acked_tick);
+    if (inserted) {
+        engine::net::SnapshotMessage delta;
+        encode_delta(*state, *baseline, delta);
+        if (delta.blob.size() < full_snapshot().blob.size()) {
+            it->second = std::move(delta);
+        }
+    }
+    return it->second ? *it->second : full_snapshot();
+}
+
+float NetworkSendSystem::entity_priority(const EntityState& entity, const EntityState* ship) {
+    using engine::game::components::SpriteId;
+    float priority = 1.0f;
+    switch (static_cast<SpriteId>(entity.sprite_id)) {
+        case SpriteId::Player:
+            priority = 6.0f;  // Other players; the client's own ship always goes first
+            break;
+        case SpriteId::Boss:
+            priority = 8.0f;
+            break;
+        case SpriteId::EnemyBasic:
+        case SpriteId::VolcanicEnemy:
+        case SpriteId::IceEnemy:
+            priority = 3.0f;
+            break;
+        case SpriteId::EnemyProjectile:
+        case SpriteId::IceProjectile:
+        case SpriteId::BossProjectile:
+        case SpriteId::LavaDrop:
+        case SpriteId::Asteroid:
+            priority = 2.0f;  // Threats to the player
+            break;
+        default:
+            break;  // Player projectiles
+    }
+    if (ship && ship != &entity) {
+        // Up to 3x for what is right next to the ship, fading out over kNearRadius.
+        constexpr float kNearRadius = 600.0f;
+        const float distance = std::hypot(entity.x - ship->x, entity.y - ship->y);
+        priority *= 1.0f + 2.0f * std::max(0.0f, 1.0f - distance / kNearRadius);
+    }
+    return priority;
+}
+
+void NetworkSendSystem::collect_candidates(const WorldState& state,
+                                           const WorldState* baseline,
+                                           std::uint16_t client_id,
+                                           ClientReplication& client) {
+    candidates_.clear();
+    const EntityState* ship = nullptr;
+    for (const auto& [entity_id, entity] : state.entities) {
+        if (entity.sprite_id == static_cast<std::uint16_t>(engine::game::components::SpriteId::Player) &&
+            entity.owner_id == client_id) {
+            ship = &entity;
             break;
         }
     }
-    serialize_uint32(snapshot.blob, score);
-    serialize_uint16(snapshot.blob, wave);
-    serialize_uint16(snapshot.blob, current_level);
-    serialize_uint16(snapshot.blob, kills_this_level);
-    serialize_uint16(snapshot.blob, kills_to_next_level);
-    serialize_uint16(snapshot.blob, total_kills);
 
-    if (debug_logging_) {
-        std::cout << "[NetworkSendSystem] Snapshot size: " << snapshot.blob.size()
-                  << " bytes, Level=" << current_level
-                  << " Kills=" << kills_this_level << "/" << kills_to_next_level << std::endl;
+    // Walk the world, the client's view and the accumulators together (all sorted by id).
+    const std::vector<std::pair<std::uint16_t, EntityState>> nothing;
+    const auto& known_entities = baseline ? baseline->entities : nothing;
+    auto base = known_entities.begin();
+    auto accumulator = client.priorities.begin();
+    auto accumulated = [&](std::uint16_t entity_id) {
+        while (accumulator != client.priorities.end() && accumulator->first < entity_id) {
+            ++accumulator;
+        }
+        return accumulator != client.priorities.end() && accumulator->first == entity_id ? accumulator->second : 0.0f;
+    };
+    auto removal = [](std::uint16_t entity_id) {
+        return Candidate{entity_id, nullptr, std::numeric_limits<float>::max(), kDespawnRecordSize * 8, false};
+    };
+    const EntityState defaults{};
+    for (const auto& [entity_id, entity] : state.entities) {
+        while (base != known_entities.end() && base->first < entity_id) {
+            candidates_.push_back(removal(base->first));
+            ++base;
+        }
+        const bool known = base != known_entities.end() && base->first == entity_id;
+        if (!known || !(base->second == entity)) {
+            // The client reconciles its prediction against its own ship: never hold it back.
+            // Spawns count double so new entities show up promptly.
+            const float priority = &entity == ship
+                ? std::numeric_limits<float>::max()
+                : accumulated(entity_id) + entity_priority(entity, ship) * (known ? 1.0f : 2.0f);
+            candidates_.push_back(Candidate{entity_id, &entity, priority,
+                                            packed_entity_bits(entity, known ? base->second : defaults), false});
+        }
+        if (known) {
+            ++base;
+        }
     }
+    for (; base != known_entities.end(); ++base) {
+        candidates_.push_back(removal(base->first));
+    }
+}
 
-    // STEP 4: Return the complete snapshot
-    return snapshot;
+void NetworkSendSystem::build_view(const WorldState& state, const WorldState* baseline, WorldState& view) {
+    // The client's view after this snapshot: its baseline with the selected changes applied.
+    view.tick = state.tick;
+    view.valid = true;
+    view.paused = state.paused;
+    view.stats = state.stats;
+    view.entities.clear();
+    const std::vector<std::pair<std::uint16_t, EntityState>> nothing;
+    const auto& known_entities = baseline ? baseline->entities : nothing;
+    auto base = known_entities.begin();
+    auto candidate = candidates_.begin();
+    while (base != known_entities.end() || candidate != candidates_.end()) {
+        if (candidate != candidates_.end() && !candidate->selected) {
+            ++candidate;
+            continue;
+        }
+        if (candidate == candidates_.end() || (base != known_entities.end() && base->first < candidate->entity_id)) {
+            view.entities.push_back(*base);
+            ++base;
+            continue;
+        }
+        if (base != known_entities.end() && base->first == candidate->entity_id) {
+            ++base;
+        }
+        if (candidate->state) {
+            view.entities.emplace_back(candidate->entity_id, *candidate->state);
+        }
+        ++candidate;
+    }
+}
+
+const engine::net::SnapshotMessage& NetworkSendSystem::snapshot_for(std::uint16_t client_id,
+                                                                    std::uint32_t acked_tick,
+                                                                    std::uint8_t budget_percent) {
+    if (replication_budget_ == 0) {
+        return snapshot_for(acked_tick);
+    }
+    const auto* state = find_state(current_tick_);
+    if (!state) {
+        return full_snapshot();
+    }
+
+    auto& client = clients_[client_id];
+    client.last_served_tick = current_tick_;
+    const WorldState* baseline = nullptr;
+    if (delta_compression_enabled_ && acked_tick != 0 && acked_tick < current_tick_ &&
+        current_tick_ - acked_tick < kHistorySize) {
+        const auto& acked_view = client.views[acked_tick % kHistorySize];
+        if (acked_view.valid && acked_view.tick == acked_tick) {
+            baseline = &acked_view;
+        }
+    }
+    collect_candidates(*state, baseline, client_id, client);
+
+    // Highest priority first; whatever does not fit keeps its priority and waits.
+    std::sort(candidates_.begin(), candidates_.end(), [](const Candidate& a, const Candidate& b) {
+        return a.priority != b.priority ? a.priority > b.priority : a.entity_id < b.entity_id;
+    });
+    const std::size_t fixed_bytes = 2 + kSnapshotStatsSize + (baseline ? 4 + 2 : 0);
+    const std::size_t budget = replication_budget_ * budget_percent / 100;
+    std::size_t budget_bits = budget > fixed_bytes ? (budget - fixed_bytes) * 8 : 0;
+    for (auto& candidate : candidates_) {
+        if (candidate.bits <= budget_bits) {
+            candidate.selected = true;
+            budget_bits -= candidate.bits;
+        }
+    }
+    std::sort(candidates_.begin(), candidates_.end(),
+              [](const Candidate& a, const Candidate& b) { return a.entity_id < b.entity_id; });
+
+    next_priorities_.clear();
+    for (const auto& candidate : candidates_) {
+        if (candidate.state && !candidate.selected) {
+            next_priorities_.emplace_back(candidate.entity_id, candidate.priority);
+        }
+    }
+    client.priorities.swap(next_priorities_);
+
+    auto& view = client.views[current_tick_ % kHistorySize];
+    build_view(*state, baseline, view);
+    if (baseline) {
+        encode_delta(view, *baseline, client.snapshot);
+    } else {
+        encode_full(view, client.snapshot);  // Only what fits; the client drops the rest until later deltas
+    }
+    return client.snapshot;
+}
+
+engine::net::SnapshotMessage NetworkSendSystem::build_snapshot(
+    rtype::ecs::registry& reg,
+    std::uint32_t tick,
+    bool paused
+) {
+    capture(reg, tick, paused);
+    return full_snapshot();
 }
 
 }  // namespace rtype::game
@@ -17,6 +17,30 @@ constexpr float SCREEN_WIDTH = 1280.0f;
 constexpr float SCREEN_HEIGHT = 720.0f;
 constexpr float PLAYER_MARGIN = 16.0f;  // Small margin from screen edges
 
+engine::game::components::Velocity player_velocity(const engine::game::components::InputState& input) {
+    engine::game::components::Velocity vel{0.0f, 0.0f};
+    if (input.up) {
+        vel.vy -= PLAYER_SPEED;
+    }
+    if (input.down) {
+        vel.vy += PLAYER_SPEED;
+    }
+    if (input.left) {
+        vel.vx -= PLAYER_SPEED;
+    }
+    if (input.right) {
+        vel.vx += PLAYER_SPEED;
+    }
+
+    // Normalize diagonal movement for consistent speed
+    if ((input.up || input.down) && (input.left || input.right)) {
+        float factor = 0.707f; // 1/sqrt(2) for normalized diagonal
+        vel.vx *= factor;
+        vel.vy *= factor;
+    }
+    return vel;
+}
+
 void MovementSystem::run(rtype::ecs::registry& reg, float dt) {
     // First pass: Update velocities based on input for player-controlled entities
     // Only iterates over entities that have ALL three components: Velocity, InputState, FactionComponent
@@ -31,30 +55,8 @@ void MovementSystem::run(rtype::ecs::registry& reg, float dt) {
                 return;
             }
             
-            // Reset velocity
-            vel.vx = 0.0f;
-            vel.vy = 0.0f;
-
             // Set velocity based on input
-            if (input.up) {
-                vel.vy -= PLAYER_SPEED;
-            }
-            if (input.down) {
-                vel.vy += PLAYER_SPEED;
-            }
-            if (input.left) {
-                vel.vx -= PLAYER_SPEED;
-            }
-            if (input.right) {
-                vel.vx += PLAYER_SPEED;
-            }
-
-            // Normalize diagonal movement for consistent speed
-            if ((input.up || input.down) && (input.left || input.right)) {
-                float factor = 0.707f; // 1/sqrt(2) for normalized diagonal
-                vel.vx *= factor;
-                vel.vy *= factor;
-            }
+            vel = player_velocity(input);
         });
 
     // Second pass: Apply physics integration to all entities with Position + Velocity
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace engine::net {
+
+/**
+ * @brief Estimates the round trip and the server clock from Ping exchanges (NTP-style).
+ *
+ * Each exchange gives four timestamps: client send (t0), server receive (t1),
+ * server send (t2) and client receive (t3), each on its own side's millisecond
+ * clock. The round trip is (t3 - t0) - (t2 - t1) and the server clock offset
+ * ((t1 - t0) + (t2 - t3)) / 2, exact when both directions take as long.
+ * Queueing makes them lopsided, so the offset is taken from the sample with the
+ * lowest round trip among the last kWindow, the least queued one, as NTP's clock
+ * filter does. The round trip itself is smoothed like TCP's SRTT/RTTVAR.
+ *
+ * Timestamps are free-running 32-bit millisecond counters; differences are taken
+ * modulo 2^32, so wrap-around is harmless. Not thread-safe.
+ */
+class ClockSync {
+public:
+    static constexpr std::size_t kWindow = 8;
+
+    // Feeds one exchange. Returns false (and ignores it) if it is inconsistent.
+    bool on_exchange(std::uint32_t client_send_ms, std::uint32_t server_receive_ms,
+                     std::uint32_t server_send_ms, std::uint32_t client_receive_ms) {
+        const auto total = static_cast<std::int32_t>(client_receive_ms - client_send_ms);
+        const auto held = static_cast<std::int32_t>(server_send_ms - server_receive_ms);
+        const auto rtt = total - held;
+        if (total < 0 || held < 0 || rtt < 0) {
+            return false;
+        }
+        const double offset = (static_cast<double>(static_cast<std::int32_t>(server_receive_ms - client_send_ms)) +
+                               static_cast<double>(static_cast<std::int32_t>(server_send_ms - client_receive_ms))) /
+                              2.0;
+        add_rtt_sample(static_cast<double>(rtt));
+
+        samples_[next_sample_] = Sample{static_cast<double>(rtt), offset};
+        next_sample_ = (next_sample_ + 1) % kWindow;
+        sample_count_ = std::min(sample_count_ + 1, kWindow);
+        const auto best = std::min_element(samples_.begin(), samples_.begin() + static_cast<std::ptrdiff_t>(sample_count_),
+                                           [](const Sample& a, const Sample& b) { return a.rtt_ms < b.rtt_ms; });
+        offset_ms_ = best->offset_ms;
+        min_rtt_ms_ = best->rtt_ms;
+        synced_ = true;
+        return true;
+    }
+
+    // Round trip only, from a server that does not timestamp its replies.
+    void on_round_trip(double rtt_ms) { add_rtt_sample(std::max(0.0, rtt_ms)); }
+
+    bool has_rtt() const { return has_rtt_; }
+    bool synced() const { return synced_; }
+    double rtt_ms() const { return srtt_ms_; }         // Smoothed round trip
+    double jitter_ms() const { return rttvar_ms_; }    // Mean deviation of the round trip
+    double last_rtt_ms() const { return last_rtt_ms_; }
+    double min_rtt_ms() const { return min_rtt_ms_; }  // Of the sample the offset comes from
+    double offset_ms() const { return offset_ms_; }    // Server clock minus client clock
+
+    // A client clock reading translated to the server's clock.
+    std::uint32_t to_server_ms(std::uint32_t client_ms) const {
+        return client_ms + static_cast<std::uint32_t>(static_cast<std::int64_t>(std::llround(offset_ms_)));
+    }
+
+private:
+    struct Sample {
+        double rtt_ms{0.0};
+        double offset_ms{0.0};
+    };
+
+    void add_rtt_sample(double rtt) {
+        last_rtt_ms_ = rtt;
+        if (!has_rtt_) {
+            srtt_ms_ = rtt;
+            rttvar_ms_ = rtt / 2.0;
+            has_rtt_ = true;
+            return;
+        }
+        rttvar_ms_ = rttvar_ms_ * 0.75 + std::abs(srtt_ms_ - rtt) * 0.25;
+        srtt_ms_ = srtt_ms_ * 0.875 + rtt * 0.125;
+    }
+
+    std::array<Sample, kWindow> samples_{};
+    std::size_t next_sample_{0};
+    std::size_t sample_count_{0};
+    double srtt_ms_{0.0};
+    double rttvar_ms_{0.0};
+    double last_rtt_ms_{0.0};
+    double min_rtt_ms_{0.0};
+    double offset_ms_{0.0};
+    bool has_rtt_{false};
+    bool synced_{false};
+};
+
+}  // namespace engine::net
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include "engine/net/packet.hpp"
+
+namespace engine::net {
+
+/**
+ * @brief Small LZ77 codec in the LZ4 block style, for snapshot blobs.
+ *
+ * A stream is a list of sequences: a token byte (literal count in the high nibble,
+ * match length - 4 in the low one; 15 means more length bytes follow, 255 at a time),
+ * the literals, then a 2-byte little-endian offset back into the output. The last
+ * sequence has literals only. Matches are found through a hash of the next 4 bytes,
+ * one candidate per slot: fast rather than tight, which suits repeated sprite ids,
+ * maxima and zero fields laid out entity after entity.
+ */
+class LzCodec {
+public:
+    static constexpr std::size_t kMinMatch = 4;
+    static constexpr std::size_t kMaxOffset = 65535;
+
+    // Replaces `out` with the compressed form of `in`.
+    void compress(std::span<const std::uint8_t> in, std::vector<std::uint8_t>& out) {
+        out.clear();
+        table_.fill(0);
+        const std::size_t size = in.size();
+        std::size_t anchor = 0;
+        std::size_t pos = 0;
+        while (pos + kMinMatch <= size) {
+            const auto sequence = load32(in.data() + pos);
+            auto& slot = table_[hash(sequence)];
+            const std::size_t candidate = slot;  // Position + 1, 0 = empty
+            slot = static_cast<std::uint32_t>(pos + 1);
+            if (candidate == 0 || pos + 1 - candidate > kMaxOffset || load32(in.data() + candidate - 1) != sequence) {
+                ++pos;
+                continue;
+            }
+            const std::size_t match = candidate - 1;
+            std::size_t length = kMinMatch;
+            while (pos + length < size && in[match + length] == in[pos + length]) {
+                ++length;
+            }
+            write_sequence(out, in.subspan(anchor, pos - anchor), pos - match, length);
+            pos += length;
+            anchor = pos;
+        }
+        write_sequence(out, in.subspan(anchor), 0, 0);
+    }
+
+    // Replaces `out` with the decompressed stream, which must be exactly `size` bytes.
+    // Returns false on any malformed input; never reads or writes out of bounds.
+    static bool decompress(std::span<const std::uint8_t> in, std::vector<std::uint8_t>& out, std::size_t size) {
+        out.resize(size);
+        std::size_t written = 0;
+        std::size_t read = 0;
+        while (read < in.size()) {
+            const std::uint8_t token = in[read++];
+            std::size_t literals = token >> 4;
+            if (literals == 15 && !read_length(in, read, literals)) {
+                return false;
+            }
+            if (literals > in.size() - read || literals > size - written) {
+                return false;
+            }
+            std::memcpy(out.data() + written, in.data() + read, literals);
+            read += literals;
+            written += literals;
+            if (read == in.size()) {
+                break;  // Last sequence: literals only
+            }
+
+            if (in.size() - read < 2) {
+                return false;
+            }
+            const std::size_t offset = static_cast<std::size_t>(in[read]) | (static_cast<std::size_t>(in[read + 1]) << 8);
+            read += 2;
+            std::size_t length = token & 0x0F;
+            if (length == 15 && !read_length(in, read, length)) {
+                return false;
+            }
+            length += kMinMatch;
+            if (offset == 0 || offset > written || length > size - written) {
+                return false;
+            }
+            // Byte by byte: the source may overlap what this match writes (runs).
+            for (std::size_t i = 0; i < length; ++i, ++written) {
+                out[written] = out[written - offset];
+            }
+        }
+        return written == size;
+    }
+
+private:
+    static constexpr std::size_t kHashBits = 12;
+
+    static std::uint32_t load32(const std::uint8_t* data) {
+        std::uint32_t value = 0;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    static std::size_t hash(std::uint32_t sequence) { return (sequence * 2654435761u) >> (32 - kHashBits); }
+
+    static void write_length(std::vector<std::uint8_t>& out, std::size_t extra) {
+        for (; extra >= 255; extra -= 255) {
+            out.push_back(255);
+        }
+        out.push_back(static_cast<std::uint8_t>(extra));
+    }
+
+    static bool read_length(std::span<const std::uint8_t> in, std::size_t& read, std::size_t& length) {
+        std::uint8_t byte = 255;
+        while (byte == 255) {
+            if (read >= in.size()) {
+                return false;
+            }
+            byte = in[read++];
+            length += byte;
+        }
+        return true;
+    }
+
+    // `length` 0 writes the final, literals-only sequence.
+    static void write_sequence(std::vector<std::uint8_t>& out,
+                               std::span<const std::uint8_t> literals,
+                               std::size_t offset,
+                               std::size_t length) {
+        const std::size_t match = length == 0 ? 0 : length - kMinMatch;
+        out.push_back(static_cast<std::uint8_t>((std::min<std::size_t>(literals.size(), 15) << 4) |
+                                                std::min<std::size_t>(match, 15)));
+        if (literals.size() >= 15) {
+            write_length(out, literals.size() - 15);
+        }
+        out.insert(out.end(), literals.begin(), literals.end());
+        if (length == 0) {
+            return;
+        }
+        out.push_back(static_cast<std::uint8_t>(offset & 0xFF));
+        out.push_back(static_cast<std::uint8_t>(offset >> 8));
+        if (match >= 15) {
+            write_length(out, match - 15);
+        }
+    }
+
+    std::array<std::uint32_t, std::size_t{1} << kHashBits> table_{};
+};
+
+// Largest blob a compressed snapshot may expand to: what fragmentation can carry at most.
+inline constexpr std::size_t kMaxInflatedBlob = kMaxSnapshotFragments * kMaxFragmentData;
+
+/**
+ * @brief Server side of snapshot compression: one per room, used by the thread that
+ * sends the room's snapshots (the tick thread inline, the snapshot thread when pipelined).
+ *
+ * A compressed blob is [uncompressed size, LEB128][LzCodec stream] and the snapshot
+ * carries kSnapshotFlagCompressed. compress() declines (the caller sends the raw
+ * snapshot) when the blob is too small to gain anything or the result would not be
+ * kMinSavedBytes smaller. After kMissesBeforeBackoff refusals in a row it stops
+ * trying for kBackoffSnapshots snapshots, so incompressible traffic costs nothing.
+ */
+class SnapshotCompressor {
+public:
+    static constexpr std::size_t kMinBlobSize = 64;
+    static constexpr std::size_t kMinSavedBytes = 8;
+    static constexpr std::uint32_t kMissesBeforeBackoff = 4;
+    static constexpr std::uint32_t kBackoffSnapshots = 30;
+
+    struct Stats {
+        std::uint64_t attempts{0};
+        std::uint64_t compressed{0};
+        std::uint64_t raw_bytes{0};         // Blob bytes of compressed snapshots, before
+        std::uint64_t compressed_bytes{0};  // and after
+    };
+
+    // Fills `out` with the compressed copy of `msg` and returns true, or returns false.
+    bool compress(const SnapshotMessage& msg, SnapshotMessage& out) {
+        if (msg.blob.size() < kMinBlobSize || msg.blob.size() > kMaxInflatedBlob ||
+            (msg.flags & kSnapshotFlagCompressed) != 0) {
+            return false;
+        }
+        if (backoff_ > 0) {
+            --backoff_;
+            return false;
+        }
+        ++stats_.attempts;
+        out.blob.clear();
+        for (auto size = msg.blob.size(); ; size >>= 7) {
+            const auto low = static_cast<std::uint8_t>(size & 0x7F);
+            if (size < 0x80) {
+                out.blob.push_back(low);
+                break;
+            }
+            out.blob.push_back(static_cast<std::uint8_t>(low | 0x80));
+        }
+        const auto prefix = out.blob.size();
+        codec_.compress(msg.blob, stream_);
+        if (prefix + stream_.size() + kMinSavedBytes > msg.blob.size()) {
+            if (++misses_ >= kMissesBeforeBackoff) {
+                misses_ = 0;
+                backoff_ = kBackoffSnapshots;
+            }
+            return false;
+        }
+        misses_ = 0;
+        out.blob.insert(out.blob.end(), stream_.begin(), stream_.end());
+        out.tick = msg.tick;
+        out.flags = static_cast<std::uint8_t>(msg.flags | kSnapshotFlagCompressed);
+        out.paused = msg.paused;
+        out.last_processed_input = msg.last_processed_input;
+        ++stats_.compressed;
+        stats_.raw_bytes += msg.blob.size();
+        stats_.compressed_bytes += out.blob.size();
+        return true;
+    }
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    LzCodec codec_;
+    std::vector<std::uint8_t> stream_;
+    std::uint32_t misses_{0};
+    std::uint32_t backoff_{0};
+    Stats stats_{};
+};
+
+// Receiver side: if `view` is compressed, inflates its blob into `scratch`, points the
+// view at it and clears the flag. Uncompressed views pass through. False if corrupt.
+inline bool inflate_snapshot(SnapshotView& view, std::vector<std::uint8_t>& scratch) {
+    if ((view.flags & kSnapshotFlagCompressed) == 0) {
+        return true;
+    }
+    std::size_t size = 0;
+    std::size_t read = 0;
+    for (unsigned shift = 0;; shift += 7) {
+        if (read >= view.blob.size() || shift > 21) {
+            return false;
+        }
+        const auto byte = view.blob[read++];
+        size |= static_cast<std::size_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            break;
+        }
+    }
+    if (size > kMaxInflatedBlob || !LzCodec::decompress(view.blob.subspan(read), scratch, size)) {
+        return false;
+    }
+    view.blob = std::span<const std::uint8_t>(scratch.data(), scratch.size());
+    view.flags = static_cast<std::uint8_t>(view.flags & ~kSnapshotFlagCompressed);
+    return true;
+}
+
+}  // namespace engine::net
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "engine/net/packet.hpp"
 
@@ -22,6 +23,12 @@ public:
     // Poll the most recent snapshot from the server (non-blocking).
     virtual std::optional<SnapshotMessage> poll_snapshot() = 0;
 
+    // Hand a polled snapshot back once applied so its blob can be reused for a later one.
+    virtual void release_snapshot(SnapshotMessage&& /*snapshot*/) {}
+
+    // Poll the next one-shot game event, delivered reliably and in order (non-blocking).
+    virtual std::optional<std::vector<std::uint8_t>> poll_event() { return std::nullopt; }
+
     // Graceful shutdown of network resources.
     virtual void shutdown() = 0;
 
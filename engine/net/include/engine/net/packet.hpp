@@ -1,11 +1,17 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <optional>
 #include <span>
+#include <utility>
 #include <vector>
 
+#include "engine/net/packet_buffer.hpp"
 #include "engine/net/serializer.hpp"
 
 namespace engine::net {
@@ -19,7 +25,9 @@ enum class MessageType : std::uint8_t {
     Welcome = 1,
     Input = 2,
     Snapshot = 3,
-    Ping = 4
+    Ping = 4,
+    SnapshotFragment = 5,
+    Reliable = 6  // ReliableChannel payload (reliable_channel.hpp)
 };
 
 struct PacketHeader {
@@ -34,19 +42,39 @@ struct Packet {
     std::vector<std::uint8_t> payload;
 };
 
+// One whole datagram, reused for every packet a thread sends; see FixedBuffer.
+using PacketBuffer = FixedBuffer<kMaxPacketSize>;
+
+// A received datagram, parsed in place: `payload` (and `bytes`, the whole datagram)
+// point into the receive buffer and are only valid until it is reused.
+struct PacketView {
+    PacketHeader header;
+    std::span<const std::uint8_t> payload;
+    std::span<const std::uint8_t> bytes;
+};
+
+// Clears `out` and writes `header`; the append_*_payload encoders then add the
+// payload behind it, so a datagram is built in one buffer without copies.
+template <typename Buffer>
+void begin_packet(Buffer& out, const PacketHeader& header) {
+    out.clear();
+    write_value(out, header.magic);
+    write_value(out, header.version);
+    write_value(out, header.type);
+    write_value(out, header.sequence);
+}
+
 inline std::vector<std::uint8_t> serialize(const Packet& packet) {
     std::vector<std::uint8_t> buffer;
     buffer.reserve(sizeof(PacketHeader) + packet.payload.size());
-    write_value(buffer, packet.header.magic);
-    write_value(buffer, packet.header.version);
-    write_value(buffer, packet.header.type);
-    write_value(buffer, packet.header.sequence);
+    begin_packet(buffer, packet.header);
     write_bytes(buffer, packet.payload);
     return buffer;
 }
 
-inline std::optional<Packet> deserialize(std::span<const std::uint8_t> buffer) {
-    Packet packet;
+inline std::optional<PacketView> parse_packet(std::span<const std::uint8_t> buffer) {
+    PacketView packet;
+    packet.bytes = buffer;
     if (buffer.size() < sizeof(PacketHeader)) {
         return std::nullopt;
     }
@@ -59,25 +87,72 @@ inline std::optional<Packet> deserialize(std::span<const std::uint8_t> buffer) {
     if (packet.header.magic != kPacketMagic || packet.header.version != kProtocolVersion) {
         return std::nullopt;
     }
-    packet.payload.assign(buffer.begin(), buffer.end());
+    packet.payload = buffer;
     return packet;
 }
 
+// Owning variant of parse_packet, for callers that keep the packet around.
+inline std::optional<Packet> deserialize(std::span<const std::uint8_t> buffer) {
+    auto view = parse_packet(buffer);
+    if (!view) {
+        return std::nullopt;
+    }
+    return Packet{view->header, std::vector<std::uint8_t>(view->payload.begin(), view->payload.end())};
+}
+
 struct HelloMessage {
     char player_name[16]{};
     std::uint16_t start_level{1};  // Level to start at (1-5, default 1)
     std::uint8_t difficulty{1};    // Difficulty: 0=Easy, 1=Normal, 2=Hard, 3=Hardcore
+    std::uint16_t room_id{0};      // Match to join on a multi-room server (absent = room 0)
+    std::uint8_t features{0};      // kFeature* bits the client supports (absent = none)
 };
 
 struct WelcomeMessage {
     std::uint16_t player_id{0};
     std::uint16_t tick_rate{60};
+    std::uint8_t features{0};  // kFeature* bits the server will use with this client (absent = none)
+};
+
+// Optional protocol features, offered in the Hello and accepted in the Welcome.
+inline constexpr std::uint8_t kFeatureSnapshotCompression = 1 << 0;  // See compression.hpp
+
+// Earlier inputs each Input datagram repeats, so a lost one is recovered from the next.
+inline constexpr std::size_t kInputRedundancy = 3;
+
+// One input sent before the newest one on the same datagram.
+struct PreviousInput {
+    std::uint32_t sequence_back{0};  // How many sequence numbers before the datagram's own
+    std::uint16_t input_mask{0};
+    std::uint32_t client_time_ms{0};
 };
 
 struct InputMessage {
     std::uint16_t player_id{0};
     std::uint16_t input_mask{0};
     std::uint32_t client_time_ms{0};
+    std::uint32_t ack_tick{0};  // Newest snapshot tick the client has decoded (0 = none)
+    std::array<PreviousInput, kInputRedundancy> previous{};  // Newest first
+    std::uint8_t previous_count{0};
+};
+
+// Client heartbeat. The server echoes it back as a Pong; the rest reports the link back for
+// the server's send rate control.
+struct PingMessage {
+    std::uint32_t client_time_ms{0};
+    std::uint16_t rtt_ms{0};    // Client's latest RTT measurement (0 = none yet)
+    std::uint16_t received{0};  // Server datagrams received since the previous ping
+    std::uint16_t expected{0};  // Server datagrams sent meanwhile, from the sequence numbers
+};
+
+// Server reply to a Ping: the Ping datagram as received (same type and sequence) with the
+// server clock appended on arrival and departure, so the client measures its round trip
+// net of server time and the offset between the two clocks (see ClockSync).
+struct PongMessage {
+    PingMessage ping;
+    std::uint32_t server_receive_ms{0};
+    std::uint32_t server_send_ms{0};
+    bool has_server_time{false};  // False for servers that echo the Ping unchanged
 };
 
 struct SnapshotMessage {
@@ -92,6 +167,8 @@ inline void encode_hello_payload(const HelloMessage& msg, std::vector<std::uint8
     payload.assign(std::begin(msg.player_name), std::end(msg.player_name));
     write_value(payload, msg.start_level);
     write_value(payload, msg.difficulty);
+    write_value(payload, msg.room_id);
+    write_value(payload, msg.features);
 }
 
 inline HelloMessage decode_hello_payload(std::span<const std::uint8_t> payload) {
@@ -105,6 +182,12 @@ inline HelloMessage decode_hello_payload(std::span<const std::uint8_t> payload)
         if (remaining.size() >= 1) {
             read_value(remaining, msg.difficulty);
         }
+        if (remaining.size() >= 2) {
+            read_value(remaining, msg.room_id);
+        }
+        if (remaining.size() >= 1) {
+            read_value(remaining, msg.features);
+        }
     } else {
         const auto len = std::min<std::size_t>(payload.size(), sizeof(msg.player_name));
         std::memcpy(msg.player_name, payload.data(), len);
@@ -116,6 +199,7 @@ inline void encode_welcome_payload(const WelcomeMessage& msg, std::vector<std::u
     payload.clear();
     write_value(payload, msg.player_id);
     write_value(payload, msg.tick_rate);
+    write_value(payload, msg.features);
 }
 
 inline std::optional<WelcomeMessage> decode_welcome_payload(std::span<const std::uint8_t> payload) {
@@ -123,14 +207,50 @@ inline std::optional<WelcomeMessage> decode_welcome_payload(std::span<const std:
     if (!read_value(payload, msg.player_id) || !read_value(payload, msg.tick_rate)) {
         return std::nullopt;
     }
+    read_value(payload, msg.features);
     return msg;
 }
 
+// The previous inputs follow the ack as a count and, per input, the sequence gap, mask XOR and
+// time gap to the next newer input: 5 bytes each. An input too far back to fit ends the list.
+template <typename Buffer>
+void append_input_payload(const InputMessage& msg, Buffer& out) {
+    write_value(out, msg.player_id);
+    write_value(out, msg.input_mask);
+    write_value(out, msg.client_time_ms);
+    write_value(out, msg.ack_tick);
+
+    std::uint8_t count = 0;
+    std::uint32_t back = 0;
+    std::uint32_t time = msg.client_time_ms;
+    const auto available = std::min<std::size_t>(msg.previous_count, kInputRedundancy);
+    for (; count < available; ++count) {
+        const auto& previous = msg.previous[count];
+        if (previous.sequence_back <= back || previous.sequence_back - back > 0xFF ||
+            time - previous.client_time_ms > 0xFFFF) {
+            break;
+        }
+        back = previous.sequence_back;
+        time = previous.client_time_ms;
+    }
+    write_value(out, count);
+    std::uint16_t mask = msg.input_mask;
+    back = 0;
+    time = msg.client_time_ms;
+    for (std::uint8_t i = 0; i < count; ++i) {
+        const auto& previous = msg.previous[i];
+        write_value(out, static_cast<std::uint8_t>(previous.sequence_back - back));
+        write_value(out, static_cast<std::uint16_t>(mask ^ previous.input_mask));
+        write_value(out, static_cast<std::uint16_t>(time - previous.client_time_ms));
+        back = previous.sequence_back;
+        mask = previous.input_mask;
+        time = previous.client_time_ms;
+    }
+}
+
 inline void encode_input_payload(const InputMessage& msg, std::vector<std::uint8_t>& payload) {
     payload.clear();
-    write_value(payload, msg.player_id);
-    write_value(payload, msg.input_mask);
-    write_value(payload, msg.client_time_ms);
+    append_input_payload(msg, payload);
 }
 
 inline std::optional<InputMessage> decode_input_payload(std::span<const std::uint8_t> payload) {
@@ -139,9 +259,125 @@ inline std::optional<InputMessage> decode_input_payload(std::span<const std::uin
         !read_value(payload, msg.client_time_ms)) {
         return std::nullopt;
     }
+    read_value(payload, msg.ack_tick);  // Absent in older clients
+
+    std::uint8_t count = 0;
+    read_value(payload, count);  // Absent in clients without redundancy
+    std::uint32_t back = 0;
+    std::uint16_t mask = msg.input_mask;
+    std::uint32_t time = msg.client_time_ms;
+    for (std::uint8_t i = 0; i < std::min<std::size_t>(count, kInputRedundancy); ++i) {
+        std::uint8_t sequence_gap = 0;
+        std::uint16_t mask_xor = 0;
+        std::uint16_t time_gap = 0;
+        if (!read_value(payload, sequence_gap) || !read_value(payload, mask_xor) || !read_value(payload, time_gap) ||
+            sequence_gap == 0) {
+            break;
+        }
+        back += sequence_gap;
+        mask = static_cast<std::uint16_t>(mask ^ mask_xor);
+        time -= time_gap;
+        msg.previous[i] = PreviousInput{back, mask, time};
+        msg.previous_count = static_cast<std::uint8_t>(i + 1);
+    }
+    return msg;
+}
+
+// Calls `apply(sequence, input_mask, client_time_ms)` for each input of a datagram with
+// sequence `sequence` that is newer than `newest`, oldest first, and advances `newest`.
+// Repeated and reordered datagrams thus deliver every input exactly once.
+template <typename Apply>
+void for_each_new_input(const InputMessage& msg, std::uint32_t sequence, std::uint32_t& newest, Apply&& apply) {
+    for (std::size_t i = msg.previous_count; i-- > 0;) {
+        const auto& previous = msg.previous[i];
+        if (previous.sequence_back < sequence && sequence - previous.sequence_back > newest) {
+            apply(sequence - previous.sequence_back, previous.input_mask, previous.client_time_ms);
+            newest = sequence - previous.sequence_back;
+        }
+    }
+    if (sequence > newest) {
+        apply(sequence, msg.input_mask, msg.client_time_ms);
+        newest = sequence;
+    }
+}
+
+template <typename Buffer>
+void append_ping_payload(const PingMessage& msg, Buffer& out) {
+    write_value(out, msg.client_time_ms);
+    write_value(out, msg.rtt_ms);
+    write_value(out, msg.received);
+    write_value(out, msg.expected);
+}
+
+// Older clients send Pings without a payload: nullopt, the ping still counts as a heartbeat.
+inline std::optional<PingMessage> decode_ping_payload(std::span<const std::uint8_t> payload) {
+    PingMessage msg{};
+    if (!read_value(payload, msg.client_time_ms) || !read_value(payload, msg.rtt_ms) ||
+        !read_value(payload, msg.received) || !read_value(payload, msg.expected)) {
+        return std::nullopt;
+    }
     return msg;
 }
 
+template <typename Buffer>
+void append_pong_payload(const PongMessage& msg, Buffer& out) {
+    append_ping_payload(msg.ping, out);
+    write_value(out, msg.server_receive_ms);
+    write_value(out, msg.server_send_ms);
+}
+
+inline std::optional<PongMessage> decode_pong_payload(std::span<const std::uint8_t> payload) {
+    PongMessage msg{};
+    if (!read_value(payload, msg.ping.client_time_ms) || !read_value(payload, msg.ping.rtt_ms) ||
+        !read_value(payload, msg.ping.received) || !read_value(payload, msg.ping.expected)) {
+        return std::nullopt;
+    }
+    msg.has_server_time = read_value(payload, msg.server_receive_ms) && read_value(payload, msg.server_send_ms);
+    return msg;
+}
+
+// A Snapshot datagram is [PacketHeader][tick, flags, paused, last_processed_input][blob].
+// Everything before the blob is the "prefix": it is the only part that differs between
+// recipients (header sequence and last_processed_input), so broadcasts encode it once,
+// patch the two per-client fields and send it gathered with the shared blob.
+inline constexpr std::size_t kPacketHeaderSize = 8;
+inline constexpr std::size_t kPacketSequenceOffset = 4;
+inline constexpr std::size_t kSnapshotFixedSize = 4 + 1 + 1 + 4;
+inline constexpr std::size_t kSnapshotPrefixSize = kPacketHeaderSize + kSnapshotFixedSize;
+inline constexpr std::size_t kSnapshotLastInputOffset = kPacketHeaderSize + 4 + 1 + 1;
+
+// Snapshot flag owned by the transport (the game's flags use the low bits): the blob is
+// compressed and must go through inflate_snapshot() before it is decoded.
+inline constexpr std::uint8_t kSnapshotFlagCompressed = 1 << 7;
+
+static_assert(sizeof(PacketHeader) == kPacketHeaderSize, "PacketHeader must stay 8 bytes on the wire");
+
+using SnapshotPrefix = std::array<std::uint8_t, kSnapshotPrefixSize>;
+
+inline void encode_snapshot_prefix(const PacketHeader& header, const SnapshotMessage& msg, SnapshotPrefix& out) {
+    auto* cursor = out.data();
+    auto put = [&cursor](const auto& value) {
+        std::memcpy(cursor, &value, sizeof(value));
+        cursor += sizeof(value);
+    };
+    put(header.magic);
+    put(header.version);
+    put(header.type);
+    put(header.sequence);
+    put(msg.tick);
+    put(msg.flags);
+    put(msg.paused);
+    put(msg.last_processed_input);
+}
+
+inline void patch_packet_sequence(std::span<std::uint8_t> packet, std::uint32_t sequence) {
+    std::memcpy(packet.data() + kPacketSequenceOffset, &sequence, sizeof(sequence));
+}
+
+inline void patch_snapshot_last_input(std::span<std::uint8_t> packet, std::uint32_t last_processed_input) {
+    std::memcpy(packet.data() + kSnapshotLastInputOffset, &last_processed_input, sizeof(last_processed_input));
+}
+
 inline void encode_snapshot_payload(const SnapshotMessage& msg, std::vector<std::uint8_t>& payload) {
     payload.clear();
     write_value(payload, msg.tick);
@@ -151,18 +387,292 @@ inline void encode_snapshot_payload(const SnapshotMessage& msg, std::vector<std:
     payload.insert(payload.end(), msg.blob.begin(), msg.blob.end());
 }
 
+// A Snapshot payload parsed in place: `blob` points into the received datagram.
+struct SnapshotView {
+    std::uint32_t tick{0};
+    std::uint8_t flags{0};
+    bool paused{false};
+    std::uint32_t last_processed_input{0};
+    std::span<const std::uint8_t> blob;
+};
+
+inline std::optional<SnapshotView> decode_snapshot_view(std::span<const std::uint8_t> payload) {
+    SnapshotView view{};
+    if (!read_value(payload, view.tick) ||
+        !read_value(payload, view.flags) ||
+        !read_value(payload, view.paused) ||
+        !read_value(payload, view.last_processed_input)) {
+        return std::nullopt;
+    }
+    view.blob = payload;
+    return view;
+}
 
 inline std::optional<SnapshotMessage> decode_snapshot_payload(std::span<const std::uint8_t> payload) {
+    auto view = decode_snapshot_view(payload);
+    if (!view) {
+        return std::nullopt;
+    }
     SnapshotMessage msg{};
-    if (!read_value(payload, msg.tick) ||
-        !read_value(payload, msg.flags) ||
-        !read_value(payload, msg.paused) ||
-        !read_value(payload, msg.last_processed_input)) {
+    msg.tick = view->tick;
+    msg.flags = view->flags;
+    msg.paused = view->paused;
+    msg.last_processed_input = view->last_processed_input;
+    msg.blob.assign(view->blob.begin(), view->blob.end());
+    return msg;
+}
+
+// =============================================================================
+// Snapshot fragmentation
+// =============================================================================
+// A snapshot whose datagram would exceed kMaxPacketSize is sent as several
+// SnapshotFragment datagrams: [PacketHeader][FragmentHeader][data]. Concatenating
+// the data of every fragment, in index order, yields the regular Snapshot payload
+// (fixed fields + blob). Fragment 0 therefore carries the per-client fixed fields.
+// Receivers rebuild it with SnapshotReassembler; a snapshot missing any fragment
+// is dropped as a whole.
+
+inline constexpr std::size_t kFragmentHeaderSize = 4 + 1 + 1;
+inline constexpr std::size_t kMaxFragmentData = kMaxPacketSize - kPacketHeaderSize - kFragmentHeaderSize;
+inline constexpr std::size_t kMaxSnapshotFragments = 255;
+
+struct FragmentHeader {
+    std::uint32_t message_id{0};  // Snapshot tick
+    std::uint8_t index{0};
+    std::uint8_t count{0};
+};
+
+struct SnapshotFragment {
+    FragmentHeader header;
+    std::span<const std::uint8_t> data;
+};
+
+inline std::optional<SnapshotFragment> decode_fragment_payload(std::span<const std::uint8_t> payload) {
+    SnapshotFragment fragment{};
+    if (!read_value(payload, fragment.header.message_id) ||
+        !read_value(payload, fragment.header.index) ||
+        !read_value(payload, fragment.header.count)) {
+        return std::nullopt;
+    }
+    if (fragment.header.count == 0 || fragment.header.index >= fragment.header.count ||
+        payload.size() > kMaxFragmentData) {
         return std::nullopt;
     }
+    fragment.data = payload;
+    return fragment;
+}
 
-    msg.blob.assign(payload.begin(), payload.end());
-    return msg;
+// Datagrams needed to carry a snapshot with a blob of `blob_size` bytes (1 = not fragmented).
+inline std::size_t snapshot_datagram_count(std::size_t blob_size) {
+    const auto payload_size = kSnapshotFixedSize + blob_size;
+    if (kPacketHeaderSize + payload_size <= kMaxPacketSize) {
+        return 1;
+    }
+    return (payload_size + kMaxFragmentData - 1) / kMaxFragmentData;
+}
+
+// Per-recipient leading bytes of one snapshot datagram. On the wire it is followed by
+// snapshot_blob_slice() of the shared blob, so broadcasts only patch these few bytes.
+struct SnapshotHead {
+    std::array<std::uint8_t, kPacketHeaderSize + kFragmentHeaderSize + kSnapshotFixedSize> bytes{};
+    std::size_t size{0};
+    std::size_t last_input_offset{0};  // 0 when this datagram does not carry last_processed_input
+};
+
+inline SnapshotHead encode_snapshot_head(const SnapshotMessage& msg, std::size_t index, std::size_t count) {
+    SnapshotHead head;
+    PacketHeader header;
+    if (count <= 1) {
+        header.type = static_cast<std::uint8_t>(MessageType::Snapshot);
+        SnapshotPrefix prefix{};
+        encode_snapshot_prefix(header, msg, prefix);
+        std::copy(prefix.begin(), prefix.end(), head.bytes.begin());
+        head.size = prefix.size();
+        head.last_input_offset = kSnapshotLastInputOffset;
+        return head;
+    }
+
+    header.type = static_cast<std::uint8_t>(MessageType::SnapshotFragment);
+    const FragmentHeader fragment{msg.tick, static_cast<std::uint8_t>(index), static_cast<std::uint8_t>(count)};
+    auto* cursor = head.bytes.data();
+    auto put = [&cursor](const auto& value) {
+        std::memcpy(cursor, &value, sizeof(value));
+        cursor += sizeof(value);
+    };
+    put(header.magic);
+    put(header.version);
+    put(header.type);
+    put(header.sequence);
+    put(fragment.message_id);
+    put(fragment.index);
+    put(fragment.count);
+    if (index == 0) {
+        put(msg.tick);
+        put(msg.flags);
+        put(msg.paused);
+        head.last_input_offset = static_cast<std::size_t>(cursor - head.bytes.data());
+        put(msg.last_processed_input);
+    }
+    head.size = static_cast<std::size_t>(cursor - head.bytes.data());
+    return head;
 }
 
+inline void patch_snapshot_head(SnapshotHead& head, std::uint32_t sequence, std::uint32_t last_processed_input) {
+    std::memcpy(head.bytes.data() + kPacketSequenceOffset, &sequence, sizeof(sequence));
+    if (head.last_input_offset != 0) {
+        std::memcpy(head.bytes.data() + head.last_input_offset, &last_processed_input, sizeof(last_processed_input));
+    }
+}
+
+// Part of the blob carried by datagram `index` of `count`.
+inline std::span<const std::uint8_t> snapshot_blob_slice(std::span<const std::uint8_t> blob,
+                                                         std::size_t index,
+                                                         std::size_t count) {
+    if (count <= 1) {
+        return blob;
+    }
+    // Offsets in the logical payload (fixed fields + blob), shifted into blob coordinates.
+    const auto payload_begin = index * kMaxFragmentData;
+    const auto payload_end = std::min(payload_begin + kMaxFragmentData, kSnapshotFixedSize + blob.size());
+    const auto begin = payload_begin == 0 ? 0 : payload_begin - kSnapshotFixedSize;
+    const auto end = payload_end - kSnapshotFixedSize;
+    return blob.subspan(begin, end - begin);
+}
+
+/**
+ * @brief Rebuilds fragmented snapshots on the receiving side.
+ *
+ * Keeps at most kMaxPending snapshots in flight. A snapshot is abandoned when it
+ * is older than `timeout`, when a newer snapshot completes first, or when too many
+ * newer snapshots are pending; partial snapshots are never delivered.
+ *
+ * Message ids (ticks) are compared modulo 2^32, so numbering may wrap. An id more
+ * than kRestartDistance behind the last delivered one is no late fragment but a
+ * sender that started counting again (a restarted server): everything is reset.
+ *
+ * The pending slots and the delivered payload keep their buffers, so once they have
+ * grown to the snapshot size, reassembly no longer allocates.
+ */
+class SnapshotReassembler {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::size_t kMaxPending = 4;
+    static constexpr std::uint32_t kRestartDistance = 1024;
+
+    explicit SnapshotReassembler(std::chrono::milliseconds timeout = std::chrono::milliseconds(250))
+        : timeout_(timeout) {}
+
+    // Returns the complete Snapshot payload once the last missing fragment arrives. It
+    // points into the reassembler and stays valid until the next add().
+    std::optional<std::span<const std::uint8_t>> add(const SnapshotFragment& fragment, Clock::time_point now) {
+        const auto& header = fragment.header;
+        const bool is_last = header.index + 1 == header.count;
+        if (!is_last && fragment.data.size() != kMaxFragmentData) {
+            return std::nullopt;
+        }
+        if (last_completed_ && !newer(header.message_id, *last_completed_)) {
+            if (*last_completed_ - header.message_id < kRestartDistance) {
+                return std::nullopt;  // Stale or duplicate of a delivered snapshot
+            }
+            last_completed_.reset();
+            dropped_ += pending();
+            for (auto& slot : slots_) {
+                slot.active = false;
+            }
+        }
+
+        expire(now);
+
+        auto it = std::find_if(slots_.begin(), slots_.end(),
+                               [&](const Pending& p) { return p.active && p.message_id == header.message_id; });
+        if (it == slots_.end()) {
+            it = std::find_if(slots_.begin(), slots_.end(), [](const Pending& p) { return !p.active; });
+            if (it == slots_.end()) {
+                it = std::min_element(slots_.begin(), slots_.end(),
+                                      [](const Pending& a, const Pending& b) { return newer(b.message_id, a.message_id); });
+                if (newer(it->message_id, header.message_id)) {
+                    return std::nullopt;  // Older than everything we are still waiting for
+                }
+                ++dropped_;
+            }
+            it->active = true;
+            it->message_id = header.message_id;
+            it->count = header.count;
+            it->have.reset();
+            it->bytes.clear();
+            it->size = 0;
+            it->first_seen = now;
+        }
+
+        auto& pending = *it;
+        if (pending.count != header.count || pending.have.test(header.index)) {
+            return std::nullopt;
+        }
+        const auto offset = static_cast<std::size_t>(header.index) * kMaxFragmentData;
+        if (pending.bytes.size() < offset + fragment.data.size()) {
+            pending.bytes.resize(offset + fragment.data.size());
+        }
+        std::copy(fragment.data.begin(), fragment.data.end(), pending.bytes.begin() + static_cast<std::ptrdiff_t>(offset));
+        pending.have.set(header.index);
+        if (is_last) {
+            pending.size = offset + fragment.data.size();
+        }
+        if (pending.have.count() != pending.count) {
+            return std::nullopt;
+        }
+
+        // Swap buffers with the previous payload rather than copy or free either.
+        std::swap(delivered_, pending.bytes);
+        delivered_.resize(pending.size);
+        pending.active = false;
+        const auto completed = pending.message_id;
+        last_completed_ = completed;
+        // Anything older than the snapshot we just delivered is useless now.
+        for (auto& slot : slots_) {
+            if (slot.active && !newer(slot.message_id, completed)) {
+                slot.active = false;
+                ++dropped_;
+            }
+        }
+        return std::span<const std::uint8_t>(delivered_);
+    }
+
+    std::size_t pending() const {
+        return static_cast<std::size_t>(
+            std::count_if(slots_.begin(), slots_.end(), [](const Pending& p) { return p.active; }));
+    }
+
+    // Incomplete snapshots abandoned (timeout, superseded or evicted).
+    std::uint64_t dropped() const { return dropped_; }
+
+private:
+    struct Pending {
+        bool active{false};
+        std::uint32_t message_id{0};
+        std::uint8_t count{0};
+        std::bitset<kMaxSnapshotFragments + 1> have;
+        std::vector<std::uint8_t> bytes;
+        std::size_t size{0};
+        Clock::time_point first_seen;
+    };
+
+    // True if id `a` comes after `b`, allowing for wraparound.
+    static bool newer(std::uint32_t a, std::uint32_t b) { return static_cast<std::int32_t>(a - b) > 0; }
+
+    void expire(Clock::time_point now) {
+        for (auto& slot : slots_) {
+            if (slot.active && now - slot.first_seen > timeout_) {
+                slot.active = false;
+                ++dropped_;
+            }
+        }
+    }
+
+    std::chrono::milliseconds timeout_;
+    std::array<Pending, kMaxPending> slots_{};
+    std::vector<std::uint8_t> delivered_;
+    std::optional<std::uint32_t> last_completed_;
+    std::uint64_t dropped_{0};
+};
+
 }  // namespace engine::net
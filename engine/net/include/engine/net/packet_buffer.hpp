@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace engine::net {
+
+/**
+ * @brief Byte buffer with fixed, inline storage for building one datagram.
+ *
+ * Encoders write into it exactly like into a std::vector<std::uint8_t>, but it
+ * never touches the heap: a write that does not fit is dropped and marks the
+ * buffer as overflowed, which senders check before handing bytes() to the socket.
+ * Senders keep one per thread (or a vector of them per batch) and clear() it
+ * for every packet.
+ */
+template <std::size_t Capacity>
+class FixedBuffer {
+public:
+    static constexpr std::size_t kCapacity = Capacity;
+
+    std::uint8_t* data() { return bytes_.data(); }
+    const std::uint8_t* data() const { return bytes_.data(); }
+    std::size_t size() const { return size_; }
+    static constexpr std::size_t capacity() { return Capacity; }
+    bool empty() const { return size_ == 0; }
+
+    // True once a write was dropped for lack of room; cleared by clear().
+    bool overflowed() const { return overflowed_; }
+
+    void clear() {
+        size_ = 0;
+        overflowed_ = false;
+    }
+
+    void push_back(std::uint8_t byte) {
+        if (size_ == Capacity) {
+            overflowed_ = true;
+            return;
+        }
+        bytes_[size_++] = byte;
+    }
+
+    // Appends `bytes` whole, or nothing at all if they do not fit.
+    void append(std::span<const std::uint8_t> bytes) {
+        if (bytes.size() > Capacity - size_) {
+            overflowed_ = true;
+            return;
+        }
+        if (!bytes.empty()) {
+            std::memcpy(bytes_.data() + size_, bytes.data(), bytes.size());
+        }
+        size_ += bytes.size();
+    }
+
+    std::uint8_t& operator[](std::size_t index) { return bytes_[index]; }
+    std::uint8_t operator[](std::size_t index) const { return bytes_[index]; }
+
+    std::span<const std::uint8_t> bytes() const { return {bytes_.data(), size_}; }
+
+private:
+    std::array<std::uint8_t, Capacity> bytes_{};
+    std::size_t size_{0};
+    bool overflowed_{false};
+};
+
+}  // namespace engine::net
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "engine/net/serializer.hpp"
+
+namespace engine::net {
+
+// True if sequence `a` comes after `b`, allowing for 16-bit wraparound.
+inline bool sequence_newer(std::uint16_t a, std::uint16_t b) {
+    return a != b && static_cast<std::uint16_t>(a - b) < 0x8000;
+}
+
+/**
+ * @brief Reliable, ordered delivery of small messages over unreliable datagrams.
+ *
+ * Every message gets a 16-bit sequence number and stays queued until the peer
+ * acknowledges it; unacknowledged messages are resent once `resend_after` has
+ * elapsed. Acks are cumulative (every sequence before `ack_next` arrived) plus a
+ * 32-bit field for messages received past a gap, so one lost datagram does not
+ * force the whole window to be resent. The receiver buffers out-of-order messages
+ * and hands them out exactly once, in order.
+ *
+ * Packet payload (little-endian):
+ *   u16 ack_next   next sequence the receiver is missing
+ *   u32 ack_bits   bit i: sequence ack_next + 1 + i was received
+ *   u8  count      messages that follow
+ *   count x { u16 sequence, u8 size, size bytes }
+ *
+ * Not thread-safe: callers serialize access per channel.
+ */
+class ReliableChannel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t kMaxMessageSize = 255;
+    static constexpr std::uint16_t kWindowSize = 32;  // Sequences in flight; matches ack_bits
+    static constexpr std::size_t kMaxQueued = 1024;   // Messages waiting for an ack or a window slot
+    static constexpr std::size_t kHeaderSize = 2 + 4 + 1;
+    static constexpr std::size_t kMessageHeaderSize = 2 + 1;
+
+    explicit ReliableChannel(Clock::duration resend_after = std::chrono::milliseconds(100))
+        : resend_after_(resend_after) {}
+
+    // Queues `message` for delivery. False if it is too large or the queue is full.
+    bool send(std::span<const std::uint8_t> message) {
+        if (message.size() > kMaxMessageSize || outgoing_.size() >= kMaxQueued) {
+            return false;
+        }
+        outgoing_.push_back(Outgoing{next_sequence_++, std::vector<std::uint8_t>(message.begin(), message.end()), {}, false});
+        return true;
+    }
+
+    // Writes the acks plus every message that is new or due for a resend, up to
+    // `max_size` bytes. Returns false (and leaves `payload` empty) when there is
+    // nothing to send: no due message and no ack owed.
+    bool write_packet(std::vector<std::uint8_t>& payload, Clock::time_point now, std::size_t max_size) {
+        payload.clear();
+        if (max_size < kHeaderSize) {
+            return false;
+        }
+        write_value(payload, receive_next_);
+        write_value(payload, received_bits());
+        payload.push_back(0);
+
+        std::uint8_t count = 0;
+        for (auto& message : outgoing_) {
+            if (static_cast<std::uint16_t>(message.sequence - outgoing_.front().sequence) >= kWindowSize) {
+                break;  // The peer could not buffer it yet
+            }
+            if (message.sent && now - message.sent_at < resend_after_) {
+                continue;
+            }
+            if (payload.size() + kMessageHeaderSize + message.data.size() > max_size || count == 255) {
+                break;
+            }
+            write_value(payload, message.sequence);
+            payload.push_back(static_cast<std::uint8_t>(message.data.size()));
+            payload.insert(payload.end(), message.data.begin(), message.data.end());
+            message.sent = true;
+            message.sent_at = now;
+            ++count;
+        }
+        payload[kHeaderSize - 1] = count;
+
+        if (count == 0 && !ack_owed_) {
+            payload.clear();
+            return false;
+        }
+        ack_owed_ = false;
+        return true;
+    }
+
+    // Applies the peer's acks and buffers its messages. False if the payload is malformed.
+    bool read_packet(std::span<const std::uint8_t> payload) {
+        std::uint16_t ack_next = 0;
+        std::uint32_t ack_bits = 0;
+        std::uint8_t count = 0;
+        if (!read_value(payload, ack_next) || !read_value(payload, ack_bits) || !read_value(payload, count)) {
+            return false;
+        }
+        apply_acks(ack_next, ack_bits);
+
+        for (std::uint8_t i = 0; i < count; ++i) {
+            std::uint16_t sequence = 0;
+            std::uint8_t size = 0;
+            if (!read_value(payload, sequence) || !read_value(payload, size) || payload.size() < size) {
+                return false;
+            }
+            const auto data = payload.first(size);
+            payload = payload.subspan(size);
+            ack_owed_ = true;  // Even for duplicates: our previous ack may have been lost
+
+            const auto offset = static_cast<std::uint16_t>(sequence - receive_next_);
+            if (offset >= kWindowSize) {
+                continue;  // Already delivered, or too far ahead
+            }
+            auto& slot = received_[sequence % kWindowSize];
+            if (!slot) {
+                slot.emplace(data.begin(), data.end());
+            }
+        }
+        // Hand out whatever is now contiguous.
+        while (auto& slot = received_[receive_next_ % kWindowSize]) {
+            delivered_.push_back(std::move(*slot));
+            slot.reset();
+            ++receive_next_;
+        }
+        return true;
+    }
+
+    // Next message received in order, each exactly once.
+    std::optional<std::vector<std::uint8_t>> receive() {
+        if (delivered_.empty()) {
+            return std::nullopt;
+        }
+        auto message = std::move(delivered_.front());
+        delivered_.pop_front();
+        return message;
+    }
+
+    // Messages sent or queued but not acknowledged yet.
+    std::size_t unacked() const { return outgoing_.size(); }
+    bool ack_owed() const { return ack_owed_; }
+
+private:
+    struct Outgoing {
+        std::uint16_t sequence;
+        std::vector<std::uint8_t> data;
+        Clock::time_point sent_at;
+        bool sent;
+    };
+
+    std::uint32_t received_bits() const {
+        // Only offsets 1..kWindowSize-1 can be buffered.
+        std::uint32_t bits = 0;
+        for (std::uint16_t i = 0; i + 1 < kWindowSize; ++i) {
+            const auto sequence = static_cast<std::uint16_t>(receive_next_ + 1 + i);
+            if (received_[sequence % kWindowSize]) {
+                bits |= 1u << i;
+            }
+        }
+        return bits;
+    }
+
+    void apply_acks(std::uint16_t ack_next, std::uint32_t ack_bits) {
+        std::erase_if(outgoing_, [&](const Outgoing& message) {
+            if (sequence_newer(ack_next, message.sequence)) {
+                return true;
+            }
+            const auto offset = static_cast<std::uint16_t>(message.sequence - ack_next);
+            return offset >= 1 && offset <= 32 && (ack_bits & (1u << (offset - 1))) != 0;
+        });
+    }
+
+    Clock::duration resend_after_;
+    std::uint16_t next_sequence_{0};
+    std::deque<Outgoing> outgoing_;  // Sorted by sequence
+    std::uint16_t receive_next_{0};
+    std::array<std::optional<std::vector<std::uint8_t>>, kWindowSize> received_{};
+    std::deque<std::vector<std::uint8_t>> delivered_;
+    bool ack_owed_{false};
+};
+
+}  // namespace engine::net
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace engine::net {
+
+// What push() does when the ring is full.
+enum class OverflowPolicy : std::uint8_t {
+    Reject,      // The new element is discarded and push() returns false.
+    DropOldest,  // The oldest queued element is discarded to make room.
+};
+
+/**
+ * @brief Bounded lock-free ring queue for the packet path.
+ *
+ * Each slot carries a sequence number (Vyukov's bounded queue), so producers and
+ * the consumer never touch the same slot at the same time and no mutex or
+ * condition variable is involved. `MultiProducer` selects whether the tail is
+ * claimed with a CAS (MPSC) or a plain store (SPSC). The head is always claimed
+ * with a CAS because a DropOldest producer discards from the head on overflow.
+ *
+ * Capacity is rounded up to a power of two.
+ */
+template <typename T, bool MultiProducer>
+class BoundedRingQueue {
+public:
+    explicit BoundedRingQueue(std::size_t capacity, OverflowPolicy policy = OverflowPolicy::Reject)
+        : capacity_(round_up_pow2(capacity)),
+          mask_(capacity_ - 1),
+          policy_(policy),
+          cells_(std::make_unique<Cell[]>(capacity_)) {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedRingQueue(const BoundedRingQueue&) = delete;
+    BoundedRingQueue& operator=(const BoundedRingQueue&) = delete;
+
+    // Returns false if the value was rejected because the queue was full.
+    bool push(const T& value) { return emplace(value); }
+    bool push(T&& value) { return emplace(std::move(value)); }
+
+    std::optional<T> try_pop() {
+        for (;;) {
+            std::size_t pos = head_.load(std::memory_order_relaxed);
+            Cell& cell = cells_[pos & mask_];
+            const auto seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    T value = std::move(cell.value);
+                    cell.sequence.store(pos + capacity_, std::memory_order_release);
+                    return value;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;  // Empty
+            }
+            // Head moved under us (overflow discard); retry.
+        }
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    // Approximate when producers and consumer are running.
+    std::size_t size() const {
+        const auto tail = tail_.load(std::memory_order_acquire);
+        const auto head = head_.load(std::memory_order_acquire);
+        return tail >= head ? tail - head : 0;
+    }
+
+    std::size_t capacity() const { return capacity_; }
+    OverflowPolicy policy() const { return policy_; }
+
+    // Elements lost to the overflow policy (rejected or discarded) since construction.
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::size_t kCacheLine = 64;
+
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        T value{};
+    };
+
+    static std::size_t round_up_pow2(std::size_t value) {
+        std::size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    template <typename U>
+    bool emplace(U&& value) {
+        for (;;) {
+            std::size_t pos = tail_.load(std::memory_order_relaxed);
+            Cell& cell = cells_[pos & mask_];
+            const auto seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if constexpr (MultiProducer) {
+                    if (!tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        continue;
+                    }
+                } else {
+                    tail_.store(pos + 1, std::memory_order_relaxed);
+                }
+                cell.value = std::forward<U>(value);
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+            if (diff < 0) {
+                // Full.
+                if (policy_ == OverflowPolicy::Reject) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                if (try_pop()) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            // Another producer claimed this slot, or room was just made; retry.
+        }
+    }
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    const OverflowPolicy policy_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(kCacheLine) std::atomic<std::size_t> head_{0};
+    alignas(kCacheLine) std::atomic<std::size_t> tail_{0};
+    alignas(kCacheLine) std::atomic<std::uint64_t> dropped_{0};
+};
+
+// Client snapshot queue: one network thread producing, the game thread consuming.
+template <typename T>
+using SpscRingQueue = BoundedRingQueue<T, false>;
+
+// Server input queue: any number of network threads producing, the game thread consuming.
+template <typename T>
+using MpscRingQueue = BoundedRingQueue<T, true>;
+
+}  // namespace engine::net
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "engine/net/packet.hpp"
+
+namespace engine::net {
+
+// How often, and how large, snapshots to one client are.
+struct SendRate {
+    std::uint8_t interval_ticks{1};    // One snapshot every N server ticks
+    std::uint8_t budget_percent{100};  // Share of the replication budget each snapshot may use
+
+    bool operator==(const SendRate&) const = default;
+};
+
+/**
+ * @brief Picks one client's snapshot rate from the link reports in its Pings.
+ *
+ * Tracks smoothed loss (datagrams received vs sent, by sequence number) and RTT.
+ * Queue buildup shows up as RTT rising above the lowest RTT seen recently, before
+ * any loss. Either signal steps the rate down one level (every tick, every 2nd,
+ * every 3rd: 60/30/20 Hz at 60 Hz), at most once per `hold`; the rate only steps
+ * back up after the link stayed clean for `probe`. Lossy links also get smaller
+ * snapshots, so a lost one costs less.
+ *
+ * Not thread-safe: the server updates it from the listener thread only.
+ */
+class SendRateController {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::array<std::uint8_t, 3> kIntervals{1, 2, 3};
+
+    struct Config {
+        double loss_down{0.05};  // Step down above this loss
+        double loss_up{0.01};    // Clean below this loss
+        std::chrono::milliseconds queue_down{60};  // Step down above this queueing delay
+        std::chrono::milliseconds queue_up{20};    // Clean below this queueing delay
+        std::chrono::milliseconds hold{1000};      // Between two step downs
+        std::chrono::milliseconds probe{3000};     // Clean time before a step up
+        std::chrono::seconds min_rtt_window{10};   // Lowest RTT is forgotten after this
+    };
+
+    SendRateController() : SendRateController(Config{}) {}
+    explicit SendRateController(Config config) : config_(config) {}
+
+    // Applies one Ping report. Returns true if rate() changed.
+    bool on_report(const PingMessage& report, Clock::time_point now) {
+        if (report.expected > 0) {
+            const auto received = std::min(report.received, report.expected);
+            const double sample = 1.0 - static_cast<double>(received) / static_cast<double>(report.expected);
+            loss_ = has_loss_ ? loss_ * 0.7 + sample * 0.3 : sample;
+            has_loss_ = true;
+        }
+        if (report.rtt_ms > 0) {
+            const double rtt = report.rtt_ms;
+            srtt_ms_ = has_rtt_ ? srtt_ms_ * 0.8 + rtt * 0.2 : rtt;
+            if (!has_rtt_ || rtt <= min_rtt_ms_ || now - min_rtt_at_ > config_.min_rtt_window) {
+                min_rtt_ms_ = rtt;
+                min_rtt_at_ = now;
+            }
+            has_rtt_ = true;
+        }
+        if (!has_loss_ && !has_rtt_) {
+            return false;
+        }
+
+        const auto previous = rate();
+        const double queue_ms = queue_delay_ms();
+        const bool congested = loss_ > config_.loss_down || queue_ms > static_cast<double>(config_.queue_down.count());
+        const bool clean = loss_ < config_.loss_up && queue_ms < static_cast<double>(config_.queue_up.count());
+        if (!clean) {
+            clean_since_ = now;
+        }
+        if (congested && level_ + 1 < kIntervals.size() && now - changed_at_ >= config_.hold) {
+            ++level_;
+            changed_at_ = now;
+            clean_since_ = now;
+        } else if (clean && level_ > 0 && now - clean_since_ >= config_.probe && now - changed_at_ >= config_.probe) {
+            --level_;
+            changed_at_ = now;
+            clean_since_ = now;  // Prove the faster rate before going faster again
+        }
+        return rate() != previous;
+    }
+
+    SendRate rate() const {
+        std::uint8_t budget = 100;
+        if (loss_ >= 0.10) {
+            budget = 50;
+        } else if (loss_ >= config_.loss_down) {
+            budget = 75;
+        }
+        return SendRate{kIntervals[level_], budget};
+    }
+
+    double loss() const { return loss_; }
+    double srtt_ms() const { return srtt_ms_; }
+    // Smoothed RTT above the lowest recent RTT: time spent in queues along the path.
+    double queue_delay_ms() const { return has_rtt_ ? std::max(0.0, srtt_ms_ - min_rtt_ms_) : 0.0; }
+
+private:
+    Config config_;
+    std::size_t level_{0};  // Index in kIntervals
+    double loss_{0.0};
+    double srtt_ms_{0.0};
+    double min_rtt_ms_{0.0};
+    bool has_loss_{false};
+    bool has_rtt_{false};
+    Clock::time_point min_rtt_at_{};
+    Clock::time_point changed_at_{};
+    Clock::time_point clean_since_{};
+};
+
+}  // namespace engine::net
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -8,6 +9,8 @@
 #include <type_traits>
 #include <vector>
 
+#include "engine/net/packet_buffer.hpp"
+
 namespace engine::net {
 
 inline void write_bytes(std::vector<std::uint8_t>& buffer, std::span<const std::uint8_t> bytes) {
@@ -17,6 +20,11 @@ inline void write_bytes(std::vector<std::uint8_t>& buffer, std::span<const std::
     std::memcpy(buffer.data() + old_size, bytes.data(), bytes.size());
 }
 
+template <std::size_t Capacity>
+void write_bytes(FixedBuffer<Capacity>& buffer, std::span<const std::uint8_t> bytes) {
+    buffer.append(bytes);
+}
+
 inline bool read_bytes(std::span<const std::uint8_t>& buffer, std::span<std::uint8_t> out) {
     if (buffer.size() < out.size()) {
         return false;
@@ -26,8 +34,9 @@ inline bool read_bytes(std::span<const std::uint8_t>& buffer, std::span<std::uin
     return true;
 }
 
-template <typename T>
-void write_value(std::vector<std::uint8_t>& buffer, const T& value) {
+// `Buffer` is a std::vector<std::uint8_t> or a FixedBuffer.
+template <typename Buffer, typename T>
+void write_value(Buffer& buffer, const T& value) {
     static_assert(std::is_trivially_copyable_v<T>, "write_value requires trivially copyable types");
     const auto* data = reinterpret_cast<const std::uint8_t*>(&value);
     write_bytes(buffer, std::span<const std::uint8_t>(data, sizeof(T)));
@@ -44,4 +53,105 @@ bool read_value(std::span<const std::uint8_t>& buffer, T& out) {
     return true;
 }
 
+// =============================================================================
+// Bit packing
+// =============================================================================
+// Values are packed LSB-first into consecutive bytes, with no alignment between
+// fields. BitWriter appends to a byte buffer; call flush() to pad the last byte.
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<std::uint8_t>& buffer) : buffer_(buffer) {}
+
+    // Writes the low `bits` bits of `value` (1..32).
+    void write_bits(std::uint32_t value, unsigned bits) {
+        const auto mask = bits >= 32 ? ~std::uint64_t{0} >> 32 : (std::uint64_t{1} << bits) - 1;
+        scratch_ |= (static_cast<std::uint64_t>(value) & mask) << scratch_bits_;
+        scratch_bits_ += bits;
+        while (scratch_bits_ >= 8) {
+            buffer_.push_back(static_cast<std::uint8_t>(scratch_ & 0xFF));
+            scratch_ >>= 8;
+            scratch_bits_ -= 8;
+        }
+    }
+
+    void write_bool(bool value) { write_bits(value ? 1u : 0u, 1); }
+
+    // Pads the pending bits with zeros up to the next byte boundary.
+    void flush() {
+        if (scratch_bits_ > 0) {
+            buffer_.push_back(static_cast<std::uint8_t>(scratch_ & 0xFF));
+            scratch_ = 0;
+            scratch_bits_ = 0;
+        }
+    }
+
+private:
+    std::vector<std::uint8_t>& buffer_;
+    std::uint64_t scratch_{0};
+    unsigned scratch_bits_{0};
+};
+
+class BitReader {
+public:
+    explicit BitReader(std::span<const std::uint8_t> buffer) : buffer_(buffer) {}
+
+    // Reads `bits` bits (1..32); returns false without consuming anything on overrun.
+    bool read_bits(unsigned bits, std::uint32_t& out) {
+        if (bit_offset_ + bits > buffer_.size() * 8) {
+            return false;
+        }
+        std::uint64_t value = 0;
+        for (unsigned read = 0; read < bits;) {
+            const auto byte = buffer_[bit_offset_ / 8];
+            const auto shift = static_cast<unsigned>(bit_offset_ % 8);
+            const auto take = std::min(8u - shift, bits - read);
+            const auto chunk = (static_cast<std::uint64_t>(byte) >> shift) & ((std::uint64_t{1} << take) - 1);
+            value |= chunk << read;
+            read += take;
+            bit_offset_ += take;
+        }
+        out = static_cast<std::uint32_t>(value);
+        return true;
+    }
+
+    bool read_bool(bool& out) {
+        std::uint32_t value = 0;
+        if (!read_bits(1, value)) {
+            return false;
+        }
+        out = value != 0;
+        return true;
+    }
+
+    std::size_t bits_remaining() const { return buffer_.size() * 8 - bit_offset_; }
+
+private:
+    std::span<const std::uint8_t> buffer_;
+    std::size_t bit_offset_{0};
+};
+
+// Maps floats in [min, max] onto `bits`-bit integers; values outside are clamped.
+// dequantize(quantize(v)) is deterministic, so both ends can compare the result exactly.
+struct QuantizedRange {
+    float min;
+    float max;
+    unsigned bits;
+
+    std::uint32_t max_code() const { return bits >= 32 ? 0xFFFFFFFFu : (1u << bits) - 1; }
+
+    std::uint32_t quantize(float value) const {
+        const auto clamped = std::clamp(value, min, max);
+        const auto normalized = static_cast<double>(clamped - min) / static_cast<double>(max - min);
+        return static_cast<std::uint32_t>(std::llround(normalized * max_code()));
+    }
+
+    float dequantize(std::uint32_t code) const {
+        const auto normalized = static_cast<double>(std::min(code, max_code())) / max_code();
+        return static_cast<float>(static_cast<double>(min) + normalized * static_cast<double>(max - min));
+    }
+
+    float snap(float value) const { return dequantize(quantize(value)); }
+};
+
 }  // namespace engine::net
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+namespace engine::net {
+
+/**
+ * @brief Newest-value hand-off from one producer thread to one consumer thread.
+ *
+ * Three slots: the producer fills back(), the consumer reads what take() returned,
+ * and the third holds the latest published value in between. Neither side waits for
+ * the other to finish with its slot; the mutex covers only the index swaps. A value
+ * still untaken when the next one is published is superseded, since the consumer only
+ * wants the newest. Slots are recycled rather than destroyed, so values that own
+ * buffers keep their capacity from one hand-off to the next.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    // Producer: the slot to fill before publish(). Holds whatever an earlier hand-off left.
+    T& back() { return slots_[back_]; }
+
+    // Producer: hands back() to the consumer. If the previous value was never taken,
+    // `fold(superseded, published)` runs first (under the lock) and publish() returns true.
+    template <typename Fold>
+    bool publish(Fold&& fold) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const bool superseded = fresh_;
+        if (superseded) {
+            fold(slots_[middle_], slots_[back_]);
+        }
+        std::swap(back_, middle_);
+        fresh_ = true;
+        return superseded;
+    }
+
+    bool publish() {
+        return publish([](T&, T&) {});
+    }
+
+    // Consumer: the newest value published since the last take(), or nullptr. The
+    // pointee is the consumer's until its next take().
+    T* take() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!fresh_) {
+            return nullptr;
+        }
+        std::swap(front_, middle_);
+        fresh_ = false;
+        return &slots_[front_];
+    }
+
+private:
+    std::array<T, 3> slots_{};
+    std::mutex mutex_;
+    std::size_t back_{0};
+    std::size_t middle_{1};
+    std::size_t front_{2};
+    bool fresh_{false};  // middle_ holds a value not taken yet
+};
+
+}  // namespace engine::net
@@ -1,11 +1,40 @@
 #pragma once
 
 #include <asio.hpp>
+#include <algorithm>
+#include <array>
+#include <cerrno>
 #include <cstdint>
 #include <span>
+#include <system_error>
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
 
 namespace engine::net {
 
+// One datagram queued for send_batch. The bytes are borrowed, not copied.
+// `tail` is an optional second buffer sent right after `data` (gather write), so a
+// small per-recipient header can be paired with a payload shared by many recipients.
+struct OutgoingDatagram {
+    std::span<const std::uint8_t> data;
+    asio::ip::udp::endpoint endpoint;
+    std::span<const std::uint8_t> tail{};
+};
+
+// One receive slot for receive_batch. `buffer` is caller-owned storage;
+// `size` and `endpoint` are filled in for every slot the call reports as used.
+struct IncomingDatagram {
+    std::span<std::uint8_t> buffer;
+    std::size_t size{0};
+    asio::ip::udp::endpoint endpoint;
+};
+
+// Upper bound of datagrams handed to a single sendmmsg/recvmmsg call.
+inline constexpr std::size_t kMaxDatagramBatch = 64;
+
 class UdpSocket {
 public:
     explicit UdpSocket(asio::io_context& io)
@@ -25,6 +54,117 @@ public:
         socket_.send_to(asio::buffer(data.data(), data.size()), endpoint);
     }
 
+    // Sends every datagram of `batch` (data followed by tail) and returns how many were handed to the kernel.
+    // On Linux this is one sendmmsg() per kMaxDatagramBatch datagrams; elsewhere it
+    // falls back to one send_to() per datagram. A datagram the kernel refuses (say, an
+    // unreachable client) is skipped so the ones queued after it still go out; `ec`
+    // keeps the first such error.
+    std::size_t send_batch(std::span<const OutgoingDatagram> batch, std::error_code& ec) {
+        ec.clear();
+        std::size_t sent = 0;
+#if defined(__linux__)
+        std::size_t next = 0;
+        while (next < batch.size()) {
+            const auto chunk = batch.subspan(next, std::min(batch.size() - next, kMaxDatagramBatch));
+            std::array<mmsghdr, kMaxDatagramBatch> headers{};
+            std::array<iovec, kMaxDatagramBatch * 2> iovecs{};
+            for (std::size_t i = 0; i < chunk.size(); ++i) {
+                auto* iov = &iovecs[i * 2];
+                iov[0].iov_base = const_cast<std::uint8_t*>(chunk[i].data.data());
+                iov[0].iov_len = chunk[i].data.size();
+                iov[1].iov_base = const_cast<std::uint8_t*>(chunk[i].tail.data());
+                iov[1].iov_len = chunk[i].tail.size();
+                headers[i].msg_hdr.msg_name = const_cast<sockaddr*>(chunk[i].endpoint.data());
+                headers[i].msg_hdr.msg_namelen = static_cast<socklen_t>(chunk[i].endpoint.size());
+                headers[i].msg_hdr.msg_iov = iov;
+                headers[i].msg_hdr.msg_iovlen = chunk[i].tail.empty() ? 1 : 2;
+            }
+            const int result = ::sendmmsg(socket_.native_handle(), headers.data(),
+                                          static_cast<unsigned int>(chunk.size()), 0);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                // sendmmsg only fails outright on the chunk's first datagram: drop that one.
+                if (!ec) {
+                    ec = std::error_code(errno, std::system_category());
+                }
+                ++next;
+                continue;
+            }
+            next += static_cast<std::size_t>(result);
+            sent += static_cast<std::size_t>(result);
+        }
+#else
+        for (const auto& datagram : batch) {
+            const std::array<asio::const_buffer, 2> buffers{
+                asio::buffer(datagram.data.data(), datagram.data.size()),
+                asio::buffer(datagram.tail.data(), datagram.tail.size())};
+            std::error_code send_ec;
+            socket_.send_to(buffers, datagram.endpoint, 0, send_ec);
+            if (send_ec) {
+                if (!ec) {
+                    ec = send_ec;
+                }
+                continue;
+            }
+            ++sent;
+        }
+#endif
+        return sent;
+    }
+
+    // Blocks until at least one datagram is available, then drains whatever else is
+    // already queued (without blocking) into the remaining slots of `batch`.
+    // Returns the number of slots filled.
+    std::size_t receive_batch(std::span<IncomingDatagram> batch, std::error_code& ec) {
+        ec.clear();
+        if (batch.empty()) {
+            return 0;
+        }
+#if defined(__linux__)
+        const auto count = std::min(batch.size(), kMaxDatagramBatch);
+        std::array<mmsghdr, kMaxDatagramBatch> headers{};
+        std::array<iovec, kMaxDatagramBatch> iovecs{};
+        for (std::size_t i = 0; i < count; ++i) {
+            iovecs[i].iov_base = batch[i].buffer.data();
+            iovecs[i].iov_len = batch[i].buffer.size();
+            headers[i].msg_hdr.msg_name = batch[i].endpoint.data();
+            headers[i].msg_hdr.msg_namelen = static_cast<socklen_t>(batch[i].endpoint.capacity());
+            headers[i].msg_hdr.msg_iov = &iovecs[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+        }
+        int result = -1;
+        do {
+            result = ::recvmmsg(socket_.native_handle(), headers.data(),
+                                static_cast<unsigned int>(count), MSG_WAITFORONE, nullptr);
+        } while (result < 0 && errno == EINTR);
+        if (result < 0) {
+            ec = std::error_code(errno, std::system_category());
+            return 0;
+        }
+        const auto received = static_cast<std::size_t>(result);
+        for (std::size_t i = 0; i < received; ++i) {
+            batch[i].size = headers[i].msg_len;
+            batch[i].endpoint.resize(headers[i].msg_hdr.msg_namelen);
+        }
+        return received;
+#else
+        std::size_t received = 0;
+        do {
+            auto& slot = batch[received];
+            slot.size = socket_.receive_from(asio::buffer(slot.buffer.data(), slot.buffer.size()),
+                                             slot.endpoint, 0, ec);
+            if (ec) {
+                return received;
+            }
+            ++received;
+        } while (received < batch.size() && socket_.available(ec) > 0 && !ec);
+        ec.clear();
+        return received;
+#endif
+    }
+
     asio::ip::udp::socket& native() { return socket_; }
 
 private:
@@ -0,0 +1,271 @@
+#include "bot_client.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <utility>
+
+namespace loadgen {
+
+namespace {
+constexpr std::uint16_t kInputUp = 1 << 0;
+constexpr std::uint16_t kInputDown = 1 << 1;
+constexpr std::uint16_t kInputLeft = 1 << 2;
+constexpr std::uint16_t kInputRight = 1 << 3;
+constexpr std::uint16_t kInputShoot = 1 << 4;
+
+constexpr std::chrono::milliseconds kHelloRetry{500};
+constexpr std::chrono::milliseconds kPingInterval{500};
+constexpr std::chrono::milliseconds kSweepHalfPeriod{1500};
+
+double elapsed_ms(BotClient::Clock::time_point from, BotClient::Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+}  // namespace
+
+std::uint32_t steady_now_ms() {
+    return static_cast<std::uint32_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+void BotStats::merge(const BotStats& other) {
+    snapshots += other.snapshots;
+    dropped += other.dropped;
+    datagrams += other.datagrams;
+    bytes += other.bytes;
+    inputs_sent += other.inputs_sent;
+    decode_ms_total += other.decode_ms_total;
+    decode_ms_max = std::max(decode_ms_max, other.decode_ms_max);
+    latency_samples += other.latency_samples;
+    latency_ms_total += other.latency_ms_total;
+    latency_ms_max = std::max(latency_ms_max, other.latency_ms_max);
+}
+
+BotClient::BotClient(asio::io_context& io, const asio::ip::udp::endpoint& server, std::uint16_t index,
+                     std::uint16_t room_id, InputScript script, std::uint32_t seed, bool compression)
+    : socket_(io), server_(server), index_(index), room_id_(room_id), script_(script), rng_(seed),
+      compression_(compression) {
+    socket_.bind(0);
+    socket_.native().non_blocking(true);
+}
+
+void BotClient::poll(Clock::time_point now) {
+    while (true) {
+        asio::ip::udp::endpoint sender;
+        std::error_code ec;
+        const auto received = socket_.native().receive_from(
+            asio::buffer(receive_buffer_.data(), receive_buffer_.size()), sender, 0, ec);
+        if (ec) {
+            return;  // would_block: drained (anything else is retried next tick)
+        }
+        handle_datagram(std::span<const std::uint8_t>(receive_buffer_.data(), received), now);
+    }
+}
+
+void BotClient::tick(Clock::time_point now) {
+    if (!connected()) {
+        if (now >= next_hello_) {
+            send_hello();
+            next_hello_ = now + kHelloRetry;
+        }
+        return;
+    }
+    send_input(now);
+    if (now >= next_ping_) {
+        send_ping();
+        next_ping_ = now + kPingInterval;
+    }
+}
+
+BotStats BotClient::take_interval() {
+    total_.merge(interval_);
+    return std::exchange(interval_, BotStats{});
+}
+
+void BotClient::handle_datagram(std::span<const std::uint8_t> bytes, Clock::time_point now) {
+    auto packet = engine::net::parse_packet(bytes);
+    if (!packet) {
+        return;
+    }
+    ++interval_.datagrams;
+    interval_.bytes += bytes.size();
+    switch (static_cast<engine::net::MessageType>(packet->header.type)) {
+        case engine::net::MessageType::Welcome:
+            if (auto welcome = engine::net::decode_welcome_payload(packet->payload); welcome && !connected()) {
+                player_id_ = welcome->player_id;
+            }
+            break;
+        case engine::net::MessageType::Snapshot:
+            handle_snapshot(packet->payload, now);
+            break;
+        case engine::net::MessageType::SnapshotFragment:
+            if (auto fragment = engine::net::decode_fragment_payload(packet->payload)) {
+                if (auto payload = reassembler_.add(*fragment, now)) {
+                    handle_snapshot(std::span<const std::uint8_t>(payload->data(), payload->size()), now);
+                }
+            }
+            break;
+        case engine::net::MessageType::Reliable:
+            handle_reliable(packet->payload);
+            break;
+        case engine::net::MessageType::Ping:
+            handle_pong(packet->payload);
+            break;
+        default:
+            break;
+    }
+}
+
+void BotClient::handle_snapshot(std::span<const std::uint8_t> payload, Clock::time_point now) {
+    auto received = engine::net::decode_snapshot_view(payload);
+    if (!received) {
+        return;
+    }
+    const auto started = Clock::now();
+    const bool decoded = engine::net::inflate_snapshot(*received, inflated_blob_) && decoder_.decode(*received, snapshot_);
+    const double decode_ms = elapsed_ms(started, Clock::now());
+    if (!decoded) {
+        ++interval_.dropped;
+        return;
+    }
+    ++interval_.snapshots;
+    interval_.decode_ms_total += decode_ms;
+    interval_.decode_ms_max = std::max(interval_.decode_ms_max, decode_ms);
+    decoded_tick_ = std::max(decoded_tick_, snapshot_.tick);
+
+    // The first snapshot that reflects an input closes its latency measurement.
+    if (snapshot_.last_processed_input > last_processed_input_) {
+        last_processed_input_ = snapshot_.last_processed_input;
+        const auto end = sent_inputs_.begin() + static_cast<std::ptrdiff_t>(sent_input_count_);
+        auto it = std::find_if(sent_inputs_.begin(), end,
+                               [&](const SentInput& sent) { return sent.sequence == last_processed_input_; });
+        if (it != end) {
+            const double latency = elapsed_ms(it->sent_at, now);
+            ++interval_.latency_samples;
+            interval_.latency_ms_total += latency;
+            interval_.latency_ms_max = std::max(interval_.latency_ms_max, latency);
+        }
+    }
+}
+
+void BotClient::handle_reliable(std::span<const std::uint8_t> payload) {
+    if (!events_.read_packet(payload)) {
+        return;
+    }
+    while (events_.receive()) {
+        // Game events are not interpreted, only acknowledged.
+    }
+    if (!events_.write_packet(reliable_payload_, Clock::now(),
+                              engine::net::kMaxPacketSize - engine::net::kPacketHeaderSize)) {
+        return;
+    }
+    engine::net::PacketHeader header;
+    header.type = static_cast<std::uint8_t>(engine::net::MessageType::Reliable);
+    header.sequence = sequence_++;
+    engine::net::begin_packet(datagram_, header);
+    engine::net::write_bytes(datagram_, reliable_payload_);
+    send(datagram_);
+}
+
+void BotClient::handle_pong(std::span<const std::uint8_t> payload) {
+    auto pong = engine::net::decode_pong_payload(payload);
+    if (!pong) {
+        return;
+    }
+    const auto now = steady_now_ms();
+    if (pong->has_server_time) {
+        clock_.on_exchange(pong->ping.client_time_ms, pong->server_receive_ms, pong->server_send_ms, now);
+    } else {
+        clock_.on_round_trip(static_cast<double>(static_cast<std::int32_t>(now - pong->ping.client_time_ms)));
+    }
+}
+
+void BotClient::send_hello() {
+    engine::net::Packet hello;
+    hello.header.type = static_cast<std::uint8_t>(engine::net::MessageType::Hello);
+    hello.header.sequence = sequence_++;
+    engine::net::HelloMessage msg{};
+    std::snprintf(msg.player_name, sizeof(msg.player_name), "bot%u", static_cast<unsigned>(index_));
+    msg.room_id = room_id_;
+    msg.features = compression_ ? engine::net::kFeatureSnapshotCompression : std::uint8_t{0};
+    engine::net::encode_hello_payload(msg, hello.payload);
+    auto bytes = engine::net::serialize(hello);
+    std::error_code ec;
+    socket_.native().send_to(asio::buffer(bytes.data(), bytes.size()), server_, 0, ec);
+}
+
+void BotClient::send_input(Clock::time_point now) {
+    engine::net::PacketHeader header;
+    header.type = static_cast<std::uint8_t>(engine::net::MessageType::Input);
+    header.sequence = sequence_++;
+    engine::net::InputMessage msg{
+        .player_id = player_id_,
+        .input_mask = next_mask(now),
+        .client_time_ms = steady_now_ms(),
+        .ack_tick = decoded_tick_,
+    };
+    const auto redundant = std::min(sent_input_count_, engine::net::kInputRedundancy);
+    for (std::size_t i = 0; i < redundant; ++i) {
+        const auto& sent = sent_inputs_[i];
+        msg.previous[i] = engine::net::PreviousInput{header.sequence - sent.sequence, sent.mask, sent.client_time_ms};
+    }
+    msg.previous_count = static_cast<std::uint8_t>(redundant);
+    std::copy_backward(sent_inputs_.begin(), sent_inputs_.end() - 1, sent_inputs_.end());
+    sent_inputs_[0] = SentInput{header.sequence, msg.input_mask, msg.client_time_ms, now};
+    sent_input_count_ = std::min(sent_input_count_ + 1, sent_inputs_.size());
+
+    engine::net::begin_packet(datagram_, header);
+    engine::net::append_input_payload(msg, datagram_);
+    send(datagram_);
+    ++interval_.inputs_sent;
+}
+
+void BotClient::send_ping() {
+    engine::net::PacketHeader header;
+    header.type = static_cast<std::uint8_t>(engine::net::MessageType::Ping);
+    header.sequence = sequence_++;
+    const engine::net::PingMessage ping{
+        .client_time_ms = steady_now_ms(),
+        .rtt_ms = static_cast<std::uint16_t>(std::clamp(clock_.last_rtt_ms(), 0.0, 65535.0)),
+        .received = 0,  // No link report: the server keeps the full snapshot rate
+        .expected = 0,
+    };
+    engine::net::begin_packet(datagram_, header);
+    engine::net::append_ping_payload(ping, datagram_);
+    send(datagram_);
+}
+
+std::uint16_t BotClient::next_mask(Clock::time_point now) {
+    switch (script_) {
+        case InputScript::Idle:
+            mask_ = 0;
+            break;
+        case InputScript::Random:
+            if (now >= next_mask_change_) {
+                static constexpr std::array<std::uint16_t, 9> kDirections{
+                    0, kInputUp, kInputDown, kInputLeft, kInputRight,
+                    kInputUp | kInputLeft, kInputUp | kInputRight, kInputDown | kInputLeft, kInputDown | kInputRight};
+                mask_ = kDirections[std::uniform_int_distribution<std::size_t>(0, kDirections.size() - 1)(rng_)];
+                if (std::bernoulli_distribution(0.5)(rng_)) {
+                    mask_ |= kInputShoot;
+                }
+                next_mask_change_ = now + std::chrono::milliseconds(std::uniform_int_distribution<int>(100, 400)(rng_));
+            }
+            break;
+        case InputScript::Sweep: {
+            const auto half_periods = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) /
+                                      kSweepHalfPeriod;
+            mask_ = static_cast<std::uint16_t>(((half_periods + index_) % 2 == 0 ? kInputUp : kInputDown) | kInputShoot);
+            break;
+        }
+    }
+    return mask_;
+}
+
+void BotClient::send(const engine::net::PacketBuffer& datagram) {
+    std::error_code ec;  // A full send buffer just drops the datagram, like a lossy link would
+    socket_.native().send_to(asio::buffer(datagram.data(), datagram.size()), server_, 0, ec);
+}
+
+}  // namespace loadgen
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <asio.hpp>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "engine/game/systems/network/snapshot_codec.hpp"
+#include "engine/net/clock_sync.hpp"
+#include "engine/net/compression.hpp"
+#include "engine/net/packet.hpp"
+#include "engine/net/reliable_channel.hpp"
+#include "engine/net/udp_socket.hpp"
+
+namespace loadgen {
+
+enum class InputScript : std::uint8_t {
+    Idle,    // No keys: only acks and pings
+    Random,  // A random direction (and sometimes the trigger) every 100-400 ms
+    Sweep,   // Up and down across the screen, trigger held
+};
+
+// What one bot measured over a reporting interval (or the whole run).
+struct BotStats {
+    std::uint64_t snapshots{0};       // Decoded, full or delta
+    std::uint64_t dropped{0};         // Unknown delta baseline or corrupt compressed blob
+    std::uint64_t datagrams{0};       // Received from the server, pongs included
+    std::uint64_t bytes{0};
+    std::uint64_t inputs_sent{0};
+    double decode_ms_total{0.0};
+    double decode_ms_max{0.0};
+    // From sending an input to the first snapshot whose last_processed_input covers it.
+    std::uint64_t latency_samples{0};
+    double latency_ms_total{0.0};
+    double latency_ms_max{0.0};
+
+    void merge(const BotStats& other);
+};
+
+/**
+ * @brief One simulated player: the NetworkClient protocol without threads or SFML.
+ *
+ * Speaks Hello/Welcome, sends an Input (with redundancy and ack) every tick, answers
+ * Reliable packets with acks, pings every 500 ms and decodes every snapshot with the
+ * same SnapshotDeltaDecoder as the game client. Its socket is non-blocking: the load
+ * generator drives many bots from one thread by calling poll() and tick() in turn.
+ */
+class BotClient {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    BotClient(asio::io_context& io, const asio::ip::udp::endpoint& server, std::uint16_t index,
+              std::uint16_t room_id, InputScript script, std::uint32_t seed, bool compression = true);
+
+    // Drains every datagram waiting on the socket.
+    void poll(Clock::time_point now);
+    // One 60 Hz step: (re)sends the Hello until welcomed, then the Input and, when due, a Ping.
+    void tick(Clock::time_point now);
+
+    bool connected() const { return player_id_ != 0; }
+    std::uint16_t index() const { return index_; }
+    std::uint16_t player_id() const { return player_id_; }
+    std::uint32_t decoded_tick() const { return decoded_tick_; }
+    const engine::net::ClockSync& clock() const { return clock_; }
+
+    // Counters since the previous call; they also accumulate into total().
+    BotStats take_interval();
+    const BotStats& total() const { return total_; }
+
+private:
+    struct SentInput {
+        std::uint32_t sequence{0};
+        std::uint16_t mask{0};
+        std::uint32_t client_time_ms{0};
+        Clock::time_point sent_at{};
+    };
+
+    void handle_datagram(std::span<const std::uint8_t> bytes, Clock::time_point now);
+    void handle_snapshot(std::span<const std::uint8_t> payload, Clock::time_point now);
+    void handle_reliable(std::span<const std::uint8_t> payload);
+    void handle_pong(std::span<const std::uint8_t> payload);
+    void send_hello();
+    void send_input(Clock::time_point now);
+    void send_ping();
+    std::uint16_t next_mask(Clock::time_point now);
+    void send(const engine::net::PacketBuffer& datagram);
+
+    engine::net::UdpSocket socket_;
+    asio::ip::udp::endpoint server_;
+    std::uint16_t index_;
+    std::uint16_t room_id_;
+    InputScript script_;
+    std::mt19937 rng_;
+    bool compression_;  // Offer kFeatureSnapshotCompression in the Hello
+
+    std::uint16_t player_id_{0};
+    std::uint32_t sequence_{0};
+    Clock::time_point next_hello_{};
+    Clock::time_point next_ping_{};
+    Clock::time_point next_mask_change_{};
+    std::uint16_t mask_{0};
+
+    // Newest first; [0] is also the newest send, for the latency measurement below.
+    std::array<SentInput, 64> sent_inputs_{};
+    std::size_t sent_input_count_{0};
+    std::uint32_t last_processed_input_{0};
+
+    std::array<std::uint8_t, engine::net::kMaxPacketSize> receive_buffer_{};
+    engine::net::PacketBuffer datagram_;
+    std::vector<std::uint8_t> reliable_payload_;
+    engine::net::SnapshotReassembler reassembler_;
+    rtype::game::SnapshotDeltaDecoder decoder_;
+    std::vector<std::uint8_t> inflated_blob_;
+    engine::net::SnapshotMessage snapshot_;
+    std::uint32_t decoded_tick_{0};
+    engine::net::ReliableChannel events_;
+    engine::net::ClockSync clock_;
+
+    BotStats interval_;
+    BotStats total_;
+};
+
+std::uint32_t steady_now_ms();
+
+}  // namespace loadgen
@@ -0,0 +1,238 @@
+// Headless load generator: N simulated players against a running rtype_server.
+//
+// Usage: rtype_loadgen [--host 127.0.0.1] [--port 4242] [--clients 16] [--rooms 1]
+//                      [--seconds 30] [--script random|sweep|idle] [--seed 1] [--report 1]
+//                      [--compression on|off]
+//
+// Bot i joins room i % rooms (start the server with at least that many rooms). Every
+// reporting interval prints one aggregate line; the end of the run prints one line per
+// bot. Exits non-zero if a bot never connected or never decoded a snapshot, so a CI job
+// can run it against a local server as a smoke test.
+
+#include <asio.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bot_client.hpp"
+
+namespace {
+
+using Clock = loadgen::BotClient::Clock;
+
+constexpr std::chrono::nanoseconds kTick{1'000'000'000 / 60};
+
+struct Options {
+    std::string host{"127.0.0.1"};
+    std::uint16_t port{4242};
+    std::size_t clients{16};
+    std::uint16_t rooms{1};
+    std::size_t seconds{30};
+    std::size_t report_seconds{1};
+    loadgen::InputScript script{loadgen::InputScript::Random};
+    std::uint32_t seed{1};
+    bool compression{true};
+};
+
+std::optional<std::size_t> parse_number(const char* text, std::size_t max) {
+    char* end = nullptr;
+    const auto value = std::strtoul(text, &end, 10);
+    if (end == text || *end != '\0' || value > max) {
+        return std::nullopt;
+    }
+    return static_cast<std::size_t>(value);
+}
+
+std::optional<Options> parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string flag = argv[i];
+        const char* value = argv[i + 1];
+        std::optional<std::size_t> number;
+        if (flag == "--host") {
+            options.host = value;
+            continue;
+        }
+        if (flag == "--script") {
+            if (std::strcmp(value, "random") == 0) {
+                options.script = loadgen::InputScript::Random;
+            } else if (std::strcmp(value, "sweep") == 0) {
+                options.script = loadgen::InputScript::Sweep;
+            } else if (std::strcmp(value, "idle") == 0) {
+                options.script = loadgen::InputScript::Idle;
+            } else {
+                std::cerr << "[rtype_loadgen] Unknown script '" << value << "'\n";
+                return std::nullopt;
+            }
+            continue;
+        }
+        if (flag == "--compression" && (std::strcmp(value, "on") == 0 || std::strcmp(value, "off") == 0)) {
+            options.compression = std::strcmp(value, "on") == 0;
+            continue;
+        }
+        if (flag == "--port" && (number = parse_number(value, 65535))) {
+            options.port = static_cast<std::uint16_t>(*number);
+        } else if (flag == "--clients" && (number = parse_number(value, 4096)) && *number > 0) {
+            options.clients = *number;
+        } else if (flag == "--rooms" && (number = parse_number(value, 1024)) && *number > 0) {
+            options.rooms = static_cast<std::uint16_t>(*number);
+        } else if (flag == "--seconds" && (number = parse_number(value, 86400)) && *number > 0) {
+            options.seconds = *number;
+        } else if (flag == "--report" && (number = parse_number(value, 3600)) && *number > 0) {
+            options.report_seconds = *number;
+        } else if (flag == "--seed" && (number = parse_number(value, 0xFFFFFFFFu))) {
+            options.seed = static_cast<std::uint32_t>(*number);
+        } else {
+            std::cerr << "[rtype_loadgen] Invalid option '" << flag << " " << value << "'\n";
+            return std::nullopt;
+        }
+    }
+    if (argc % 2 == 0) {
+        std::cerr << "[rtype_loadgen] Missing value for '" << argv[argc - 1] << "'\n";
+        return std::nullopt;
+    }
+    return options;
+}
+
+double per_second(std::uint64_t count, double seconds) {
+    return seconds > 0.0 ? static_cast<double>(count) / seconds : 0.0;
+}
+
+double average(double total, std::uint64_t samples) {
+    return samples > 0 ? total / static_cast<double>(samples) : 0.0;
+}
+
+// One line over every bot: per-client rates are averaged, maxima are over all bots.
+void print_interval(double elapsed, double seconds, const std::vector<std::unique_ptr<loadgen::BotClient>>& bots,
+                    const std::vector<loadgen::BotStats>& stats) {
+    loadgen::BotStats sum;
+    std::size_t connected = 0;
+    double slowest_rate = -1.0;
+    double rtt_total = 0.0;
+    std::size_t rtt_count = 0;
+    for (std::size_t i = 0; i < bots.size(); ++i) {
+        sum.merge(stats[i]);
+        if (!bots[i]->connected()) {
+            continue;
+        }
+        ++connected;
+        const double rate = per_second(stats[i].snapshots, seconds);
+        slowest_rate = slowest_rate < 0.0 ? rate : std::min(slowest_rate, rate);
+        if (bots[i]->clock().has_rtt()) {
+            rtt_total += bots[i]->clock().rtt_ms();
+            ++rtt_count;
+        }
+    }
+    const double clients = static_cast<double>(std::max<std::size_t>(connected, 1));
+    std::cout << std::fixed << std::setprecision(1) << "[rtype_loadgen] t=" << elapsed << "s connected="
+              << connected << "/" << bots.size() << " snapshots/s/client=" << per_second(sum.snapshots, seconds) / clients
+              << " (min " << std::max(slowest_rate, 0.0) << ") KB/s/client="
+              << per_second(sum.bytes, seconds) / clients / 1024.0 << std::setprecision(3)
+              << " decode_ms avg=" << average(sum.decode_ms_total, sum.snapshots) << " max=" << sum.decode_ms_max
+              << std::setprecision(1) << " latency_ms avg=" << average(sum.latency_ms_total, sum.latency_samples)
+              << " max=" << sum.latency_ms_max << " rtt_ms=" << (rtt_count ? rtt_total / static_cast<double>(rtt_count) : 0.0)
+              << " dropped=" << sum.dropped << "\n";
+}
+
+void print_totals(double seconds, const std::vector<std::unique_ptr<loadgen::BotClient>>& bots) {
+    std::cout << "[rtype_loadgen] Per client over " << std::fixed << std::setprecision(1) << seconds << "s:\n";
+    std::cout << "  bot  player  snapshots/s  KB/s   decode_ms(avg/max)  latency_ms(avg/max)  rtt_ms  dropped\n";
+    for (const auto& bot : bots) {
+        const auto& total = bot->total();
+        std::cout << std::setw(5) << bot->index() << std::setw(8) << bot->player_id() << std::setprecision(1)
+                  << std::setw(13) << per_second(total.snapshots, seconds) << std::setw(7)
+                  << per_second(total.bytes, seconds) / 1024.0 << std::setprecision(3) << std::setw(11)
+                  << average(total.decode_ms_total, total.snapshots) << "/" << std::left << std::setw(8)
+                  << total.decode_ms_max << std::right << std::setprecision(1) << std::setw(12)
+                  << average(total.latency_ms_total, total.latency_samples) << "/" << std::left << std::setw(8)
+                  << total.latency_ms_max << std::right << std::setw(7) << bot->clock().rtt_ms() << std::setw(9)
+                  << total.dropped << "\n";
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const auto options = parse_options(argc, argv);
+    if (!options) {
+        return 2;
+    }
+
+    asio::io_context io;
+    std::error_code ec;
+    const auto address = asio::ip::make_address(options->host, ec);
+    if (ec) {
+        std::cerr << "[rtype_loadgen] Invalid host '" << options->host << "': " << ec.message() << "\n";
+        return 2;
+    }
+    const asio::ip::udp::endpoint server(address, options->port);
+
+    std::vector<std::unique_ptr<loadgen::BotClient>> bots;
+    bots.reserve(options->clients);
+    for (std::size_t i = 0; i < options->clients; ++i) {
+        const auto index = static_cast<std::uint16_t>(i);
+        bots.push_back(std::make_unique<loadgen::BotClient>(
+            io, server, index, static_cast<std::uint16_t>(i % options->rooms), options->script,
+            options->seed + static_cast<std::uint32_t>(i), options->compression));
+    }
+    std::cout << "[rtype_loadgen] " << bots.size() << " clients -> " << server << " (" << options->rooms
+              << " room(s)) for " << options->seconds << "s\n";
+
+    // One thread drives every bot at the server's tick rate: receive, then send.
+    const auto start = Clock::now();
+    const auto end = start + std::chrono::seconds(options->seconds);
+    const auto report_interval = std::chrono::seconds(options->report_seconds);
+    auto next_report = start + report_interval;
+    auto last_report = start;
+    auto next_tick = start;
+    std::vector<loadgen::BotStats> interval(bots.size());
+    while (true) {
+        const auto now = Clock::now();
+        for (auto& bot : bots) {
+            bot->poll(now);
+        }
+        if (now >= end) {
+            break;
+        }
+        for (auto& bot : bots) {
+            bot->tick(now);
+        }
+        if (now >= next_report) {
+            for (std::size_t i = 0; i < bots.size(); ++i) {
+                interval[i] = bots[i]->take_interval();
+            }
+            print_interval(std::chrono::duration<double>(now - start).count(),
+                           std::chrono::duration<double>(now - last_report).count(), bots, interval);
+            last_report = now;
+            next_report += report_interval;
+        }
+        next_tick += kTick;
+        if (next_tick < Clock::now()) {
+            next_tick = Clock::now();  // Fell behind: do not burst to catch up
+        }
+        std::this_thread::sleep_until(next_tick);
+    }
+    for (auto& bot : bots) {
+        bot->take_interval();
+    }
+
+    print_totals(std::chrono::duration<double>(Clock::now() - start).count(), bots);
+    const bool healthy = std::all_of(bots.begin(), bots.end(), [](const auto& bot) {
+        return bot->connected() && bot->total().snapshots > 0;
+    });
+    if (!healthy) {
+        std::cerr << "[rtype_loadgen] Some clients never connected or never decoded a snapshot\n";
+        return 1;
+    }
+    return 0;
+}
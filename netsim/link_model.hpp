@@ -0,0 +1,257 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <istream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace netsim {
+
+// How one direction of the link mistreats datagrams. Times are milliseconds,
+// probabilities are per datagram in [0, 1].
+struct LinkProfile {
+    double latency_ms{0.0};   // One-way delay added to every datagram
+    double jitter_ms{0.0};    // Uniform spread around latency_ms (never reorders on its own)
+    double loss{0.0};         // Independent drop probability
+    // Burst loss, Gilbert-Elliott style: each datagram may switch the link into a bad
+    // state (burst_enter) where it drops with burst_loss until it switches back (burst_exit).
+    double burst_enter{0.0};
+    double burst_exit{0.25};
+    double burst_loss{1.0};
+    double duplicate{0.0};    // Probability of delivering a second copy
+    double reorder{0.0};      // Probability of holding a datagram back so later ones overtake it
+    double reorder_ms{20.0};  // How long a reordered datagram is held back, on top of its delay
+};
+
+struct LinkStats {
+    std::uint64_t received{0};
+    std::uint64_t dropped{0};
+    std::uint64_t duplicated{0};
+    std::uint64_t reordered{0};
+
+    void merge(const LinkStats& other) {
+        received += other.received;
+        dropped += other.dropped;
+        duplicated += other.duplicated;
+        reordered += other.reordered;
+    }
+};
+
+/**
+ * @brief Decides the fate of each datagram crossing one direction of the link.
+ *
+ * admit() returns when each copy of the datagram should be delivered (none if it is
+ * lost). Delivery times never go backwards except for datagrams picked for
+ * reordering, so jitter alone keeps the stream in order, like a real queue does.
+ * All randomness comes from one seeded generator: the same seed and the same
+ * sequence of admit() calls give the same decisions.
+ */
+class ImpairedLink {
+public:
+    explicit ImpairedLink(std::uint32_t seed = 1) : rng_(seed) {}
+
+    void set_profile(const LinkProfile& profile) { profile_ = profile; }
+    const LinkProfile& profile() const { return profile_; }
+    const LinkStats& stats() const { return stats_; }
+
+    // Fills deliver_at_ms with 0, 1 or 2 delivery times and returns how many.
+    std::size_t admit(double now_ms, std::array<double, 2>& deliver_at_ms) {
+        ++stats_.received;
+        if (in_burst_) {
+            in_burst_ = !chance(profile_.burst_exit);
+        } else {
+            in_burst_ = chance(profile_.burst_enter);
+        }
+        if (chance(in_burst_ ? profile_.burst_loss : profile_.loss)) {
+            ++stats_.dropped;
+            return 0;
+        }
+        const std::size_t copies = chance(profile_.duplicate) ? 2 : 1;
+        stats_.duplicated += copies - 1;
+        for (std::size_t i = 0; i < copies; ++i) {
+            deliver_at_ms[i] = schedule(now_ms);
+        }
+        return copies;
+    }
+
+private:
+    bool chance(double probability) { return probability > 0.0 && unit_(rng_) < probability; }
+
+    double schedule(double now_ms) {
+        double at = now_ms + profile_.latency_ms;
+        if (profile_.jitter_ms > 0.0) {
+            at += (unit_(rng_) * 2.0 - 1.0) * profile_.jitter_ms;
+        }
+        at = std::max(at, now_ms);
+        if (chance(profile_.reorder)) {
+            ++stats_.reordered;
+            return std::max(at, last_in_order_ms_) + profile_.reorder_ms;
+        }
+        last_in_order_ms_ = std::max(at, last_in_order_ms_);
+        return last_in_order_ms_;
+    }
+
+    LinkProfile profile_{};
+    LinkStats stats_{};
+    std::mt19937 rng_;
+    std::uniform_real_distribution<double> unit_{0.0, 1.0};
+    bool in_burst_{false};
+    double last_in_order_ms_{0.0};
+};
+
+// Profiles for both directions from a point in time on.
+struct ScriptPhase {
+    double at_s{0.0};
+    LinkProfile up{};    // Client to server
+    LinkProfile down{};  // Server to client
+};
+
+/**
+ * @brief A timeline of link conditions.
+ *
+ * Text format, one setting per line, '#' starts a comment:
+ *
+ *     latency = 75          # both directions
+ *     down.loss = 0.05      # server to client only (up. for client to server)
+ *     at 10                 # from 10 s on, starting from the settings above
+ *     burst_enter = 0.02
+ *
+ * Keys are the LinkProfile fields. Each "at <seconds>" line starts a new phase that
+ * inherits the previous one; phases must be in increasing time order.
+ */
+class ProfileScript {
+public:
+    ProfileScript() : phases_(1) {}
+
+    const std::vector<ScriptPhase>& phases() const { return phases_; }
+
+    // The phase in effect `seconds` after the start.
+    std::size_t phase_at(double seconds) const {
+        std::size_t index = 0;
+        while (index + 1 < phases_.size() && phases_[index + 1].at_s <= seconds) {
+            ++index;
+        }
+        return index;
+    }
+
+    // Applies one line of the format above. On failure, returns false and sets `error`.
+    bool apply_line(std::string_view line, std::string& error) {
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            return true;
+        }
+        if (line.substr(0, 3) == "at " || line.substr(0, 3) == "at\t") {
+            const auto at = parse_double(trim(line.substr(3)));
+            if (!at || *at < 0.0 || *at <= phases_.back().at_s) {
+                error = "phase times must be increasing seconds: '" + std::string(line) + "'";
+                return false;
+            }
+            ScriptPhase next = phases_.back();
+            next.at_s = *at;
+            phases_.push_back(next);
+            return true;
+        }
+        const auto equals = line.find('=');
+        if (equals == std::string_view::npos) {
+            error = "expected 'key = value': '" + std::string(line) + "'";
+            return false;
+        }
+        return set(trim(line.substr(0, equals)), trim(line.substr(equals + 1)), error);
+    }
+
+    // Sets one key (optionally prefixed with up. or down.) in the newest phase.
+    bool set(std::string_view key, std::string_view text, std::string& error) {
+        auto& phase = phases_.back();
+        bool up = true;
+        bool down = true;
+        if (key.substr(0, 3) == "up.") {
+            down = false;
+            key.remove_prefix(3);
+        } else if (key.substr(0, 5) == "down.") {
+            up = false;
+            key.remove_prefix(5);
+        }
+        const auto value = parse_double(text);
+        double LinkProfile::*field = find_field(key);
+        if (field == nullptr) {
+            error = "unknown setting '" + std::string(key) + "'";
+            return false;
+        }
+        const bool probability = field != &LinkProfile::latency_ms && field != &LinkProfile::jitter_ms &&
+                                 field != &LinkProfile::reorder_ms;
+        if (!value || *value < 0.0 || (probability && *value > 1.0)) {
+            error = "invalid value for '" + std::string(key) + "': '" + std::string(text) + "'";
+            return false;
+        }
+        if (up) {
+            phase.up.*field = *value;
+        }
+        if (down) {
+            phase.down.*field = *value;
+        }
+        return true;
+    }
+
+    bool load(std::istream& in, std::string& error) {
+        std::string line;
+        std::size_t number = 0;
+        while (std::getline(in, line)) {
+            ++number;
+            if (!apply_line(line, error)) {
+                error = "line " + std::to_string(number) + ": " + error;
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    static double LinkProfile::*find_field(std::string_view key) {
+        struct Field {
+            std::string_view name;
+            double LinkProfile::*field;
+        };
+        static constexpr std::array<Field, 9> kFields{{
+            {"latency", &LinkProfile::latency_ms},
+            {"jitter", &LinkProfile::jitter_ms},
+            {"loss", &LinkProfile::loss},
+            {"burst_enter", &LinkProfile::burst_enter},
+            {"burst_exit", &LinkProfile::burst_exit},
+            {"burst_loss", &LinkProfile::burst_loss},
+            {"duplicate", &LinkProfile::duplicate},
+            {"reorder", &LinkProfile::reorder},
+            {"reorder_delay", &LinkProfile::reorder_ms},
+        }};
+        const auto it = std::find_if(kFields.begin(), kFields.end(), [&](const Field& f) { return f.name == key; });
+        return it != kFields.end() ? it->field : nullptr;
+    }
+
+    static std::string_view trim(std::string_view text) {
+        const auto first = text.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos) {
+            return {};
+        }
+        return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+    }
+
+    static std::optional<double> parse_double(std::string_view text) {
+        const std::string copy(text);
+        char* end = nullptr;
+        const double value = std::strtod(copy.c_str(), &end);
+        if (copy.empty() || end != copy.c_str() + copy.size()) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    std::vector<ScriptPhase> phases_;
+};
+
+}  // namespace netsim
@@ -0,0 +1,312 @@
+// UDP impairment proxy: sits between clients and rtype_server and degrades the link.
+//
+// Usage: rtype_netsim [--listen 4243] [--server 127.0.0.1:4242] [--config file] [--seed 1]
+//                     [--duration seconds] [--report seconds] [--<setting> value]...
+//
+// Clients connect to the listen port instead of the server. Every client gets its own
+// upstream socket, so the server still sees one endpoint per player, and its own pair
+// of ImpairedLinks seeded from --seed. Settings (see link_model.hpp) come from the
+// command line and the --config script; command-line ones act as lines at the top of
+// the script, e.g. `--latency 75 --loss 0.05` is 150 ms RTT with 5% loss each way.
+
+#include <asio.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "engine/net/packet.hpp"
+#include "engine/net/udp_socket.hpp"
+#include "link_model.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using udp = asio::ip::udp;
+
+constexpr std::chrono::seconds kSessionTimeout{30};
+constexpr std::chrono::milliseconds kMaxSleep{1};
+
+struct Options {
+    std::uint16_t listen_port{4243};
+    std::string server_host{"127.0.0.1"};
+    std::uint16_t server_port{4242};
+    std::uint32_t seed{1};
+    double duration_s{0.0};  // 0: run until killed
+    double report_s{5.0};
+    netsim::ProfileScript script;
+};
+
+struct Session {
+    std::uint32_t id{0};
+    std::unique_ptr<engine::net::UdpSocket> upstream;
+    netsim::ImpairedLink up;
+    netsim::ImpairedLink down;
+    Clock::time_point last_seen{};
+};
+
+struct Pending {
+    double deliver_at_ms{0.0};
+    std::uint64_t order{0};  // Ties keep arrival order
+    std::uint32_t session{0};
+    bool to_server{false};
+    std::vector<std::uint8_t> bytes;
+
+    bool operator>(const Pending& other) const {
+        return deliver_at_ms != other.deliver_at_ms ? deliver_at_ms > other.deliver_at_ms : order > other.order;
+    }
+};
+
+std::optional<std::uint32_t> parse_number(const std::string& text, std::uint32_t max) {
+    char* end = nullptr;
+    const auto value = std::strtoul(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || value > max) {
+        return std::nullopt;
+    }
+    return static_cast<std::uint32_t>(value);
+}
+
+std::optional<Options> parse_options(int argc, char** argv) {
+    Options options;
+    std::string config;
+    std::string error;
+    for (int i = 1; i < argc; i += 2) {
+        const std::string flag = argv[i];
+        if (i + 1 >= argc || flag.rfind("--", 0) != 0) {
+            std::cerr << "[rtype_netsim] Expected '--option value', got '" << flag << "'\n";
+            return std::nullopt;
+        }
+        const std::string value = argv[i + 1];
+        std::optional<std::uint32_t> number;
+        if (flag == "--config") {
+            config = value;
+        } else if (flag == "--server") {
+            const auto colon = value.rfind(':');
+            options.server_host = value.substr(0, colon);
+            if (colon != std::string::npos) {
+                if (!(number = parse_number(value.substr(colon + 1), 65535))) {
+                    std::cerr << "[rtype_netsim] Invalid server port in '" << value << "'\n";
+                    return std::nullopt;
+                }
+                options.server_port = static_cast<std::uint16_t>(*number);
+            }
+        } else if (flag == "--listen" && (number = parse_number(value, 65535))) {
+            options.listen_port = static_cast<std::uint16_t>(*number);
+        } else if (flag == "--seed" && (number = parse_number(value, 0xFFFFFFFFu))) {
+            options.seed = *number;
+        } else if (flag == "--duration" && (number = parse_number(value, 86400))) {
+            options.duration_s = *number;
+        } else if (flag == "--report" && (number = parse_number(value, 3600))) {
+            options.report_s = *number;
+        } else if (!options.script.set(flag.substr(2), value, error)) {
+            std::cerr << "[rtype_netsim] " << error << "\n";
+            return std::nullopt;
+        }
+    }
+    if (!config.empty()) {
+        std::ifstream in(config);
+        if (!in) {
+            std::cerr << "[rtype_netsim] Cannot open config '" << config << "'\n";
+            return std::nullopt;
+        }
+        if (!options.script.load(in, error)) {
+            std::cerr << "[rtype_netsim] " << config << ": " << error << "\n";
+            return std::nullopt;
+        }
+    }
+    return options;
+}
+
+void print_profile(const char* direction, const netsim::LinkProfile& p) {
+    std::cout << "  " << direction << ": latency=" << p.latency_ms << "ms jitter=" << p.jitter_ms
+              << "ms loss=" << p.loss << " burst=" << p.burst_enter << "/" << p.burst_exit << "/" << p.burst_loss
+              << " duplicate=" << p.duplicate << " reorder=" << p.reorder << "@" << p.reorder_ms << "ms\n";
+}
+
+void print_stats(double elapsed_s, const std::map<udp::endpoint, Session>& sessions, const netsim::LinkStats& closed_up,
+                 const netsim::LinkStats& closed_down) {
+    netsim::LinkStats up = closed_up;
+    netsim::LinkStats down = closed_down;
+    for (const auto& [endpoint, session] : sessions) {
+        up.merge(session.up.stats());
+        down.merge(session.down.stats());
+    }
+    const auto line = [](const char* direction, const netsim::LinkStats& s) {
+        std::cout << " " << direction << " " << s.received << " in/" << s.dropped << " dropped/" << s.duplicated
+                  << " duplicated/" << s.reordered << " reordered";
+    };
+    std::cout << "[rtype_netsim] t=" << static_cast<std::uint64_t>(elapsed_s) << "s sessions=" << sessions.size();
+    line("up", up);
+    line("down", down);
+    std::cout << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto options = parse_options(argc, argv);
+    if (!options) {
+        return 2;
+    }
+
+    asio::io_context io;
+    std::error_code ec;
+    const auto server_address = asio::ip::make_address(options->server_host, ec);
+    if (ec) {
+        std::cerr << "[rtype_netsim] Invalid server address '" << options->server_host << "': " << ec.message() << "\n";
+        return 2;
+    }
+    const udp::endpoint server(server_address, options->server_port);
+
+    engine::net::UdpSocket listener(io);
+    try {
+        listener.bind(options->listen_port);
+    } catch (const std::exception& e) {
+        std::cerr << "[rtype_netsim] Cannot listen on UDP " << options->listen_port << ": " << e.what() << "\n";
+        return 1;
+    }
+    listener.native().non_blocking(true);
+
+    const auto& phases = options->script.phases();
+    std::cout << "[rtype_netsim] UDP " << options->listen_port << " -> " << server << " (seed " << options->seed
+              << ")\n";
+    for (const auto& phase : phases) {
+        std::cout << "[rtype_netsim] from " << phase.at_s << "s:\n";
+        print_profile("up  ", phase.up);
+        print_profile("down", phase.down);
+    }
+
+    std::map<udp::endpoint, Session> sessions;
+    std::priority_queue<Pending, std::vector<Pending>, std::greater<>> pending;
+    netsim::LinkStats closed_up;
+    netsim::LinkStats closed_down;
+    std::uint32_t next_session = 0;
+    std::uint64_t next_order = 0;
+    std::array<std::uint8_t, engine::net::kMaxPacketSize> buffer{};
+    std::array<double, 2> deliver_at{};
+
+    const auto start = Clock::now();
+    const auto report_interval =
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options->report_s));
+    auto next_report = start + report_interval;
+    std::size_t phase = 0;
+
+    const auto admit = [&](Session& session, bool to_server, std::size_t size, double now_ms) {
+        auto& link = to_server ? session.up : session.down;
+        const auto copies = link.admit(now_ms, deliver_at);
+        for (std::size_t i = 0; i < copies; ++i) {
+            pending.push(Pending{deliver_at[i], next_order++, session.id, to_server,
+                                 std::vector<std::uint8_t>(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(size))});
+        }
+    };
+
+    while (true) {
+        const auto now = Clock::now();
+        const double now_ms = std::chrono::duration<double, std::milli>(now - start).count();
+        const double elapsed_s = now_ms / 1000.0;
+        if (options->duration_s > 0.0 && elapsed_s >= options->duration_s) {
+            break;
+        }
+
+        if (const auto current = options->script.phase_at(elapsed_s); current != phase) {
+            phase = current;
+            std::cout << "[rtype_netsim] Phase " << phase << " at " << phases[phase].at_s << "s\n";
+            for (auto& [endpoint, session] : sessions) {
+                session.up.set_profile(phases[phase].up);
+                session.down.set_profile(phases[phase].down);
+            }
+        }
+
+        // Client -> proxy: find or open the client's session, then impair.
+        while (true) {
+            udp::endpoint sender;
+            const auto size = listener.native().receive_from(asio::buffer(buffer.data(), buffer.size()), sender, 0, ec);
+            if (ec) {
+                break;
+            }
+            auto it = sessions.find(sender);
+            if (it == sessions.end()) {
+                const auto id = next_session++;
+                Session session{id, std::make_unique<engine::net::UdpSocket>(io),
+                                netsim::ImpairedLink(options->seed + 2 * id),
+                                netsim::ImpairedLink(options->seed + 2 * id + 1), now};
+                session.upstream->bind(0);
+                session.upstream->native().non_blocking(true);
+                session.up.set_profile(phases[phase].up);
+                session.down.set_profile(phases[phase].down);
+                it = sessions.emplace(sender, std::move(session)).first;
+                std::cout << "[rtype_netsim] Session " << id << " for " << sender << "\n";
+            }
+            it->second.last_seen = now;
+            admit(it->second, true, size, now_ms);
+        }
+
+        // Server -> proxy, per session.
+        for (auto& [endpoint, session] : sessions) {
+            while (true) {
+                udp::endpoint sender;
+                const auto size =
+                    session.upstream->native().receive_from(asio::buffer(buffer.data(), buffer.size()), sender, 0, ec);
+                if (ec) {
+                    break;
+                }
+                admit(session, false, size, now_ms);
+            }
+        }
+
+        // Deliver everything that is due.
+        while (!pending.empty() && pending.top().deliver_at_ms <= now_ms) {
+            const auto& due = pending.top();
+            const auto it = std::find_if(sessions.begin(), sessions.end(),
+                                         [&](const auto& entry) { return entry.second.id == due.session; });
+            if (it != sessions.end()) {
+                const auto data = asio::buffer(due.bytes.data(), due.bytes.size());
+                if (due.to_server) {
+                    it->second.upstream->native().send_to(data, server, 0, ec);
+                } else {
+                    listener.native().send_to(data, it->first, 0, ec);
+                }
+            }
+            pending.pop();
+        }
+
+        for (auto it = sessions.begin(); it != sessions.end();) {
+            if (now - it->second.last_seen > kSessionTimeout) {
+                std::cout << "[rtype_netsim] Session " << it->second.id << " timed out\n";
+                closed_up.merge(it->second.up.stats());
+                closed_down.merge(it->second.down.stats());
+                it = sessions.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (options->report_s > 0.0 && now >= next_report) {
+            print_stats(elapsed_s, sessions, closed_up, closed_down);
+            next_report += report_interval;
+        }
+
+        auto wake = now + kMaxSleep;
+        if (!pending.empty()) {
+            const auto due = start + std::chrono::duration_cast<Clock::duration>(
+                                         std::chrono::duration<double, std::milli>(pending.top().deliver_at_ms));
+            wake = std::min(wake, due);
+        }
+        std::this_thread::sleep_until(wake);
+    }
+
+    print_stats(std::chrono::duration<double>(Clock::now() - start).count(), sessions, closed_up, closed_down);
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "client_registry.hpp"
+
+#include <algorithm>
+
+namespace server {
+
+EndpointKey endpoint_key(const asio::ip::udp::endpoint& endpoint) {
+    const auto address = endpoint.address();
+    if (address.is_v4()) {
+        return (static_cast<EndpointKey>(address.to_v4().to_uint()) << 16) | endpoint.port();
+    }
+    // FNV-1a over the IPv6 bytes, then the port.
+    EndpointKey hash = 0xcbf29ce484222325ull;
+    for (const auto byte : address.to_v6().to_bytes()) {
+        hash = (hash ^ byte) * 0x100000001b3ull;
+    }
+    hash = (hash ^ (endpoint.port() & 0xFFu)) * 0x100000001b3ull;
+    hash = (hash ^ (endpoint.port() >> 8)) * 0x100000001b3ull;
+    return hash;
+}
+
+ClientRegistry::ClientRegistry()
+    : table_(std::make_shared<const Table>()) {}
+
+std::shared_ptr<const ClientRegistry::Table> ClientRegistry::snapshot() const {
+    return std::atomic_load_explicit(&table_, std::memory_order_acquire);
+}
+
+ClientRegistry::ClientPtr ClientRegistry::find(EndpointKey key) const {
+    const auto table = snapshot();
+    const auto it = table->find(key);
+    return it != table->end() ? it->second : nullptr;
+}
+
+ClientRegistry::ClientPtr ClientRegistry::insert(EndpointKey key, ClientPtr client) {
+    std::scoped_lock lock(write_mutex_);
+    const auto current = std::atomic_load_explicit(&table_, std::memory_order_acquire);
+    if (const auto it = current->find(key); it != current->end()) {
+        return it->second;
+    }
+    auto next = std::make_shared<Table>(*current);
+    next->emplace(key, client);
+    std::atomic_store_explicit(&table_, std::shared_ptr<const Table>(std::move(next)), std::memory_order_release);
+    return client;
+}
+
+std::vector<ClientRegistry::ClientPtr> ClientRegistry::remove_if(
+    const std::function<bool(const ClientInfo&)>& predicate) {
+    std::vector<ClientPtr> removed;
+    std::scoped_lock lock(write_mutex_);
+    const auto current = std::atomic_load_explicit(&table_, std::memory_order_acquire);
+    // Evaluate once per client: last_seen keeps moving while we copy.
+    for (const auto& [key, client] : *current) {
+        if (predicate(*client)) {
+            removed.push_back(client);
+        }
+    }
+    // Nobody left (the usual case, every second): keep the table and allocate nothing.
+    if (removed.empty()) {
+        return removed;
+    }
+    auto next = std::make_shared<Table>();
+    next->reserve(current->size() - removed.size());
+    for (const auto& [key, client] : *current) {
+        if (std::find(removed.begin(), removed.end(), client) == removed.end()) {
+            next->emplace(key, client);
+        }
+    }
+    std::atomic_store_explicit(&table_, std::shared_ptr<const Table>(std::move(next)), std::memory_order_release);
+    return removed;
+}
+
+std::size_t ClientRegistry::size() const {
+    return snapshot()->size();
+}
+
+}  // namespace server
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <asio.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "engine/net/reliable_channel.hpp"
+#include "engine/net/send_rate.hpp"
+
+namespace server {
+
+// Compact identity of a remote UDP endpoint. IPv4 endpoints map 1:1
+// (address << 16 | port); IPv6 endpoints are hashed.
+using EndpointKey = std::uint64_t;
+
+EndpointKey endpoint_key(const asio::ip::udp::endpoint& endpoint);
+
+struct ClientInfo {
+    // Immutable once the client is published in the registry.
+    std::uint16_t id{0};
+    asio::ip::udp::endpoint endpoint;
+    std::uint16_t room_id{0};  // Match this client plays in
+    bool compress_snapshots{false};  // Accepted kFeatureSnapshotCompression in the Welcome
+
+    // Updated by the listener thread on every packet, read by the game and maintenance threads.
+    std::atomic<std::chrono::steady_clock::rep> last_seen{0};
+    std::atomic<std::uint32_t> last_processed_input{0};  // Last input sequence processed for this client
+    std::atomic<std::uint32_t> acked_tick{0};  // Newest snapshot tick acknowledged (0 = none), delta baseline
+    std::uint32_t newest_input{0};  // Listener thread only: newest input sequence forwarded to the room
+
+    // Game events to this client: queued and flushed by the room's tick thread, acked by the listener.
+    std::mutex events_mutex;
+    engine::net::ReliableChannel events;
+
+    // Every datagram to this client takes the next sequence, so the client can count what it lost.
+    std::atomic<std::uint32_t> next_sequence{0};
+    // Snapshot rate: the listener feeds Ping reports to the controller and publishes its decision.
+    engine::net::SendRateController rate_controller;  // Listener thread only
+    std::atomic<std::uint8_t> send_interval{1};
+    std::atomic<std::uint8_t> budget_percent{100};
+    // Thread that sends the room's snapshots only (the tick thread inline, the snapshot thread when pipelined).
+    std::uint32_t ticks_since_snapshot{0};
+
+    // Traffic and link quality, for the metrics endpoint. Loss and RTT are the listener's
+    // copy of the rate controller's estimates, refreshed on every Ping report.
+    std::atomic<std::uint64_t> datagrams_received{0};
+    std::atomic<std::uint64_t> bytes_received{0};
+    std::atomic<std::uint64_t> datagrams_sent{0};
+    std::atomic<std::uint64_t> bytes_sent{0};
+    std::atomic<float> loss{0.f};
+    std::atomic<float> rtt_ms{0.f};
+
+    std::uint32_t take_sequence() { return next_sequence.fetch_add(1, std::memory_order_relaxed); }
+    void count_sent(std::size_t datagrams, std::size_t bytes) {
+        datagrams_sent.fetch_add(datagrams, std::memory_order_relaxed);
+        bytes_sent.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    engine::net::SendRate send_rate() const {
+        return {send_interval.load(std::memory_order_relaxed), budget_percent.load(std::memory_order_relaxed)};
+    }
+
+    void touch(std::chrono::steady_clock::time_point now) {
+        last_seen.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+    std::chrono::steady_clock::time_point last_seen_at() const {
+        return std::chrono::steady_clock::time_point(
+            std::chrono::steady_clock::duration(last_seen.load(std::memory_order_relaxed)));
+    }
+};
+
+/**
+ * @brief Client table shared by the listener, maintenance and game threads.
+ *
+ * Copy-on-write (RCU style): readers take an immutable snapshot of the table with
+ * a single atomic load and may iterate it for as long as they like; writers
+ * (joins and timeouts, both rare) copy the table under a mutex and publish the
+ * new version atomically. Broadcasts therefore never block packet intake, and
+ * a client removed mid-broadcast stays alive until the last snapshot holding it
+ * is released.
+ *
+ * The table pointer goes through the std::atomic_load/atomic_store overloads for
+ * shared_ptr rather than std::atomic<std::shared_ptr>, which libc++ lacks.
+ */
+class ClientRegistry {
+public:
+    using ClientPtr = std::shared_ptr<ClientInfo>;
+    using Table = std::unordered_map<EndpointKey, ClientPtr>;
+
+    ClientRegistry();
+
+    // Immutable view of the current clients.
+    std::shared_ptr<const Table> snapshot() const;
+
+    ClientPtr find(EndpointKey key) const;
+
+    // Publishes `client` under `key`. If the key is already present, the existing
+    // client is kept and returned instead.
+    ClientPtr insert(EndpointKey key, ClientPtr client);
+
+    // Removes every client matching `predicate` and returns them.
+    std::vector<ClientPtr> remove_if(const std::function<bool(const ClientInfo&)>& predicate);
+
+    std::size_t size() const;
+
+private:
+    std::shared_ptr<const Table> table_;  // Only through std::atomic_load/atomic_store
+    std::mutex write_mutex_;
+};
+
+}  // namespace server
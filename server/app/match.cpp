@@ -0,0 +1,547 @@
+#include "match.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "engine/game/components/core/position.hpp"
+#include "engine/game/components/core/velocity.hpp"
+#include "engine/game/components/gameplay/faction.hpp"
+#include "engine/game/components/gameplay/input_state.hpp"
+#include "engine/game/components/gameplay/health.hpp"
+#include "engine/game/components/gameplay/lives.hpp"
+#include "engine/game/components/gameplay/collider.hpp"
+#include "engine/game/components/gameplay/game_stats.hpp"
+#include "engine/game/components/gameplay/killer.hpp"
+#include "engine/game/components/gameplay/projectile.hpp"
+#include "engine/game/components/gameplay/spectator.hpp"
+#include "engine/game/components/gameplay/ultimate_charge.hpp"
+#include "engine/game/components/gameplay/ultimate_projectile.hpp"
+#include "engine/game/components/gameplay/enemy_type.hpp"
+#include "engine/game/components/gameplay/boss_phase.hpp"
+#include "engine/game/components/network/owner.hpp"
+#include "engine/game/systems/gameplay/health_system.hpp"
+
+namespace server {
+
+namespace {
+constexpr std::size_t kRequiredPlayers = 1;  // Start game with 1 player, but allow joining anytime
+constexpr float kDeltaTime = 1.0f / static_cast<float>(NetworkServer::kTickRate);
+constexpr std::uint16_t kMaxLevel = 5;  // Final Boss
+}  // namespace
+
+Match::Match(std::uint16_t room_id, RoomLink& link, const MatchOptions& options)
+    : room_id_(room_id),
+      link_(link),
+      random_(options.seed),
+      enemy_spawn_system_(random_.stream(engine::game::RandomStreamId::EnemySpawn)),
+      enemy_shooting_system_(random_.stream(engine::game::RandomStreamId::EnemyShooting)),
+      lava_drop_spawn_system_(random_.stream(engine::game::RandomStreamId::LavaDropSpawn)),
+      asteroid_spawn_system_(random_.stream(engine::game::RandomStreamId::AsteroidSpawn)),
+      ice_enemy_spawn_system_(random_.stream(engine::game::RandomStreamId::IceEnemySpawn)),
+      boss_behavior_system_(random_.stream(engine::game::RandomStreamId::BossBehavior)),
+      pipelined_snapshots_(options.pipelined_snapshots) {
+    // Register all component types used by the server
+    registry_.register_component<engine::game::components::Position>();
+    registry_.register_component<engine::game::components::Velocity>();
+    registry_.register_component<engine::game::components::InputState>();
+    registry_.register_component<engine::game::components::FactionComponent>();
+    registry_.register_component<engine::game::components::Collider>();
+    registry_.register_component<engine::game::components::Health>();
+    registry_.register_component<engine::game::components::Lives>();
+    registry_.register_component<engine::game::components::Owner>();
+    registry_.register_component<engine::game::components::GameStats>();
+    registry_.register_component<engine::game::components::Killer>();
+    registry_.register_component<engine::game::components::EnemyTypeComponent>();
+    registry_.register_component<engine::game::components::BossPhase>();
+    registry_.register_component<engine::game::components::Spectator>();
+    registry_.register_component<engine::game::components::UltimateCharge>();
+    registry_.register_component<engine::game::components::UltimateProjectile>();
+
+    if (options.settings) {
+        settings_ = *options.settings;
+    } else {
+        settings_.load_from_file();
+    }
+    if (!options.record_path.empty()) {
+        recorder_ = std::make_unique<ReplayWriter>(
+            options.record_path, ReplayHeader{.room_id = room_id_, .seed = options.seed, .settings = settings_});
+        if (recorder_->is_open()) {
+            std::cout << "[room " << room_id_ << "] Recording to " << options.record_path << "\n";
+        } else {
+            std::cerr << "[room " << room_id_ << "] Cannot record to " << options.record_path << "\n";
+            recorder_.reset();
+        }
+    }
+
+    // Game stats entity (score, wave, level progression)
+    reset_stats(1);
+
+    // Enable debug logging for first few ticks to verify it works
+    network_send_system_.set_debug_logging(true);
+}
+
+void Match::reset_stats(std::uint16_t level) {
+    stats_entity_ = registry_.spawn_entity();
+    const auto& config = level_manager_.getLevelConfig(level);
+    registry_.emplace_component<engine::game::components::GameStats>(stats_entity_, 0u, 1u);
+    if (auto* game_stats = registry_.try_get<engine::game::components::GameStats>(stats_entity_)) {
+        game_stats->current_level = level;
+        game_stats->kills_this_level = 0;
+        game_stats->kills_to_next_level = config.kills_required;
+        game_stats->total_kills = 0;
+    }
+    previous_total_kills_ = 0;
+}
+
+void Match::spawn_player(std::uint16_t player_id, float spawn_y) {
+    auto entity = registry_.spawn_entity();
+    auto entity_id = static_cast<std::uint16_t>(entity);
+
+    registry_.emplace_component<engine::game::components::Position>(entity, 100.f, spawn_y);
+    registry_.emplace_component<engine::game::components::Velocity>(entity, 0.f, 0.f);
+    registry_.emplace_component<engine::game::components::InputState>(entity);
+    registry_.emplace_component<engine::game::components::FactionComponent>(
+        entity, engine::game::components::Faction::PLAYER
+    );
+    registry_.emplace_component<engine::game::components::Collider>(entity, 32.f, 32.f, false);
+    registry_.emplace_component<engine::game::components::Health>(entity, 100, 100);
+    registry_.emplace_component<engine::game::components::Lives>(
+        entity,
+        std::max(0, settings_.player_lives),
+        std::max(0, settings_.player_lives));
+    registry_.emplace_component<engine::game::components::UltimateCharge>(entity);
+    registry_.emplace_component<engine::game::components::Owner>(entity, player_id);
+
+    input_system_.register_player_entity(player_id, entity_id);
+
+    std::cout << "[room " << room_id_ << "] Spawned player #" << player_id
+              << " as entity #" << entity_id << "\n";
+}
+
+void Match::emit(rtype::game::GameEvent event) {
+    event.tick = tick_;
+    rtype::game::encode_game_event(event, event_bytes_);
+    link_.send_event(event_bytes_);
+}
+
+void Match::handle_event(const PlayerEvent& event) {
+    switch (event.kind) {
+        case PlayerEvent::Kind::Joined:
+            on_player_joined(event);
+            break;
+        case PlayerEvent::Kind::Left:
+            on_player_left(event.player_id);
+            break;
+    }
+}
+
+void Match::on_player_joined(const PlayerEvent& event) {
+    std::cout << "[room " << room_id_ << "] Player #" << event.player_id << " connected (requested level "
+              << event.start_level << ", difficulty " << static_cast<int>(event.difficulty) << ")\n";
+    connected_players_.insert(event.player_id);
+
+    // Apply difficulty to game settings
+    settings_.difficulty = event.difficulty;
+
+    // If this is the first player, set the game level
+    if (!game_started_ && connected_players_.size() == 1) {
+        auto new_config = level_manager_.getLevelConfig(event.start_level);
+        if (auto* game_stats = registry_.try_get<engine::game::components::GameStats>(stats_entity_)) {
+            game_stats->current_level = event.start_level;
+            game_stats->kills_this_level = 0;
+            game_stats->kills_to_next_level = new_config.kills_required;
+            std::cout << "[room " << room_id_ << "] Game level set to " << event.start_level << "\n";
+        }
+    }
+
+    // If game already started, spawn player immediately
+    if (game_started_) {
+        game_paused_ = false;  // Unpause the game when a player joins
+        // Offset spawn position based on number of players
+        spawn_player(event.player_id, 540.f - (static_cast<float>(connected_players_.size() - 1) * 80.f));
+    }
+}
+
+void Match::on_player_left(std::uint16_t player_id) {
+    std::cout << "[room " << room_id_ << "] Player #" << player_id << " disconnected\n";
+    connected_players_.erase(player_id);
+    input_system_.remove_player(player_id, registry_);
+
+    // If all players disconnect, reset the game
+    if (connected_players_.empty() && game_started_) {
+        std::cout << "[room " << room_id_ << "] All players disconnected. Resetting game...\n";
+
+        // Clear all game entities, then recreate the stats entity with the initial level config
+        registry_.clear();
+        level_manager_.reset();
+        reset_stats(1);
+        game_over_system_.reset();
+        game_over_announced_ = false;
+        boss_phase_ = 0;
+
+        game_started_ = false;
+        game_paused_ = false;
+        std::cout << "[room " << room_id_ << "] Game reset complete. Waiting for players...\n";
+    }
+}
+
+void Match::start_game() {
+    std::cout << "[room " << room_id_ << "] Required players reached. Starting game!\n";
+    std::uint16_t player_index = 0;
+    for (auto player_id : connected_players_) {
+        // Offset each player's Y position so they don't overlap
+        spawn_player(player_id, 540.f - (player_index * 80.f));
+        ++player_index;
+    }
+    game_started_ = true;
+}
+
+void Match::tick() {
+    const auto started = std::chrono::steady_clock::now();
+    system_times_.fill({});
+    step();
+    if (population_countdown_-- == 0) {
+        population_countdown_ = kPopulationInterval - 1;
+        publish_population();
+    }
+    metrics_.record_tick(std::chrono::steady_clock::now() - started, system_times_);
+    if (recorder_) {
+        recorder_->end_frame(frame_);
+    }
+    ++frame_;
+}
+
+std::uint64_t Match::state_checksum() {
+    // FNV-1a over the replicated gameplay state, entity by entity.
+    std::uint64_t hash = 0xCBF29CE484222325ull;
+    const auto mix = [&hash](std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash = (hash ^ ((value >> (8 * i)) & 0xFF)) * 0x100000001B3ull;
+        }
+    };
+    const auto bits = [](float value) {
+        std::uint32_t out = 0;
+        std::memcpy(&out, &value, sizeof(out));
+        return out;
+    };
+    registry_.view<engine::game::components::Position>([&](std::size_t eid, const auto& pos) {
+        mix(eid);
+        mix((static_cast<std::uint64_t>(bits(pos.x)) << 32) | bits(pos.y));
+    });
+    registry_.view<engine::game::components::Health>([&](std::size_t eid, const auto& health) {
+        mix(eid);
+        mix(static_cast<std::uint64_t>(static_cast<std::int64_t>(health.current)));
+    });
+    registry_.view<engine::game::components::Lives>([&](std::size_t eid, const auto& lives) {
+        mix(eid);
+        mix(static_cast<std::uint64_t>(static_cast<std::int64_t>(lives.remaining)));
+    });
+    registry_.view<engine::game::components::GameStats>([&](std::size_t, const auto& stats) {
+        mix(stats.score);
+        mix(stats.total_kills);
+        mix(stats.current_level);
+    });
+    mix(tick_);
+    return hash;
+}
+
+void Match::publish_population() {
+    std::array<std::uint32_t, kFactionNames.size()> entities{};
+    registry_.view<engine::game::components::FactionComponent>(
+        [&](std::size_t, const engine::game::components::FactionComponent& faction) {
+            const auto index = static_cast<std::size_t>(faction.faction_value);
+            if (index < entities.size()) {
+                ++entities[index];
+            }
+        });
+    metrics_.set_population(entities, static_cast<std::uint32_t>(connected_players_.size()), game_started_);
+}
+
+void Match::step() {
+    timed(TimedSystem::Events, [&] {
+        while (auto event = link_.poll_event()) {
+            if (recorder_) {
+                recorder_->event(frame_, *event);
+            }
+            handle_event(*event);
+        }
+    });
+
+    // =========================
+    // LOBBY CHECK
+    // =========================
+    if (!game_started_) {
+        if (connected_players_.size() >= kRequiredPlayers) {
+            start_game();
+        }
+        return;  // IMPORTANT: skip gameplay systems
+    }
+
+    // =========================
+    // INPUT
+    // =========================
+    timed(TimedSystem::Input, [&] { drain_inputs(); });
+
+    // Only run gameplay systems if not paused
+    if (!game_paused_) {
+        run_gameplay();
+    }
+    update_level_progression();
+
+    // Remember enemy colliders as this tick's snapshot shows them, for lag-compensated hits
+    timed(TimedSystem::History, [&] { collision_system_.record_history(registry_, tick_); });
+
+    // Read the world out once; send_snapshot() encodes it, here or on the snapshot thread
+    timed(TimedSystem::Snapshot, [&] {
+        network_send_system_.sample(registry_, tick_++, game_paused_, snapshots_.back());
+        if (snapshots_.publish(&rtype::game::NetworkSendSystem::fold)) {
+            metrics_.record_superseded_snapshot();
+        }
+    });
+    if (!pipelined_snapshots_) {
+        send_snapshot();
+    }
+    timed(TimedSystem::EventSend, [&] { link_.flush_events(); });
+}
+
+bool Match::send_snapshot() {
+    auto* capture = snapshots_.take();
+    if (capture == nullptr) {
+        return false;
+    }
+    // Send each client the highest-priority changes since the last tick it acknowledged
+    // that fit in its replication budget
+    const auto started = std::chrono::steady_clock::now();
+    network_send_system_.commit(*capture);
+    link_.broadcast_snapshot(
+        [this](std::uint16_t client_id, std::uint32_t acked_tick,
+               engine::net::SendRate rate) -> const engine::net::SnapshotMessage& {
+            return network_send_system_.snapshot_for(client_id, acked_tick, rate.budget_percent);
+        });
+    metrics_.record_broadcast(std::chrono::steady_clock::now() - started);
+    return true;
+}
+
+void Match::drain_inputs() {
+    while (auto cmd_opt = link_.poll_input()) {
+        constexpr std::uint16_t INPUT_PAUSE = 1 << 5;
+        auto& cmd = cmd_opt.value();
+        if (recorder_) {
+            recorder_->input(frame_, cmd);
+        }
+
+        if (cmd.input_mask & INPUT_PAUSE) {
+            game_paused_ = !game_paused_;
+            std::cout << "[room " << room_id_ << "] " << (game_paused_ ? "Paused\n" : "Resumed\n");
+            continue;  // Do not forward pause to gameplay
+        }
+
+        // The client saw snapshot view_tick when it sent this; tick_ is the one being simulated.
+        const std::uint32_t view_delay = (cmd.view_tick != 0 && cmd.view_tick < tick_) ? tick_ - cmd.view_tick : 0;
+        input_system_.set_player_input(
+            cmd.player_id,
+            cmd.input_mask,
+            cmd.sequence,
+            cmd.client_time_ms,
+            static_cast<std::uint8_t>(std::min<std::uint32_t>(view_delay, 0xFF))
+        );
+    }
+}
+
+void Match::run_gameplay() {
+    // Check game over condition first
+    timed(TimedSystem::Health, [&] { game_over_system_.run(registry_, kDeltaTime); });
+
+    // Only spawn enemies and process game logic if not game over
+    if (game_over_system_.is_game_over()) {
+        if (!game_over_announced_) {
+            game_over_announced_ = true;
+            emit({.type = rtype::game::GameEventType::GameOver});
+        }
+        return;
+    }
+
+    // Update level multipliers based on current level
+    if (auto* stats = registry_.try_get<engine::game::components::GameStats>(stats_entity_)) {
+        const auto& current_config = level_manager_.getLevelConfig(stats->current_level);
+        settings_.level_enemy_speed_mult = current_config.enemy_speed_multiplier;
+        settings_.level_enemy_hp_mult = current_config.enemy_hp_multiplier;
+        settings_.level_spawn_rate_mult = current_config.spawn_rate_multiplier;
+    }
+
+    // Input and core movement
+    timed(TimedSystem::Input, [&] { input_system_.update(registry_, kDeltaTime); });
+    timed(TimedSystem::Movement, [&] { movement_system_.run(registry_, kDeltaTime); });
+    timed(TimedSystem::Shooting, [&] {
+        shooting_system_.run(registry_, kDeltaTime, settings_);
+        ultimate_activation_system_.run(registry_);
+    });
+    timed(TimedSystem::Projectiles, [&] { projectile_system_.run(registry_, kDeltaTime); });
+    timed(TimedSystem::Collision, [&] { collision_system_.run(registry_, kDeltaTime); });
+
+    // Run health system which handles deaths and updates kill counts
+    timed(TimedSystem::Health, [&] { run_health(); });
+
+    // Update per-player kill counts in GameStats based on Killer component
+    if (auto* stats = registry_.try_get<engine::game::components::GameStats>(stats_entity_)) {
+        registry_.view<engine::game::components::FactionComponent, engine::game::components::Health>(
+            [&](std::size_t eid, auto& faction, auto& health) {
+                if (faction.faction_value == engine::game::components::Faction::ENEMY && health.current <= 0) {
+                    auto killer = registry_.try_get<engine::game::components::Killer>(
+                        registry_.entity_from_index(static_cast<rtype::ecs::entity_id_t>(eid)));
+                    if (killer && killer->player_id > 0) {
+                        stats->player_kills[killer->player_id]++;
+                    }
+                }
+            });
+    }
+
+    // Enemy behavior systems
+    timed(TimedSystem::Enemies, [&] {
+        enemy_shooting_system_.run(registry_, kDeltaTime, settings_);
+        movement_pattern_system_.run(registry_, kDeltaTime);
+    });
+
+    // Spawn systems based on level (and the boss, which spawns and drives itself)
+    SystemTimer spawn_timer(system_times_, TimedSystem::Spawning);
+    if (auto* stats = registry_.try_get<engine::game::components::GameStats>(stats_entity_)) {
+        if (stats->current_level == 5) {
+            // Level 5: Final Boss fight only
+            boss_spawn_system_.run(registry_, kDeltaTime, stats->current_level, settings_);
+            boss_behavior_system_.run(registry_, kDeltaTime, stats->current_level);
+            std::uint8_t phase = 0;
+            std::uint16_t boss_id = 0;
+            registry_.view<engine::game::components::BossPhase>([&](std::size_t eid, const auto& boss) {
+                phase = boss.current_phase;
+                boss_id = static_cast<std::uint16_t>(eid);
+            });
+            if (phase != boss_phase_ && phase != 0) {
+                emit({.type = rtype::game::GameEventType::BossPhase, .entity_id = boss_id, .value = phase});
+            }
+            boss_phase_ = phase;
+        } else if (stats->current_level == 4) {
+            // Level 4: Ice enemies only (no basic spawns)
+            ice_enemy_spawn_system_.run(registry_, kDeltaTime, stats->current_level, settings_);
+            lava_drop_spawn_system_.run(registry_, kDeltaTime, stats->current_level);
+        } else {
+            // Levels 1-3: Normal enemy spawning
+            enemy_spawn_system_.run(registry_, kDeltaTime, stats->current_level, settings_);
+            lava_drop_spawn_system_.run(registry_, kDeltaTime, stats->current_level);
+        }
+    }
+}
+
+void Match::run_health() {
+    // health_system removes dead enemies and turns dead players into respawns or spectators;
+    // note who is at 0 HP first so the kills and deaths can be announced.
+    dying_players_.clear();
+    registry_.view<engine::game::components::Health>([&](std::size_t eid, const auto& health) {
+        if (health.current > 0) {
+            return;
+        }
+        const auto entity = registry_.entity_from_index(static_cast<rtype::ecs::entity_id_t>(eid));
+        const auto* pos = registry_.try_get<engine::game::components::Position>(entity);
+        rtype::game::GameEvent event{
+            .entity_id = static_cast<std::uint16_t>(eid),
+            .x = pos ? pos->x : 0.f,
+            .y = pos ? pos->y : 0.f,
+        };
+        if (const auto* owner = registry_.try_get<engine::game::components::Owner>(entity)) {
+            // Spectators sit at 0 HP for good; infinite lives just refills it.
+            const auto* lives = registry_.try_get<engine::game::components::Lives>(entity);
+            if (settings_.infinite_lives || registry_.try_get<engine::game::components::Spectator>(entity) ||
+                (lives && lives->remaining <= 0)) {
+                return;
+            }
+            event.type = rtype::game::GameEventType::PlayerDied;
+            event.player_id = owner->player_id;
+            dying_players_.push_back(event);
+            return;
+        }
+        const auto* faction = registry_.try_get<engine::game::components::FactionComponent>(entity);
+        if (faction && faction->faction_value == engine::game::components::Faction::ENEMY) {
+            const auto* killer = registry_.try_get<engine::game::components::Killer>(entity);
+            event.type = rtype::game::GameEventType::EnemyKilled;
+            event.player_id = killer ? killer->player_id : std::uint16_t{0};
+            emit(event);
+            network_send_system_.note_despawn(event.entity_id, rtype::game::DespawnReason::Killed);
+        }
+    });
+
+    engine::game::systems::health_system(registry_, settings_);
+
+    for (auto& event : dying_players_) {
+        const auto entity = registry_.entity_from_index(event.entity_id);
+        if (const auto* lives = registry_.try_get<engine::game::components::Lives>(entity)) {
+            event.value = static_cast<std::uint16_t>(std::max(0, lives->remaining));
+        }
+        emit(event);
+    }
+}
+
+void Match::update_level_progression() {
+    // Check level progression based on GameStats (updated by health_system)
+    auto* stats = registry_.try_get<engine::game::components::GameStats>(stats_entity_);
+    if (!stats) {
+        return;
+    }
+
+    // Check if we should advance to next level (but not beyond the Final Boss)
+    if (stats->kills_this_level >= stats->kills_to_next_level && stats->current_level < kMaxLevel) {
+        const auto& next_config = level_manager_.getLevelConfig(stats->current_level + 1);
+
+        // Clear all enemies and projectiles when changing level
+        std::vector<rtype::ecs::entity_t> entities_to_remove;
+        registry_.view<engine::game::components::FactionComponent>(
+            [&](std::size_t eid, auto& faction) {
+                if (faction.faction_value == engine::game::components::Faction::ENEMY ||
+                    faction.faction_value == engine::game::components::Faction::HAZARD) {
+                    entities_to_remove.push_back(
+                        registry_.entity_from_index(static_cast<rtype::ecs::entity_id_t>(eid)));
+                }
+            });
+
+        // Also remove enemy projectiles
+        registry_.view<engine::game::components::Projectile, engine::game::components::FactionComponent>(
+            [&](std::size_t eid, auto& /*proj*/, auto& faction) {
+                if (faction.faction_value == engine::game::components::Faction::ENEMY) {
+                    auto entity = registry_.entity_from_index(static_cast<rtype::ecs::entity_id_t>(eid));
+                    if (std::find(entities_to_remove.begin(), entities_to_remove.end(), entity) == entities_to_remove.end()) {
+                        entities_to_remove.push_back(entity);
+                    }
+                }
+            });
+
+        for (const auto& entity : entities_to_remove) {
+            network_send_system_.note_despawn(static_cast<std::uint16_t>(entity), rtype::game::DespawnReason::Cleared);
+            registry_.kill_entity(entity);
+        }
+
+        std::cout << "[room " << room_id_ << "] Level transition: cleared " << entities_to_remove.size()
+                  << " entities" << std::endl;
+
+        // Advance level
+        stats->current_level++;
+        stats->kills_this_level = 0;  // Reset kills for new level
+        stats->kills_to_next_level = next_config.kills_required;
+        stats->wave = stats->current_level;
+        emit({.type = rtype::game::GameEventType::LevelUp, .value = stats->current_level});
+
+        std::cout << "[room " << room_id_ << "] LEVEL UP! Now at Level " << stats->current_level
+                  << " (need " << stats->kills_to_next_level << " kills)" << std::endl;
+    }
+
+    // Add points for newly killed enemies (100 points per kill)
+    // Score can also be decreased by collision_system when player takes damage
+    if (stats->total_kills > previous_total_kills_) {
+        std::uint16_t new_kills = stats->total_kills - previous_total_kills_;
+        stats->score += (new_kills * 100);
+        previous_total_kills_ = stats->total_kills;
+    }
+}
+
+}  // namespace server
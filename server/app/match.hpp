@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "engine/core/random.hpp"
+#include "engine/core/registry.hpp"
+#include "engine/game/game_settings.hpp"
+#include "engine/game/random_streams.hpp"
+#include "engine/game/systems/world/movement_system.hpp"
+#include "engine/game/systems/gameplay/shooting_system.hpp"
+#include "engine/game/systems/gameplay/projectile_system.hpp"
+#include "engine/game/systems/gameplay/ultimate_activation_system.hpp"
+#include "engine/game/systems/gameplay/collision_system.hpp"
+#include "engine/game/systems/gameplay/enemy_spawn_system.hpp"
+#include "engine/game/systems/gameplay/enemy_shooting_system.hpp"
+#include "engine/game/systems/gameplay/movement_pattern_system.hpp"
+#include "engine/game/systems/gameplay/game_over_system.hpp"
+#include "engine/game/systems/gameplay/level_manager.hpp"
+#include "engine/game/systems/gameplay/lava_drop_spawn_system.hpp"
+#include "engine/game/systems/gameplay/asteroid_spawn_system.hpp"
+#include "engine/game/systems/gameplay/ice_enemy_spawn_system.hpp"
+#include "engine/game/systems/gameplay/boss_spawn_system.hpp"
+#include "engine/game/systems/gameplay/boss_behavior_system.hpp"
+#include "engine/game/systems/network/game_events.hpp"
+#include "engine/game/systems/network/network_send_system.hpp"
+#include "engine/net/triple_buffer.hpp"
+#include "metrics.hpp"
+#include "replay.hpp"
+#include "room_link.hpp"
+#include "apply_input_system.hpp"
+
+namespace server {
+
+struct MatchOptions {
+    std::uint64_t seed{0};  // Key of the match's RandomSource: every gameplay random draw
+    const engine::game::GameSettings* settings{nullptr};  // nullptr: load the settings file
+    std::string record_path;  // Non-empty: record the match there for --replay
+    // tick() only samples the snapshot and leaves encoding and sending to send_snapshot()
+    // on another thread; otherwise tick() sends it too.
+    bool pipelined_snapshots{false};
+};
+
+/**
+ * @brief One independent match: its own registry, systems, settings and lobby.
+ *
+ * A match only talks to the network through its RoomLink (player events, inputs,
+ * snapshots and game events), so every method but send_snapshot() runs on the worker
+ * thread that owns the room; matches share nothing. Given the same seed, settings and
+ * polled events and inputs frame by frame, a match plays out identically, which is
+ * what replay files rely on.
+ *
+ * When pipelined, a tick ends once its snapshot is sampled: the sample goes through a
+ * triple buffer to the room's snapshot thread, which encodes and sends it while the
+ * next tick simulates. Only the newest sample is ever sent, as inline.
+ */
+class Match {
+public:
+    Match(std::uint16_t room_id, RoomLink& link, const MatchOptions& options = {});
+
+    Match(const Match&) = delete;
+    Match& operator=(const Match&) = delete;
+
+    // Runs one fixed step: joins/leaves, lobby, inputs, gameplay, snapshot.
+    void tick();
+    // Encodes and broadcasts the newest snapshot tick() sampled, if not sent yet. Called
+    // by tick() itself unless pipelined; then by one snapshot thread, concurrently with it.
+    // Returns false when there was nothing new.
+    bool send_snapshot();
+
+    std::uint16_t room_id() const { return room_id_; }
+    // Safe to read from any thread.
+    const MatchMetrics& metrics() const { return metrics_; }
+    // Hash of the simulated world (positions, health, lives, scores), to compare runs.
+    std::uint64_t state_checksum();
+
+private:
+    static constexpr std::uint32_t kPopulationInterval = 15;  // Ticks between entity counts
+
+    void step();
+    void publish_population();
+    template <typename Fn>
+    void timed(TimedSystem system, Fn&& fn) {
+        SystemTimer timer(system_times_, system);
+        std::forward<Fn>(fn)();
+    }
+    void handle_event(const PlayerEvent& event);
+    void drain_inputs();
+    void on_player_joined(const PlayerEvent& event);
+    void on_player_left(std::uint16_t player_id);
+    void spawn_player(std::uint16_t player_id, float spawn_y);
+    void reset_stats(std::uint16_t level);
+    void start_game();
+    void run_gameplay();
+    void update_level_progression();
+    void run_health();
+    // Stamps the current tick and queues the event to every client of the room.
+    void emit(rtype::game::GameEvent event);
+
+    std::uint16_t room_id_;
+    RoomLink& link_;
+    rtype::ecs::registry registry_;
+    engine::game::GameSettings settings_;
+    engine::core::RandomSource random_;  // Before the systems it hands streams to
+
+    server::systems::ApplyInputSystem input_system_;
+    rtype::game::MovementSystem movement_system_;
+    rtype::game::ShootingSystem shooting_system_;
+    rtype::game::ProjectileSystem projectile_system_;
+    rtype::game::CollisionSystem collision_system_;
+    rtype::game::UltimateActivationSystem ultimate_activation_system_;
+    rtype::game::EnemySpawnSystem enemy_spawn_system_;
+    rtype::game::EnemyShootingSystem enemy_shooting_system_;
+    rtype::game::MovementPatternSystem movement_pattern_system_;
+    rtype::game::NetworkSendSystem network_send_system_;
+    rtype::game::GameOverSystem game_over_system_;
+    rtype::game::LevelManager level_manager_;
+    rtype::game::LavaDropSpawnSystem lava_drop_spawn_system_;
+    rtype::game::AsteroidSpawnSystem asteroid_spawn_system_;
+    rtype::game::IceEnemySpawnSystem ice_enemy_spawn_system_;
+    rtype::game::BossSpawnSystem boss_spawn_system_;
+    rtype::game::BossBehaviorSystem boss_behavior_system_;
+
+    rtype::ecs::entity_t stats_entity_{0};
+    std::uint16_t previous_total_kills_ = 0;  // Track kills to know when new kills happen
+
+    // Lobby state
+    bool game_started_ = false;
+    bool game_paused_ = false;
+    std::unordered_set<std::uint16_t> connected_players_;
+    std::uint32_t tick_ = 0;
+
+    // Event detection
+    bool game_over_announced_ = false;
+    std::uint8_t boss_phase_ = 0;  // 0 = no boss
+    std::vector<rtype::game::GameEvent> dying_players_;  // PlayerDied events waiting for the lives count
+    std::vector<std::uint8_t> event_bytes_;
+
+    MatchMetrics metrics_;
+    SystemTimes system_times_{};  // This tick's, added to metrics_ at its end
+    std::uint32_t population_countdown_{0};
+
+    bool pipelined_snapshots_;
+    // Tick thread samples into back(), send_snapshot() takes and commits.
+    engine::net::TripleBuffer<rtype::game::NetworkSendSystem::Capture> snapshots_;
+
+    std::uint64_t frame_{0};  // tick() calls so far, lobby included: the replay timeline
+    std::unique_ptr<ReplayWriter> recorder_;
+};
+
+}  // namespace server
@@ -0,0 +1,142 @@
+#include "metrics.hpp"
+
+#include <sstream>
+#include <vector>
+
+#include "network_server.hpp"
+#include "room_manager.hpp"
+
+namespace server {
+
+namespace {
+
+// Upper bounds of the exported tick time histogram buckets, in milliseconds.
+constexpr std::array<double, 9> kTickBucketsMs{0.25, 0.5, 1, 2, 4, 8, 12, 16.667, 33.333};
+
+double seconds(std::chrono::nanoseconds value) {
+    return std::chrono::duration<double>(value).count();
+}
+
+void header(std::ostringstream& out, const char* name, const char* type, const char* help) {
+    out << "# HELP " << name << ' ' << help << "\n# TYPE " << name << ' ' << type << '\n';
+}
+
+}  // namespace
+
+std::string render_metrics(const RoomManager& rooms, const NetworkServer& server) {
+    std::ostringstream out;
+
+    header(out, "rtype_worker_ticks_total", "counter", "Ticks run by each worker thread.");
+    for (std::size_t w = 0; w < rooms.worker_count(); ++w) {
+        out << "rtype_worker_ticks_total{worker=\"" << w << "\"} "
+            << rooms.worker_metrics(w).ticks.load(std::memory_order_relaxed) << '\n';
+    }
+    header(out, "rtype_worker_overruns_total", "counter", "Ticks that ended after the next one was due.");
+    for (std::size_t w = 0; w < rooms.worker_count(); ++w) {
+        out << "rtype_worker_overruns_total{worker=\"" << w << "\"} "
+            << rooms.worker_metrics(w).overruns.load(std::memory_order_relaxed) << '\n';
+    }
+    header(out, "rtype_worker_skipped_ticks_total", "counter", "Ticks dropped by the overrun policy.");
+    for (std::size_t w = 0; w < rooms.worker_count(); ++w) {
+        out << "rtype_worker_skipped_ticks_total{worker=\"" << w << "\"} "
+            << rooms.worker_metrics(w).skipped.load(std::memory_order_relaxed) << '\n';
+    }
+
+    std::vector<RoomMetrics> room_metrics;
+    room_metrics.reserve(rooms.room_count());
+    for (std::size_t r = 0; r < rooms.room_count(); ++r) {
+        room_metrics.push_back(rooms.match(r).metrics().read());
+    }
+
+    header(out, "rtype_room_tick_seconds", "histogram",
+           "Duration of a room's tick, event sends included and snapshot sends when inline.");
+    for (std::size_t r = 0; r < room_metrics.size(); ++r) {
+        const auto& histogram = room_metrics[r].tick_time;
+        for (const double bound : kTickBucketsMs) {
+            const auto bound_ns = std::chrono::nanoseconds(static_cast<std::int64_t>(bound * 1e6));
+            out << "rtype_room_tick_seconds_bucket{room=\"" << r << "\",le=\"" << bound / 1000.0 << "\"} "
+                << histogram.count_at_most(bound_ns) << '\n';
+        }
+        out << "rtype_room_tick_seconds_bucket{room=\"" << r << "\",le=\"+Inf\"} " << histogram.count() << '\n'
+            << "rtype_room_tick_seconds_sum{room=\"" << r << "\"} " << seconds(histogram.sum()) << '\n'
+            << "rtype_room_tick_seconds_count{room=\"" << r << "\"} " << histogram.count() << '\n';
+    }
+    header(out, "rtype_room_tick_p99_seconds", "gauge", "99th percentile tick duration since startup.");
+    for (std::size_t r = 0; r < room_metrics.size(); ++r) {
+        out << "rtype_room_tick_p99_seconds{room=\"" << r << "\"} "
+            << seconds(room_metrics[r].tick_time.percentile(0.99)) << '\n';
+    }
+    header(out, "rtype_room_system_seconds_total", "counter", "Time spent in each part of the tick.");
+    for (std::size_t r = 0; r < room_metrics.size(); ++r) {
+        for (std::size_t s = 0; s < kTimedSystemCount; ++s) {
+            out << "rtype_room_system_seconds_total{room=\"" << r << "\",system=\"" << kTimedSystemNames[s] << "\"} "
+                << seconds(room_metrics[r].system_time[s]) << '\n';
+        }
+    }
+    header(out, "rtype_room_snapshots_superseded_total", "counter",
+           "Snapshots sampled on the tick but replaced by a newer one before being sent.");
+    for (std::size_t r = 0; r < room_metrics.size(); ++r) {
+        out << "rtype_room_snapshots_superseded_total{room=\"" << r << "\"} " << room_metrics[r].snapshots_superseded
+            << '\n';
+    }
+    header(out, "rtype_room_entities", "gauge", "Alive entities by faction; projectiles count with their shooter's.");
+    for (std::size_t r = 0; r < room_metrics.size(); ++r) {
+        for (std::size_t f = 0; f < kFactionNames.size(); ++f) {
+            out << "rtype_room_entities{room=\"" << r << "\",faction=\"" << kFactionNames[f] << "\"} "
+                << room_metrics[r].entities[f] << '\n';
+        }
+    }
+    header(out, "rtype_room_players", "gauge", "Players connected to the room.");
+    for (std::size_t r = 0; r < room_metrics.size(); ++r) {
+        out << "rtype_room_players{room=\"" << r << "\"} " << room_metrics[r].players << '\n';
+    }
+    header(out, "rtype_room_started", "gauge", "1 once the room left its lobby.");
+    for (std::size_t r = 0; r < room_metrics.size(); ++r) {
+        out << "rtype_room_started{room=\"" << r << "\"} " << (room_metrics[r].started ? 1 : 0) << '\n';
+    }
+
+    std::vector<NetworkServer::QueueStats> queues;
+    for (std::uint16_t r = 0; r < server.room_count(); ++r) {
+        queues.push_back(server.queue_stats(r));
+    }
+    header(out, "rtype_room_queue_depth", "gauge", "Items waiting in a room's queues from the listener.");
+    for (std::size_t r = 0; r < queues.size(); ++r) {
+        out << "rtype_room_queue_depth{room=\"" << r << "\",queue=\"inputs\"} " << queues[r].inputs << '\n'
+            << "rtype_room_queue_depth{room=\"" << r << "\",queue=\"events\"} " << queues[r].events << '\n';
+    }
+    header(out, "rtype_room_queue_dropped_total", "counter", "Items refused by a full room queue.");
+    for (std::size_t r = 0; r < queues.size(); ++r) {
+        out << "rtype_room_queue_dropped_total{room=\"" << r << "\",queue=\"inputs\"} " << queues[r].inputs_dropped << '\n'
+            << "rtype_room_queue_dropped_total{room=\"" << r << "\",queue=\"events\"} " << queues[r].events_dropped << '\n';
+    }
+
+    const auto clients = server.clients();
+    header(out, "rtype_clients", "gauge", "Connected clients.");
+    out << "rtype_clients " << clients->size() << '\n';
+    // One family at a time, each over every client.
+    const auto per_client = [&](const char* name, const char* suffix, const auto& value) {
+        for (const auto& [_, client] : *clients) {
+            out << name << "{client=\"" << client->id << "\",room=\"" << client->room_id << '"' << suffix << "} "
+                << value(*client) << '\n';
+        }
+    };
+    header(out, "rtype_client_datagrams_total", "counter", "Datagrams exchanged with each client.");
+    per_client("rtype_client_datagrams_total", ",direction=\"in\"",
+               [](const ClientInfo& c) { return c.datagrams_received.load(std::memory_order_relaxed); });
+    per_client("rtype_client_datagrams_total", ",direction=\"out\"",
+               [](const ClientInfo& c) { return c.datagrams_sent.load(std::memory_order_relaxed); });
+    header(out, "rtype_client_bytes_total", "counter", "UDP payload bytes exchanged with each client.");
+    per_client("rtype_client_bytes_total", ",direction=\"in\"",
+               [](const ClientInfo& c) { return c.bytes_received.load(std::memory_order_relaxed); });
+    per_client("rtype_client_bytes_total", ",direction=\"out\"",
+               [](const ClientInfo& c) { return c.bytes_sent.load(std::memory_order_relaxed); });
+    header(out, "rtype_client_loss_ratio", "gauge", "Downstream loss reported by the client's Pings.");
+    per_client("rtype_client_loss_ratio", "",
+               [](const ClientInfo& c) { return c.loss.load(std::memory_order_relaxed); });
+    header(out, "rtype_client_rtt_seconds", "gauge", "Smoothed round trip time reported by the client's Pings.");
+    per_client("rtype_client_rtt_seconds", "",
+               [](const ClientInfo& c) { return c.rtt_ms.load(std::memory_order_relaxed) / 1000.0; });
+    return out.str();
+}
+
+}  // namespace server
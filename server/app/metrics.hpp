@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "engine/core/tick_clock.hpp"
+
+namespace server {
+
+class NetworkServer;
+class RoomManager;
+
+// Parts of Match::tick timed separately; kTimedSystemNames gives their metric labels.
+// Snapshot is the sampling on the tick; Broadcast is the encoding and sending of it,
+// on the tick or on the room's snapshot thread.
+enum class TimedSystem : std::uint8_t {
+    Events,
+    Input,
+    Movement,
+    Shooting,
+    Projectiles,
+    Collision,
+    Health,
+    Enemies,
+    Spawning,
+    History,
+    Snapshot,
+    Broadcast,
+    EventSend,
+    Count,
+};
+
+inline constexpr std::size_t kTimedSystemCount = static_cast<std::size_t>(TimedSystem::Count);
+inline constexpr std::array<std::string_view, kTimedSystemCount> kTimedSystemNames{
+    "events", "input",  "movement", "shooting", "projectiles", "collision",
+    "health", "enemies", "spawning", "history", "snapshot",    "broadcast", "event_send",
+};
+
+using SystemTimes = std::array<std::chrono::nanoseconds, kTimedSystemCount>;
+
+// Adds the time until it goes out of scope to `times[system]`.
+class SystemTimer {
+public:
+    SystemTimer(SystemTimes& times, TimedSystem system)
+        : slot_(times[static_cast<std::size_t>(system)]), start_(std::chrono::steady_clock::now()) {}
+    ~SystemTimer() { slot_ += std::chrono::steady_clock::now() - start_; }
+
+    SystemTimer(const SystemTimer&) = delete;
+    SystemTimer& operator=(const SystemTimer&) = delete;
+
+private:
+    std::chrono::nanoseconds& slot_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Same order as engine::game::components::Faction.
+inline constexpr std::array<std::string_view, 5> kFactionNames{"player", "enemy", "neutral", "hazard", "obstacle"};
+
+// One room's figures since startup, as of its last tick.
+struct RoomMetrics {
+    std::uint64_t ticks{0};
+    engine::core::TickHistogram tick_time;  // Match::tick, including its snapshot sends only when inline
+    SystemTimes system_time{};
+    std::uint64_t snapshots_superseded{0};  // Sampled but replaced before the snapshot thread took them
+    std::array<std::uint32_t, kFactionNames.size()> entities{};  // Alive now, by faction
+    std::uint32_t players{0};
+    bool started{false};
+};
+
+/**
+ * @brief Hand-off of a room's metrics from its tick thread to the metrics endpoint.
+ *
+ * The tick thread adds each tick under a mutex nobody else holds for more than a copy,
+ * so scrapes never stall the simulation for long. A pipelined room's snapshot thread
+ * adds its sends the same way.
+ */
+class MatchMetrics {
+public:
+    void record_tick(std::chrono::nanoseconds duration, const SystemTimes& times) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++metrics_.ticks;
+        metrics_.tick_time.record(duration);
+        for (std::size_t i = 0; i < kTimedSystemCount; ++i) {
+            metrics_.system_time[i] += times[i];
+        }
+    }
+
+    void record_broadcast(std::chrono::nanoseconds duration) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        metrics_.system_time[static_cast<std::size_t>(TimedSystem::Broadcast)] += duration;
+    }
+
+    void record_superseded_snapshot() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++metrics_.snapshots_superseded;
+    }
+
+    void set_population(const std::array<std::uint32_t, kFactionNames.size()>& entities,
+                        std::uint32_t players,
+                        bool started) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        metrics_.entities = entities;
+        metrics_.players = players;
+        metrics_.started = started;
+    }
+
+    RoomMetrics read() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return metrics_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    RoomMetrics metrics_;
+};
+
+// A worker thread's schedule since startup. Written by the worker, read by anyone.
+struct WorkerMetrics {
+    std::atomic<std::uint64_t> ticks{0};
+    std::atomic<std::uint64_t> overruns{0};
+    std::atomic<std::uint64_t> skipped{0};
+};
+
+// Prometheus text exposition of everything the server measures: workers, rooms, clients.
+std::string render_metrics(const RoomManager& rooms, const NetworkServer& server);
+
+}  // namespace server
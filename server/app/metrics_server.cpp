@@ -0,0 +1,104 @@
+#include "metrics_server.hpp"
+
+#include <iostream>
+#include <istream>
+#include <memory>
+#include <utility>
+
+namespace server {
+
+namespace {
+// Longest request head accepted; scrapers send a few hundred bytes.
+constexpr std::size_t kMaxRequestSize = 8192;
+
+struct Session {
+    explicit Session(asio::ip::tcp::socket s) : socket(std::move(s)) {}
+
+    asio::ip::tcp::socket socket;
+    asio::streambuf request{kMaxRequestSize};
+    std::string response;
+};
+
+std::string http_response(const char* status, const char* content_type, const std::string& body) {
+    return std::string("HTTP/1.0 ") + status + "\r\nContent-Type: " + content_type +
+           "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+}
+}  // namespace
+
+MetricsServer::MetricsServer(Renderer renderer) : renderer_(std::move(renderer)), acceptor_(io_ctx_) {}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start(std::uint16_t port) {
+    if (thread_.joinable()) {
+        return true;
+    }
+    std::error_code ec;
+    const asio::ip::tcp::endpoint endpoint(asio::ip::address_v4::loopback(), port);
+    acceptor_.open(endpoint.protocol(), ec);
+    if (!ec) {
+        acceptor_.set_option(asio::ip::tcp::acceptor::reuse_address(true), ec);
+        acceptor_.bind(endpoint, ec);
+    }
+    if (!ec) {
+        acceptor_.listen(asio::socket_base::max_listen_connections, ec);
+    }
+    if (ec) {
+        std::cerr << "[metrics] Could not listen on 127.0.0.1:" << port << ": " << ec.message() << std::endl;
+        acceptor_.close(ec);
+        return false;
+    }
+    accept();
+    thread_ = std::thread([this] { io_ctx_.run(); });
+    std::cout << "[metrics] Serving http://127.0.0.1:" << port << "/metrics" << std::endl;
+    return true;
+}
+
+void MetricsServer::stop() {
+    io_ctx_.stop();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void MetricsServer::accept() {
+    acceptor_.async_accept([this](std::error_code ec, asio::ip::tcp::socket socket) {
+        if (ec == asio::error::operation_aborted) {
+            return;
+        }
+        if (!ec) {
+            auto session = std::make_shared<Session>(std::move(socket));
+            asio::async_read_until(session->socket, session->request, "\r\n\r\n",
+                [this, session](std::error_code read_ec, std::size_t) {
+                    if (read_ec) {
+                        return;  // Closed early or request too large: drop the connection
+                    }
+                    std::istream head(&session->request);
+                    std::string method;
+                    std::string target;
+                    head >> method >> target;
+                    session->response = respond(method, target);
+                    asio::async_write(session->socket, asio::buffer(session->response),
+                        [session](std::error_code, std::size_t) {
+                            std::error_code ignored;
+                            session->socket.shutdown(asio::ip::tcp::socket::shutdown_both, ignored);
+                        });
+                });
+        }
+        accept();
+    });
+}
+
+std::string MetricsServer::respond(const std::string& method, const std::string& target) const {
+    if (method != "GET") {
+        return http_response("405 Method Not Allowed", "text/plain", "GET only\n");
+    }
+    if (target != "/metrics" && target != "/") {
+        return http_response("404 Not Found", "text/plain", "Try /metrics\n");
+    }
+    return http_response("200 OK", "text/plain; version=0.0.4", renderer_());
+}
+
+}  // namespace server
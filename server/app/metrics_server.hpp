@@ -0,0 +1,42 @@
+#pragma once
+
+#include <asio.hpp>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace server {
+
+/**
+ * @brief Serves the server's metrics over HTTP on the loopback interface.
+ *
+ * One thread of its own: each request for /metrics gets the renderer's output (the
+ * Prometheus text format, see render_metrics) and the connection is closed, so load
+ * tests can scrape it with Prometheus or plain curl. Bound to 127.0.0.1 only.
+ */
+class MetricsServer {
+public:
+    using Renderer = std::function<std::string()>;
+
+    explicit MetricsServer(Renderer renderer);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    // False if the port cannot be bound.
+    bool start(std::uint16_t port);
+    void stop();
+
+private:
+    void accept();
+    std::string respond(const std::string& method, const std::string& target) const;
+
+    Renderer renderer_;
+    asio::io_context io_ctx_;
+    asio::ip::tcp::acceptor acceptor_;
+    std::thread thread_;
+};
+
+}  // namespace server
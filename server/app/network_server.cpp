@@ -1,5 +1,6 @@
 #include "network_server.hpp"
 
+#include <algorithm>
 #include <array>
 #include <iostream>
 #include <span>
@@ -10,10 +11,23 @@ namespace {
 // Allow idle clients to stay connected longer so snapshots keep flowing even if they stop sending input briefly.
 // Reduced for testing - change back to 60 for production
 constexpr std::chrono::seconds kClientTimeout{2};
-constexpr std::uint16_t kServerTickrate = 60;
+// Datagrams drained per receive_batch call on the listener thread.
+constexpr std::size_t kReceiveBatchSize = 16;
+
+// Server clock stamped on Pongs, for the clients' clock synchronization.
+std::uint32_t steady_now_ms() {
+    return static_cast<std::uint32_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
 }  // namespace
 
-NetworkServer::NetworkServer() = default;
+NetworkServer::NetworkServer(std::uint16_t room_count) {
+    rooms_.reserve(std::max<std::uint16_t>(room_count, 1));
+    for (std::uint16_t i = 0; i < std::max<std::uint16_t>(room_count, 1); ++i) {
+        rooms_.push_back(std::make_unique<Room>());
+    }
+}
 
 NetworkServer::~NetworkServer() {
     stop();
@@ -35,7 +49,7 @@ void NetworkServer::start(std::uint16_t port) {
         }
     });
 
-    std::cout << "[server] Networking listening on port " << port << std::endl;
+    std::cout << "[server] Networking listening on port " << this->port() << std::endl;
 }
 
 void NetworkServer::stop() {
@@ -52,45 +66,218 @@ void NetworkServer::stop() {
     }
 }
 
-std::optional<InputCommand> NetworkServer::poll_input() {
-    return input_queue_.try_pop();
+std::optional<InputCommand> NetworkServer::poll_input(std::uint16_t room_id) {
+    return rooms_[room_id]->inputs.try_pop();
+}
+
+std::optional<PlayerEvent> NetworkServer::poll_event(std::uint16_t room_id) {
+    return rooms_[room_id]->events.try_pop();
+}
+
+NetworkServer::QueueStats NetworkServer::queue_stats(std::uint16_t room_id) const {
+    const auto& room = *rooms_[room_id];
+    return QueueStats{
+        .inputs = room.inputs.size(),
+        .inputs_dropped = room.inputs.dropped(),
+        .events = room.events.size(),
+        .events_dropped = room.events.dropped(),
+    };
+}
+
+void NetworkServer::broadcast_snapshot(std::uint16_t room_id, const engine::net::SnapshotMessage& snapshot) {
+    broadcast_snapshot(
+        room_id,
+        [&snapshot](std::uint16_t, std::uint32_t, engine::net::SendRate) -> const engine::net::SnapshotMessage& {
+            return snapshot;
+        });
+}
+
+void NetworkServer::broadcast_snapshot(std::uint16_t room_id, const SnapshotEncoder& encoder) {
+    // Clients that acknowledged the same baseline get the same blob: encode the
+    // per-datagram heads once per distinct snapshot, then for each client patch the
+    // sequence / last_processed_input into a copy of them and gather it with the
+    // shared blob. Snapshots above the MTU go out as fragments. Clients on a slower
+    // send rate skip ticks; nothing is encoded for them on those.
+    // Lock-free view of the clients; joins and timeouts publish a new table meanwhile.
+    const auto clients = clients_.snapshot();
+    auto& room = *rooms_[room_id];
+    room.snapshot_head_templates.clear();
+    room.encoded_snapshots.clear();
+    room.compressed_used = 0;
+    room.broadcast_plan.clear();
+    std::size_t total_datagrams = 0;
+    for (const auto& [_, client] : *clients) {
+        if (client->room_id != room_id) {
+            continue;
+        }
+        if (++client->ticks_since_snapshot < client->send_interval.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        client->ticks_since_snapshot = 0;
+        const auto& source =
+            encoder(client->id, client->acked_tick.load(std::memory_order_relaxed), client->send_rate());
+        const bool compressible = client->compress_snapshots;
+        auto encoded = std::find_if(room.encoded_snapshots.begin(), room.encoded_snapshots.end(),
+                                    [&](const EncodedSnapshot& e) {
+                                        return e.source == &source && e.compressible == compressible;
+                                    });
+        if (encoded == room.encoded_snapshots.end()) {
+            // Compressed once per distinct snapshot; the raw one is sent when it does not pay off.
+            const engine::net::SnapshotMessage* snapshot = &source;
+            if (compressible) {
+                if (room.compressed_used == room.compressed_snapshots.size()) {
+                    room.compressed_snapshots.emplace_back();
+                }
+                auto& compressed = room.compressed_snapshots[room.compressed_used];
+                if (room.compressor.compress(source, compressed)) {
+                    snapshot = &compressed;
+                    ++room.compressed_used;
+                }
+            }
+            const auto datagrams = engine::net::snapshot_datagram_count(snapshot->blob.size());
+            if (datagrams > engine::net::kMaxSnapshotFragments) {
+                std::cerr << "[server] Snapshot too large to send: " << snapshot->blob.size() << " bytes" << std::endl;
+                continue;
+            }
+            room.encoded_snapshots.push_back(
+                EncodedSnapshot{&source, compressible, snapshot, room.snapshot_head_templates.size(), datagrams});
+            for (std::size_t i = 0; i < datagrams; ++i) {
+                room.snapshot_head_templates.push_back(engine::net::encode_snapshot_head(*snapshot, i, datagrams));
+            }
+            encoded = std::prev(room.encoded_snapshots.end());
+        }
+        total_datagrams += encoded->datagrams;
+        room.broadcast_plan.emplace_back(client.get(), static_cast<std::size_t>(encoded - room.encoded_snapshots.begin()));
+    }
+
+    room.snapshot_heads.resize(total_datagrams);
+    room.snapshot_batch.clear();
+    std::size_t index = 0;
+    for (const auto& [client, encoded_index] : room.broadcast_plan) {
+        const auto& encoded = room.encoded_snapshots[encoded_index];
+        const auto blob = std::span<const std::uint8_t>(encoded.snapshot->blob.data(), encoded.snapshot->blob.size());
+        const auto last_input = client->last_processed_input.load(std::memory_order_relaxed);
+        std::size_t bytes = 0;
+        for (std::size_t i = 0; i < encoded.datagrams; ++i) {
+            auto& head = room.snapshot_heads[index++];
+            head = room.snapshot_head_templates[encoded.first_head + i];
+            engine::net::patch_snapshot_head(head, client->take_sequence(), last_input);
+            room.snapshot_batch.push_back(engine::net::OutgoingDatagram{
+                std::span<const std::uint8_t>(head.bytes.data(), head.size), client->endpoint,
+                engine::net::snapshot_blob_slice(blob, i, encoded.datagrams)});
+            bytes += head.size + room.snapshot_batch.back().tail.size();
+        }
+        client->count_sent(encoded.datagrams, bytes);
+    }
+    if (room.snapshot_batch.empty()) {
+        return;
+    }
+
+    if (room.log_counter++ % 60 == 0) {
+        std::size_t bytes = 0;
+        for (const auto& datagram : room.snapshot_batch) {
+            bytes += datagram.data.size() + datagram.tail.size();
+        }
+        std::cout << "[server] Room " << room_id << " sending snapshot: tick=" << room.encoded_snapshots.front().snapshot->tick
+                  << " encodings=" << room.encoded_snapshots.size() << " datagrams=" << room.snapshot_batch.size()
+                  << " bytes=" << bytes << " clients=" << room.broadcast_plan.size();
+        if (const auto& stats = room.compressor.stats(); stats.compressed > 0) {
+            std::cout << " compression=" << stats.compressed << "/" << stats.attempts << " ratio="
+                      << static_cast<double>(stats.compressed_bytes) / static_cast<double>(stats.raw_bytes);
+        }
+        std::cout << std::endl;
+    }
+
+    std::error_code ec;
+    socket_->send_batch(room.snapshot_batch, ec);
+    if (ec) {
+        std::cerr << "[server] Snapshot send error: " << ec.message() << std::endl;
+    }
+}
+
+void NetworkServer::send_event(std::uint16_t room_id, std::span<const std::uint8_t> event) {
+    const auto clients = clients_.snapshot();
+    for (const auto& [_, client] : *clients) {
+        if (client->room_id != room_id) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(client->events_mutex);
+        if (!client->events.send(event)) {
+            std::cerr << "[server] Event queue full for client #" << client->id << ", event dropped" << std::endl;
+        }
+    }
 }
 
-void NetworkServer::broadcast_snapshot(const engine::net::SnapshotMessage& snapshot) {
-    for (const auto& [_, client] : clients_) {
-        send_snapshot(client, snapshot);
+void NetworkServer::flush_events(std::uint16_t room_id) {
+    const auto clients = clients_.snapshot();
+    auto& room = *rooms_[room_id];
+    const auto now = std::chrono::steady_clock::now();
+    std::size_t count = 0;
+    room.event_batch.clear();
+    for (const auto& [_, client] : *clients) {
+        if (client->room_id != room_id) {
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(client->events_mutex);
+            if (!client->events.write_packet(room.event_payload, now,
+                                             engine::net::kMaxPacketSize - engine::net::kPacketHeaderSize)) {
+                continue;
+            }
+        }
+        if (room.event_datagrams.size() <= count) {
+            room.event_datagrams.emplace_back();
+        }
+        auto& datagram = room.event_datagrams[count];
+        engine::net::PacketHeader header;
+        header.type = static_cast<std::uint8_t>(engine::net::MessageType::Reliable);
+        header.sequence = client->take_sequence();
+        engine::net::begin_packet(datagram, header);
+        engine::net::write_bytes(datagram, room.event_payload);
+        room.event_batch.push_back(engine::net::OutgoingDatagram{datagram.bytes(), client->endpoint});
+        client->count_sent(1, datagram.bytes().size());
+        ++count;
+    }
+    if (count == 0) {
+        return;
+    }
+    std::error_code ec;
+    socket_->send_batch(room.event_batch, ec);
+    if (ec) {
+        std::cerr << "[server] Event send error: " << ec.message() << std::endl;
     }
 }
 
 void NetworkServer::listen_loop() {
-    std::array<std::uint8_t, engine::net::kMaxPacketSize> buffer{};
+    std::array<std::array<std::uint8_t, engine::net::kMaxPacketSize>, kReceiveBatchSize> buffers{};
+    std::array<engine::net::IncomingDatagram, kReceiveBatchSize> batch{};
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        batch[i].buffer = buffers[i];
+    }
     while (running_) {
-        asio::ip::udp::endpoint endpoint;
         std::error_code ec;
-        auto received =
-            socket_->native().receive_from(asio::buffer(buffer.data(), buffer.size()), endpoint, 0, ec);
-        if (ec) {
-            if (running_) {
-                std::cerr << "[server] Receive error: " << ec.message() << std::endl;
-            }
-            continue;
+        const auto received = socket_->receive_batch(batch, ec);
+        if (ec && running_) {
+            std::cerr << "[server] Receive error: " << ec.message() << std::endl;
         }
-        auto packet = engine::net::deserialize(
-            std::span<const std::uint8_t>(buffer.data(), static_cast<std::size_t>(received)));
-        if (!packet) {
-            continue;
+        for (std::size_t i = 0; i < received; ++i) {
+            auto packet = engine::net::parse_packet(
+                std::span<const std::uint8_t>(batch[i].buffer.data(), batch[i].size));
+            if (!packet) {
+                continue;
+            }
+            process_packet(*packet, batch[i].endpoint);
         }
-        process_packet(*packet, endpoint);
     }
 }
 
-void NetworkServer::process_packet(const engine::net::Packet& packet,
+void NetworkServer::process_packet(const engine::net::PacketView& packet,
                                    const asio::ip::udp::endpoint& endpoint) {
     // Update last_seen for any valid packet
-    const auto key = endpoint_key(endpoint);
-    auto it = clients_.find(key);
-    if (it != clients_.end()) {
-        it->second.last_seen = std::chrono::steady_clock::now();
+    if (auto client = clients_.find(endpoint_key(endpoint))) {
+        client->touch(std::chrono::steady_clock::now());
+        client->datagrams_received.fetch_add(1, std::memory_order_relaxed);
+        client->bytes_received.fetch_add(packet.bytes.size(), std::memory_order_relaxed);
     }
 
     switch (static_cast<engine::net::MessageType>(packet.header.type)) {
@@ -100,133 +287,179 @@ void NetworkServer::process_packet(const engine::net::Packet& packet,
         case engine::net::MessageType::Input:
             handle_input(packet, endpoint);
             break;
-        case engine::net::MessageType::Ping: {
-            auto bytes = engine::net::serialize(packet);
-            socket_->send_to(std::span<const std::uint8_t>(bytes.data(), bytes.size()), endpoint);
+        case engine::net::MessageType::Reliable:
+            handle_reliable(packet, endpoint);
+            break;
+        case engine::net::MessageType::Ping:
+            handle_ping(packet, endpoint);
             break;
-        }
         default:
             break;
     }
 }
 
-void NetworkServer::handle_hello(const engine::net::Packet& packet,
+void NetworkServer::handle_hello(const engine::net::PacketView& packet,
                                  const asio::ip::udp::endpoint& endpoint) {
     const auto key = endpoint_key(endpoint);
-    auto it = clients_.find(key);
-    if (it == clients_.end()) {
-        // Decode HelloMessage to get start_level and difficulty
-        auto payload = std::span<const std::uint8_t>(packet.payload.data(), packet.payload.size());
-        auto hello_msg = engine::net::decode_hello_payload(payload);
-        std::uint16_t start_level = hello_msg.start_level;
-        if (start_level < 1 || start_level > 5) {
-            start_level = 1;  // Clamp to valid range
-        }
-        std::uint8_t difficulty = hello_msg.difficulty;
-        if (difficulty > 3) {
-            difficulty = 1;  // Clamp to valid range (0-3)
-        }
+    if (auto existing = clients_.find(key)) {
+        existing->touch(std::chrono::steady_clock::now());
+        send_welcome(*existing);
+        return;
+    }
 
-        const auto client_id = next_client_id_++;
-        std::uint16_t entity_id = 0;
-        if (on_player_connect_) {
-            entity_id = on_player_connect_(client_id, start_level, difficulty);
-        }
-        ClientInfo info{};
-        info.id = client_id;
-        info.endpoint = endpoint;
-        info.last_seen = std::chrono::steady_clock::now();
-        info.entity_id = entity_id;
-        clients_.emplace(key, info);
-        std::cout << "[server] New client #" << info.id << " (entity #" << entity_id << ", level " << start_level << ", difficulty " << static_cast<int>(difficulty) << ") from " << key << std::endl;
-        send_welcome(info);
-    } else {
-        it->second.last_seen = std::chrono::steady_clock::now();
-        send_welcome(it->second);
+    // Decode HelloMessage to get start_level and difficulty
+    auto hello_msg = engine::net::decode_hello_payload(packet.payload);
+    std::uint16_t start_level = hello_msg.start_level;
+    if (start_level < 1 || start_level > 5) {
+        start_level = 1;  // Clamp to valid range
+    }
+    std::uint8_t difficulty = hello_msg.difficulty;
+    if (difficulty > 3) {
+        difficulty = 1;  // Clamp to valid range (0-3)
     }
+
+    if (hello_msg.room_id >= room_count()) {
+        std::cerr << "[server] Hello from " << endpoint << " for unknown room " << hello_msg.room_id << std::endl;
+        return;
+    }
+
+    const auto client_id = next_client_id_++;
+    // The room spawns the player on its own thread at its next tick.
+    const PlayerEvent joined{
+        .kind = PlayerEvent::Kind::Joined,
+        .player_id = client_id,
+        .start_level = start_level,
+        .difficulty = difficulty,
+    };
+    if (!rooms_[hello_msg.room_id]->events.push(joined)) {
+        std::cerr << "[server] Room " << hello_msg.room_id << " event queue full, dropped hello from " << endpoint << std::endl;
+        return;
+    }
+    auto info = std::make_shared<ClientInfo>();
+    info->id = client_id;
+    info->endpoint = endpoint;
+    info->room_id = hello_msg.room_id;
+    info->compress_snapshots = (hello_msg.features & engine::net::kFeatureSnapshotCompression) != 0;
+    info->touch(std::chrono::steady_clock::now());
+    clients_.insert(key, info);
+    std::cout << "[server] New client #" << info->id << " (room " << info->room_id << ", level " << start_level << ", difficulty " << static_cast<int>(difficulty) << ") from " << endpoint << std::endl;
+    send_welcome(*info);
 }
 
-void NetworkServer::handle_input(const engine::net::Packet& packet,
+void NetworkServer::handle_input(const engine::net::PacketView& packet,
                                  const asio::ip::udp::endpoint& endpoint) {
-    auto payload = std::span<const std::uint8_t>(packet.payload.data(), packet.payload.size());
-    auto input = engine::net::decode_input_payload(payload);
+    auto input = engine::net::decode_input_payload(packet.payload);
     if (!input) {
         return;
     }
-    const auto key = endpoint_key(endpoint);
-    auto it = clients_.find(key);
-    if (it == clients_.end()) {
+    auto client = clients_.find(endpoint_key(endpoint));
+    if (!client) {
         return;
     }
-    it->second.last_seen = std::chrono::steady_clock::now();
-    
-    // Update last processed input sequence for this client
-    it->second.last_processed_input = packet.header.sequence;
-    
-    InputCommand cmd{
-        .player_id = input->player_id,
-        .input_mask = input->input_mask,
-        .client_time_ms = input->client_time_ms,
-        .sequence = packet.header.sequence,
+
+    // Inputs may arrive out of order; the delta baseline only moves forward.
+    if (input->ack_tick > client->acked_tick.load(std::memory_order_relaxed)) {
+        client->acked_tick.store(input->ack_tick, std::memory_order_relaxed);
+    }
+
+    // Each datagram repeats the client's last few inputs: forward the ones not seen yet, in order.
+    auto& room = *rooms_[client->room_id];
+    engine::net::for_each_new_input(*input, packet.header.sequence, client->newest_input,
+        [&](std::uint32_t sequence, std::uint16_t mask, std::uint32_t client_time_ms) {
+            InputCommand cmd{
+                .player_id = input->player_id,
+                .input_mask = mask,
+                .client_time_ms = client_time_ms,
+                .sequence = sequence,
+                .view_tick = input->ack_tick,
+            };
+            if (!room.inputs.push(cmd)) {
+                std::cerr << "[server] Room " << client->room_id << " input queue full, dropped input from client #" << client->id << std::endl;
+            }
+        });
+    client->last_processed_input.store(client->newest_input, std::memory_order_relaxed);
+}
+
+void NetworkServer::handle_reliable(const engine::net::PacketView& packet,
+                                    const asio::ip::udp::endpoint& endpoint) {
+    auto client = clients_.find(endpoint_key(endpoint));
+    if (!client) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(client->events_mutex);
+    client->events.read_packet(packet.payload);
+    // Clients only send acks today; drop anything else so it does not pile up.
+    while (client->events.receive()) {
+    }
+}
+
+void NetworkServer::handle_ping(const engine::net::PacketView& packet,
+                                const asio::ip::udp::endpoint& endpoint) {
+    const auto received_ms = steady_now_ms();
+    const auto report = engine::net::decode_ping_payload(packet.payload);
+    if (!report) {
+        socket_->send_to(packet.bytes, endpoint);  // Older client: echoed as received
+        return;
+    }
+    // Pong: the Ping back with our clock on arrival and departure.
+    const engine::net::PongMessage pong{
+        .ping = *report,
+        .server_receive_ms = received_ms,
+        .server_send_ms = steady_now_ms(),
+        .has_server_time = true,
     };
-    input_queue_.push(cmd);
+    engine::net::begin_packet(pong_datagram_, packet.header);
+    engine::net::append_pong_payload(pong, pong_datagram_);
+    socket_->send_to(pong_datagram_.bytes(), endpoint);
+
+    auto client = clients_.find(endpoint_key(endpoint));
+    if (!client) {
+        return;
+    }
+    client->count_sent(1, pong_datagram_.bytes().size());
+    const bool rate_changed = client->rate_controller.on_report(*report, std::chrono::steady_clock::now());
+    client->loss.store(static_cast<float>(client->rate_controller.loss()), std::memory_order_relaxed);
+    client->rtt_ms.store(static_cast<float>(client->rate_controller.srtt_ms()), std::memory_order_relaxed);
+    if (!rate_changed) {
+        return;
+    }
+    const auto rate = client->rate_controller.rate();
+    client->send_interval.store(rate.interval_ticks, std::memory_order_relaxed);
+    client->budget_percent.store(rate.budget_percent, std::memory_order_relaxed);
+    std::cout << "[server] Client #" << client->id << " snapshot rate " << kTickRate / rate.interval_ticks
+              << " Hz, budget " << static_cast<int>(rate.budget_percent) << "% (loss "
+              << client->rate_controller.loss() * 100.0 << "%, rtt " << client->rate_controller.srtt_ms()
+              << " ms, queueing " << client->rate_controller.queue_delay_ms() << " ms)" << std::endl;
 }
 
-void NetworkServer::send_welcome(const ClientInfo& client) {
+void NetworkServer::send_welcome(ClientInfo& client) {
     engine::net::Packet packet;
     packet.header.type = static_cast<std::uint8_t>(engine::net::MessageType::Welcome);
-    packet.header.sequence = sequence_counter_++;
+    packet.header.sequence = client.take_sequence();
     engine::net::WelcomeMessage welcome{
         .player_id = client.id,
-        .tick_rate = kServerTickrate,
+        .tick_rate = kTickRate,
+        .features = client.compress_snapshots ? engine::net::kFeatureSnapshotCompression : std::uint8_t{0},
     };
     engine::net::encode_welcome_payload(welcome, packet.payload);
     auto bytes = engine::net::serialize(packet);
     socket_->send_to(std::span<const std::uint8_t>(bytes.data(), bytes.size()), client.endpoint);
-}
-
-void NetworkServer::send_snapshot(const ClientInfo& client,
-                                  const engine::net::SnapshotMessage& snapshot) {
-    engine::net::Packet packet;
-    packet.header.type = static_cast<std::uint8_t>(engine::net::MessageType::Snapshot);
-    packet.header.sequence = sequence_counter_++;
-    
-    // Create client-specific snapshot with their last processed input
-    engine::net::SnapshotMessage client_snapshot = snapshot;
-    client_snapshot.last_processed_input = client.last_processed_input;
-    
-    engine::net::encode_snapshot_payload(client_snapshot, packet.payload);
-    
-    static std::uint32_t log_counter = 0;
-    if (log_counter++ % 60 == 0) {
-        std::cout << "[server] Sending snapshot: blob.size()=" << snapshot.blob.size() 
-                  << " payload.size()=" << packet.payload.size() << std::endl;
-    }
-    
-    auto bytes = engine::net::serialize(packet);
-    socket_->send_to(std::span<const std::uint8_t>(bytes.data(), bytes.size()), client.endpoint);
+    client.count_sent(1, bytes.size());
 }
 
 void NetworkServer::prune_timeouts() {
     const auto now = std::chrono::steady_clock::now();
-    for (auto it = clients_.begin(); it != clients_.end();) {
-        if (now - it->second.last_seen > kClientTimeout) {
-            std::cout << "[server] Client #" << it->second.id << " timed out\n";
-
-            if (on_player_disconnect_) {
-                on_player_disconnect_(it->second.id);
-            }
+    const auto timed_out = clients_.remove_if([now](const ClientInfo& client) {
+        return now - client.last_seen_at() > kClientTimeout;
+    });
+    for (const auto& client : timed_out) {
+        std::cout << "[server] Client #" << client->id << " timed out\n";
 
-            it = clients_.erase(it);
-        } else {
-            ++it;
+        const PlayerEvent left{.kind = PlayerEvent::Kind::Left, .player_id = client->id};
+        if (!rooms_[client->room_id]->events.push(left)) {
+            std::cerr << "[server] Room " << client->room_id << " event queue full, dropped leave of client #" << client->id << std::endl;
         }
     }
 }
 
-
-std::string NetworkServer::endpoint_key(const asio::ip::udp::endpoint& endpoint) const {
-    return endpoint.address().to_string() + ":" + std::to_string(endpoint.port());
-}
-
 }  // namespace server
@@ -4,16 +4,22 @@
 #include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <optional>
 #include <span>
 #include <string>
 #include <thread>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "engine/net/compression.hpp"
 #include "engine/net/packet.hpp"
-#include "engine/net/thread_safe_queue.hpp"
+#include "engine/net/ring_queue.hpp"
+#include "engine/net/send_rate.hpp"
 #include "engine/net/udp_socket.hpp"
+#include "client_registry.hpp"
 
 namespace server {
 
@@ -22,61 +28,125 @@ struct InputCommand {
     std::uint16_t input_mask{0};
     std::uint32_t client_time_ms{0};
     std::uint32_t sequence{0};
+    std::uint32_t view_tick{0};  // Newest snapshot the client had decoded when sending (0 = none)
 };
 
+// A client joining or leaving a room, delivered to the room's tick thread.
+struct PlayerEvent {
+    enum class Kind : std::uint8_t { Joined, Left };
+    Kind kind{Kind::Joined};
+    std::uint16_t player_id{0};
+    std::uint16_t start_level{1};
+    std::uint8_t difficulty{1};
+};
+
+/**
+ * @brief UDP front end shared by every room of the process.
+ *
+ * One socket, one listener thread: each client picks a room in its Hello and
+ * the listener routes its inputs and join/leave events into that room's queues.
+ * A room's tick thread drains them with poll_input / poll_event and flushes its
+ * events; its snapshots go out through broadcast_snapshot(room_id, ...), from the
+ * tick thread or from a snapshot thread running beside it. Each of the two paths
+ * only touches that room's clients and its own scratch buffers, so neither rooms
+ * on different threads nor the two senders of one room contend.
+ */
 class NetworkServer {
 public:
-    NetworkServer();
+    static constexpr std::uint16_t kTickRate = 60;  // Simulation ticks per second, announced in Welcome
+
+    explicit NetworkServer(std::uint16_t room_count = 1);
     ~NetworkServer();
 
     void start(std::uint16_t port);
     void stop();
+    // Port the socket is bound to once started: the one start() picked for port 0.
+    std::uint16_t port() const { return socket_ ? socket_->native().local_endpoint().port() : 0; }
+
+    std::uint16_t room_count() const { return static_cast<std::uint16_t>(rooms_.size()); }
 
-    std::optional<InputCommand> poll_input();
-    void broadcast_snapshot(const engine::net::SnapshotMessage& snapshot);
-    
-    // Callback signature: (player_id, start_level, difficulty) -> entity_id
-    using OnPlayerConnectCallback = std::function<std::uint16_t(std::uint16_t player_id, std::uint16_t start_level, std::uint8_t difficulty)>;
-    void set_on_player_connect(OnPlayerConnectCallback callback) { 
-        on_player_connect_ = callback; 
-    }
+    std::optional<InputCommand> poll_input(std::uint16_t room_id);
+    std::optional<PlayerEvent> poll_event(std::uint16_t room_id);
+    void broadcast_snapshot(std::uint16_t room_id, const engine::net::SnapshotMessage& snapshot);
 
-    using OnPlayerDisconnectCallback = std::function<void(std::uint16_t player_id)>;
-    void set_on_player_disconnect(OnPlayerDisconnectCallback callback) {
-        on_player_disconnect_ = callback;
-    }
+    // Returns the snapshot for client `client_id` whose newest acknowledged tick is `acked_tick`
+    // (0 = none), sized for its link (`rate.budget_percent`). Called once per client due a
+    // snapshot this tick (see SendRateController); the reference must stay valid for the call.
+    using SnapshotEncoder = std::function<const engine::net::SnapshotMessage&(
+        std::uint16_t client_id, std::uint32_t acked_tick, engine::net::SendRate rate)>;
+    void broadcast_snapshot(std::uint16_t room_id, const SnapshotEncoder& encoder);
 
+    // Queues `event` on the reliable channel of every client in the room.
+    void send_event(std::uint16_t room_id, std::span<const std::uint8_t> event);
+    // Sends the room's clients their new or due-for-resend events (and owed acks). Once per tick.
+    void flush_events(std::uint16_t room_id);
+
+    // For the metrics endpoint: current clients, and the depth of a room's queues.
+    struct QueueStats {
+        std::size_t inputs{0};
+        std::uint64_t inputs_dropped{0};
+        std::size_t events{0};
+        std::uint64_t events_dropped{0};
+    };
+    std::shared_ptr<const ClientRegistry::Table> clients() const { return clients_.snapshot(); }
+    QueueStats queue_stats(std::uint16_t room_id) const;
 
 private:
-    struct ClientInfo {
-        std::uint16_t id;
-        asio::ip::udp::endpoint endpoint;
-        std::chrono::steady_clock::time_point last_seen;
-        std::uint16_t entity_id{0};  // Player entity for this client
-        std::uint32_t last_processed_input{0};  // Last input sequence processed for this client
+    struct EncodedSnapshot {
+        const engine::net::SnapshotMessage* source;    // What the encoder returned
+        bool compressible;                             // Encoded for clients that accept compression
+        const engine::net::SnapshotMessage* snapshot;  // What goes on the wire: source or its compressed copy
+        std::size_t first_head;  // Index in snapshot_head_templates
+        std::size_t datagrams;
+    };
+
+    // Per-room queues and send scratch. Only the room's tick thread pops and flushes events;
+    // the snapshot scratch belongs to whichever single thread calls broadcast_snapshot.
+    struct Room {
+        // Listener threads push, the tick thread drains once per tick. Reject on overflow so
+        // the inputs that do get through stay in order; a full queue means the tick loop stalled.
+        engine::net::MpscRingQueue<InputCommand> inputs{1024, engine::net::OverflowPolicy::Reject};
+        // Pushed by the listener (joins) and maintenance (timeouts) threads.
+        engine::net::MpscRingQueue<PlayerEvent> events{256, engine::net::OverflowPolicy::Reject};
+        // Snapshot sender only. Reused between ticks so broadcast_snapshot does not allocate per client.
+        std::vector<engine::net::SnapshotHead> snapshot_head_templates;
+        std::vector<engine::net::SnapshotHead> snapshot_heads;
+        std::vector<EncodedSnapshot> encoded_snapshots;
+        std::vector<std::pair<ClientInfo*, std::size_t>> broadcast_plan;  // Client, encoded_snapshots index
+        std::vector<engine::net::OutgoingDatagram> snapshot_batch;
+        // Compressed copies of this tick's snapshots; a deque so EncodedSnapshot pointers stay
+        // valid as it grows. Entries (and their blobs) are reused from tick to tick.
+        engine::net::SnapshotCompressor compressor;
+        std::deque<engine::net::SnapshotMessage> compressed_snapshots;
+        std::size_t compressed_used{0};
+        // Tick thread only, for flush_events.
+        std::vector<engine::net::OutgoingDatagram> event_batch;
+        std::vector<std::uint8_t> event_payload;
+        // One per client, grown once; a deque so event_batch spans survive it growing mid-flush.
+        std::deque<engine::net::PacketBuffer> event_datagrams;
+        std::uint32_t log_counter{0};
     };
 
     void listen_loop();
-    void process_packet(const engine::net::Packet& packet, const asio::ip::udp::endpoint& endpoint);
-    void handle_hello(const engine::net::Packet& packet, const asio::ip::udp::endpoint& endpoint);
-    void handle_input(const engine::net::Packet& packet, const asio::ip::udp::endpoint& endpoint);
-    void send_welcome(const ClientInfo& client);
-    void send_snapshot(const ClientInfo& client, const engine::net::SnapshotMessage& snapshot);
+    // Packets are parsed in place; their spans point into the listener's receive buffers.
+    void process_packet(const engine::net::PacketView& packet, const asio::ip::udp::endpoint& endpoint);
+    void handle_hello(const engine::net::PacketView& packet, const asio::ip::udp::endpoint& endpoint);
+    void handle_input(const engine::net::PacketView& packet, const asio::ip::udp::endpoint& endpoint);
+    void handle_reliable(const engine::net::PacketView& packet, const asio::ip::udp::endpoint& endpoint);
+    void handle_ping(const engine::net::PacketView& packet, const asio::ip::udp::endpoint& endpoint);
+    void send_welcome(ClientInfo& client);
     void prune_timeouts();
 
-    std::string endpoint_key(const asio::ip::udp::endpoint& endpoint) const;
-
     std::atomic_bool running_{false};
     asio::io_context io_ctx_;
     std::unique_ptr<engine::net::UdpSocket> socket_;
     std::thread listener_thread_;
     std::thread maintenance_thread_;
-    engine::net::ThreadSafeQueue<InputCommand> input_queue_;
-    std::unordered_map<std::string, ClientInfo> clients_;
+    std::vector<std::unique_ptr<Room>> rooms_;  // Indexed by room id, fixed after construction
+    // Written by the listener (joins) and maintenance (timeouts) threads, iterated by the tick threads.
+    ClientRegistry clients_;
     std::uint16_t next_client_id_{1};
-    std::atomic<std::uint32_t> sequence_counter_{0};
-    OnPlayerConnectCallback on_player_connect_;
-    OnPlayerDisconnectCallback on_player_disconnect_;
+    engine::net::PacketBuffer pong_datagram_;  // Listener thread only
 };
 
 }  // namespace server
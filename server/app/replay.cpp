@@ -0,0 +1,317 @@
+#include "replay.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+
+#include "match.hpp"
+
+namespace server {
+
+namespace {
+
+// Frames: the frame count so far, written at each flush so a cut file knows where it stopped.
+enum class RecordKind : std::uint8_t { End = 0, Joined = 1, Left = 2, Input = 3, Frames = 4 };
+
+void write_varint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+// Settings are small ints that may be negative in a hand-edited config.
+void write_signed(std::vector<std::uint8_t>& out, int value) {
+    const auto wide = static_cast<std::int64_t>(value);
+    write_varint(out, (static_cast<std::uint64_t>(wide) << 1) ^ static_cast<std::uint64_t>(wide >> 63));
+}
+
+struct Cursor {
+    const std::vector<std::uint8_t>& data;
+    std::size_t pos{0};
+    bool ok{true};
+
+    bool at_end() const { return pos >= data.size(); }
+
+    std::uint8_t byte() {
+        if (pos >= data.size()) {
+            ok = false;
+            return 0;
+        }
+        return data[pos++];
+    }
+
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            const auto b = byte();
+            value |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    int signed_int() {
+        const auto raw = varint();
+        return static_cast<int>(static_cast<std::int64_t>(raw >> 1) ^ -static_cast<std::int64_t>(raw & 1));
+    }
+
+    template <typename T>
+    T narrow() {
+        const auto value = varint();
+        if (value > std::numeric_limits<T>::max()) {
+            ok = false;
+        }
+        return static_cast<T>(value);
+    }
+};
+
+}  // namespace
+
+// =========================
+// WRITER
+// =========================
+
+ReplayWriter::ReplayWriter(const std::string& path, const ReplayHeader& header)
+    : file_(path, std::ios::binary | std::ios::trunc) {
+    buffer_.insert(buffer_.end(), std::begin(kReplayMagic), std::end(kReplayMagic));
+    buffer_.push_back(kReplayVersion);
+    write_varint(buffer_, header.room_id);
+    for (int i = 0; i < 8; ++i) {
+        buffer_.push_back(static_cast<std::uint8_t>(header.seed >> (8 * i)));
+    }
+    const auto& settings = header.settings;
+    write_signed(buffer_, settings.difficulty);
+    write_signed(buffer_, settings.enemies_per_wave);
+    write_signed(buffer_, settings.kills_per_wave);
+    write_signed(buffer_, settings.player_lives);
+    buffer_.push_back(settings.infinite_lives ? 1 : 0);
+    std::uint32_t spawn_rate = 0;
+    std::memcpy(&spawn_rate, &settings.enemy_spawn_rate, sizeof(spawn_rate));
+    write_varint(buffer_, spawn_rate);
+    flush();
+}
+
+ReplayWriter::~ReplayWriter() {
+    if (!is_open()) {
+        return;
+    }
+    begin_record(frames_, static_cast<std::uint8_t>(RecordKind::End));
+    flush();
+}
+
+void ReplayWriter::begin_record(std::uint64_t frame, std::uint8_t kind) {
+    write_varint(buffer_, frame - last_frame_);
+    buffer_.push_back(kind);
+    last_frame_ = frame;
+}
+
+void ReplayWriter::event(std::uint64_t frame, const PlayerEvent& event) {
+    const bool joined = event.kind == PlayerEvent::Kind::Joined;
+    begin_record(frame, static_cast<std::uint8_t>(joined ? RecordKind::Joined : RecordKind::Left));
+    write_varint(buffer_, event.player_id);
+    if (joined) {
+        write_varint(buffer_, event.start_level);
+        buffer_.push_back(event.difficulty);
+    }
+}
+
+void ReplayWriter::input(std::uint64_t frame, const InputCommand& input) {
+    begin_record(frame, static_cast<std::uint8_t>(RecordKind::Input));
+    write_varint(buffer_, input.player_id);
+    write_varint(buffer_, input.input_mask);
+    write_varint(buffer_, input.client_time_ms);
+    write_varint(buffer_, input.sequence);
+    write_varint(buffer_, input.view_tick);
+}
+
+void ReplayWriter::end_frame(std::uint64_t frame) {
+    frames_ = frame + 1;
+    if (frames_ % kFlushFrames == 0) {
+        begin_record(frames_, static_cast<std::uint8_t>(RecordKind::Frames));
+        flush();
+    }
+}
+
+void ReplayWriter::flush() {
+    if (!is_open() || buffer_.empty()) {
+        return;
+    }
+    file_.write(reinterpret_cast<const char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()));
+    file_.flush();
+    buffer_.clear();
+}
+
+// =========================
+// READER
+// =========================
+
+std::optional<Replay> load_replay(const std::string& path, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "cannot open " + path;
+        return std::nullopt;
+    }
+    const std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(kReplayMagic) + 1 || !std::equal(std::begin(kReplayMagic), std::end(kReplayMagic), data.begin())) {
+        error = path + " is not a replay file";
+        return std::nullopt;
+    }
+    if (data[sizeof(kReplayMagic)] != kReplayVersion) {
+        error = "unsupported replay version " + std::to_string(data[sizeof(kReplayMagic)]);
+        return std::nullopt;
+    }
+
+    Replay replay;
+    Cursor in{data, sizeof(kReplayMagic) + 1};
+    auto& header = replay.header;
+    header.room_id = in.narrow<std::uint16_t>();
+    for (int i = 0; i < 8; ++i) {
+        header.seed |= static_cast<std::uint64_t>(in.byte()) << (8 * i);
+    }
+    header.settings.difficulty = in.signed_int();
+    header.settings.enemies_per_wave = in.signed_int();
+    header.settings.kills_per_wave = in.signed_int();
+    header.settings.player_lives = in.signed_int();
+    header.settings.infinite_lives = in.byte() != 0;
+    const auto spawn_rate = in.narrow<std::uint32_t>();
+    std::memcpy(&header.settings.enemy_spawn_rate, &spawn_rate, sizeof(spawn_rate));
+    if (!in.ok) {
+        error = path + ": truncated header";
+        return std::nullopt;
+    }
+
+    std::uint64_t frame = 0;
+    while (!in.at_end()) {
+        const auto record_start = in.pos;
+        frame += in.varint();
+        const auto kind = static_cast<RecordKind>(in.byte());
+        if (kind == RecordKind::End) {
+            replay.frames = frame;
+            replay.complete = in.ok;
+            break;
+        }
+        if (kind == RecordKind::Frames) {
+            replay.frames = std::max(replay.frames, frame);
+        } else if (kind == RecordKind::Joined || kind == RecordKind::Left) {
+            PlayerEvent event{.kind = kind == RecordKind::Joined ? PlayerEvent::Kind::Joined : PlayerEvent::Kind::Left};
+            event.player_id = in.narrow<std::uint16_t>();
+            if (kind == RecordKind::Joined) {
+                event.start_level = in.narrow<std::uint16_t>();
+                event.difficulty = in.byte();
+            }
+            if (in.ok) {
+                replay.events.emplace_back(frame, event);
+            }
+        } else if (kind == RecordKind::Input) {
+            InputCommand input;
+            input.player_id = in.narrow<std::uint16_t>();
+            input.input_mask = in.narrow<std::uint16_t>();
+            input.client_time_ms = in.narrow<std::uint32_t>();
+            input.sequence = in.narrow<std::uint32_t>();
+            input.view_tick = in.narrow<std::uint32_t>();
+            if (in.ok) {
+                replay.inputs.emplace_back(frame, input);
+            }
+        } else {
+            in.ok = false;
+        }
+        if (!in.ok) {
+            if (in.pos - record_start > 0 && in.at_end()) {
+                break;  // Cut mid-record by a crash: keep what came before
+            }
+            error = path + ": corrupt record at byte " + std::to_string(record_start);
+            return std::nullopt;
+        }
+        if (kind != RecordKind::Frames) {
+            replay.frames = std::max(replay.frames, frame + 1);
+        }
+    }
+    return replay;
+}
+
+// =========================
+// PLAYBACK
+// =========================
+
+std::optional<PlayerEvent> ReplayLink::poll_event() {
+    if (next_event_ >= replay_.events.size() || replay_.events[next_event_].first != frame_) {
+        return std::nullopt;
+    }
+    const auto& event = replay_.events[next_event_++].second;
+    if (event.kind == PlayerEvent::Kind::Joined) {
+        players_.insert(event.player_id);
+    } else {
+        players_.erase(event.player_id);
+    }
+    return event;
+}
+
+std::optional<InputCommand> ReplayLink::poll_input() {
+    if (next_input_ >= replay_.inputs.size() || replay_.inputs[next_input_].first != frame_) {
+        return std::nullopt;
+    }
+    return replay_.inputs[next_input_++].second;
+}
+
+void ReplayLink::broadcast_snapshot(const NetworkServer::SnapshotEncoder& encoder) {
+    // The match captured tick `broadcasts_`; every player acknowledged the one before.
+    const std::uint32_t acked = broadcasts_ >= 2 ? broadcasts_ - 1 : 0;
+    for (const auto player_id : players_) {
+        snapshot_bytes_ += encoder(player_id, acked, engine::net::SendRate{}).blob.size();
+    }
+    ++broadcasts_;
+}
+
+int run_replay(const std::string& path) {
+    std::string error;
+    const auto replay = load_replay(path, error);
+    if (!replay) {
+        std::cerr << "[replay] " << error << "\n";
+        return 1;
+    }
+    std::cout << "[replay] " << path << ": room " << replay->header.room_id << ", seed " << replay->header.seed
+              << ", " << replay->frames << " frames, " << replay->events.size() << " player events, "
+              << replay->inputs.size() << " inputs" << (replay->complete ? "" : " (truncated)") << "\n";
+
+    ReplayLink link(*replay);
+    MatchOptions options;
+    options.seed = replay->header.seed;
+    options.settings = &replay->header.settings;
+    Match match(replay->header.room_id, link, options);
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t frame = 0; frame < replay->frames; ++frame) {
+        link.set_frame(frame);
+        match.tick();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const auto metrics = match.metrics().read();
+    const auto ms = [](std::chrono::nanoseconds value) {
+        return std::chrono::duration<double, std::milli>(value).count();
+    };
+    const double realtime = static_cast<double>(replay->frames) / NetworkServer::kTickRate;
+    std::cout << std::fixed << std::setprecision(3) << "[replay] " << replay->frames << " ticks in "
+              << elapsed.count() << " s (" << std::setprecision(1)
+              << realtime / std::max(elapsed.count(), 1e-9) << "x real time)\n"
+              << std::setprecision(3) << "[replay] tick p50 " << ms(metrics.tick_time.percentile(0.5)) << " ms, p99 "
+              << ms(metrics.tick_time.percentile(0.99)) << " ms, max " << ms(metrics.tick_time.max()) << " ms\n";
+    for (std::size_t i = 0; i < kTimedSystemCount; ++i) {
+        std::cout << "[replay]   " << std::left << std::setw(12) << kTimedSystemNames[i] << std::right << std::setw(10)
+                  << ms(metrics.system_time[i]) << " ms\n";
+    }
+    std::cout << "[replay] snapshots " << link.snapshot_bytes() << " B, events " << link.event_bytes() << " B\n"
+              << "[replay] final state checksum " << std::hex << std::setw(16) << std::setfill('0')
+              << match.state_checksum() << std::dec << std::setfill(' ') << "\n";
+    return 0;
+}
+
+}  // namespace server
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "engine/game/game_settings.hpp"
+#include "room_link.hpp"
+
+namespace server {
+
+/**
+ * Replay files: everything a match needs to run again tick for tick, without clients.
+ *
+ * A frame is one Match::tick() call, lobby ticks included. The file holds a header
+ * (room, match seed, the gameplay settings) and then, frame by frame, the player
+ * events and inputs the match polled, each as [frame delta][kind][fields] in LEB128
+ * varints: a few bytes per input. Each flush and the End record carry the frame count,
+ * so a file cut short by a crash still replays up to its last flush.
+ */
+inline constexpr char kReplayMagic[4] = {'R', 'T', 'R', 'P'};
+inline constexpr std::uint8_t kReplayVersion = 2;  // 2: seeds key Philox streams (engine::core::RandomSource)
+
+struct ReplayHeader {
+    std::uint16_t room_id{0};
+    std::uint64_t seed{0};
+    engine::game::GameSettings settings;  // Gameplay fields only; the rest keep their defaults
+};
+
+struct Replay {
+    ReplayHeader header;
+    std::vector<std::pair<std::uint64_t, PlayerEvent>> events;  // (frame, event), in order
+    std::vector<std::pair<std::uint64_t, InputCommand>> inputs;
+    std::uint64_t frames{0};
+    bool complete{false};  // Ended with an End record
+};
+
+// Loads a whole replay; nullopt (and `error`) if the file is not one.
+std::optional<Replay> load_replay(const std::string& path, std::string& error);
+
+/**
+ * @brief Appends a match's inputs to a replay file as it runs. Tick thread only.
+ *
+ * Records are buffered and written every kFlushFrames frames, so recording costs a
+ * few byte pushes per input and one small write a second.
+ */
+class ReplayWriter {
+public:
+    static constexpr std::uint64_t kFlushFrames = 60;
+
+    // Check is_open(); the constructor does not throw on I/O errors.
+    ReplayWriter(const std::string& path, const ReplayHeader& header);
+    ~ReplayWriter();
+
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+    bool is_open() const { return file_.is_open(); }
+
+    void event(std::uint64_t frame, const PlayerEvent& event);
+    void input(std::uint64_t frame, const InputCommand& input);
+    // Called after every frame, recorded or not.
+    void end_frame(std::uint64_t frame);
+
+private:
+    void begin_record(std::uint64_t frame, std::uint8_t kind);
+    void flush();
+
+    std::ofstream file_;
+    std::vector<std::uint8_t> buffer_;
+    std::uint64_t last_frame_{0};  // Frame of the previous record, for the deltas
+    std::uint64_t frames_{0};
+};
+
+/**
+ * @brief RoomLink that plays a Replay back: hands the match each frame's events and
+ * inputs, and swallows what it sends.
+ *
+ * Snapshots are still encoded for every joined player, as one-tick deltas (a client
+ * on a clean link), so a replay measures the same simulation and encoding work as
+ * the live match; only the sockets are missing.
+ */
+class ReplayLink final : public RoomLink {
+public:
+    explicit ReplayLink(const Replay& replay) : replay_(replay) {}
+
+    // Frame the next Match::tick() runs.
+    void set_frame(std::uint64_t frame) { frame_ = frame; }
+
+    std::optional<InputCommand> poll_input() override;
+    std::optional<PlayerEvent> poll_event() override;
+    void broadcast_snapshot(const NetworkServer::SnapshotEncoder& encoder) override;
+    void send_event(std::span<const std::uint8_t> event) override { event_bytes_ += event.size(); }
+    void flush_events() override {}
+
+    std::uint64_t snapshot_bytes() const { return snapshot_bytes_; }
+    std::uint64_t event_bytes() const { return event_bytes_; }
+
+private:
+    const Replay& replay_;
+    std::uint64_t frame_{0};
+    std::size_t next_event_{0};
+    std::size_t next_input_{0};
+    std::unordered_set<std::uint16_t> players_;
+    std::uint32_t broadcasts_{0};
+    std::uint64_t snapshot_bytes_{0};
+    std::uint64_t event_bytes_{0};
+};
+
+// `rtype_server --replay <file>`: runs the replay headlessly, as fast as possible, and
+// prints the timings and a checksum of the final world. Returns the process exit code.
+int run_replay(const std::string& path);
+
+}  // namespace server
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "network_server.hpp"
+
+namespace server {
+
+/**
+ * @brief What a Match sees of the outside world: its room's queues and sends.
+ *
+ * NetworkRoomLink forwards to the NetworkServer; ReplayLink (replay.hpp) feeds a
+ * recorded session instead, so a match runs the same with or without sockets.
+ * Every call comes from the room's tick thread, except broadcast_snapshot when the
+ * match pipelines its snapshots: then it comes from the room's snapshot thread.
+ */
+class RoomLink {
+public:
+    virtual ~RoomLink() = default;
+
+    virtual std::optional<InputCommand> poll_input() = 0;
+    virtual std::optional<PlayerEvent> poll_event() = 0;
+    virtual void broadcast_snapshot(const NetworkServer::SnapshotEncoder& encoder) = 0;
+    virtual void send_event(std::span<const std::uint8_t> event) = 0;
+    virtual void flush_events() = 0;
+};
+
+class NetworkRoomLink final : public RoomLink {
+public:
+    NetworkRoomLink(NetworkServer& server, std::uint16_t room_id) : server_(server), room_id_(room_id) {}
+
+    std::optional<InputCommand> poll_input() override { return server_.poll_input(room_id_); }
+    std::optional<PlayerEvent> poll_event() override { return server_.poll_event(room_id_); }
+    void broadcast_snapshot(const NetworkServer::SnapshotEncoder& encoder) override {
+        server_.broadcast_snapshot(room_id_, encoder);
+    }
+    void send_event(std::span<const std::uint8_t> event) override { server_.send_event(room_id_, event); }
+    void flush_events() override { server_.flush_events(room_id_); }
+
+private:
+    NetworkServer& server_;
+    std::uint16_t room_id_;
+};
+
+}  // namespace server
@@ -0,0 +1,192 @@
+#include "room_manager.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace server {
+
+RoomManager::RoomManager(NetworkServer& server,
+                         std::size_t worker_count,
+                         engine::core::TickClock::Options tick,
+                         const std::string& record_dir,
+                         bool pipelined_snapshots)
+    : server_(server), tick_options_(tick), pipelined_snapshots_(pipelined_snapshots) {
+    tick_options_.ticks_per_second = NetworkServer::kTickRate;
+    const std::size_t rooms = server_.room_count();
+    const std::size_t cores = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    worker_count_ = std::clamp<std::size_t>(worker_count == 0 ? std::min(rooms, cores) : worker_count, 1, rooms);
+    worker_metrics_ = std::vector<WorkerMetrics>(worker_count_);
+    snapshot_signals_ = std::vector<SnapshotSignal>(worker_count_);
+
+    // Built here, on one thread: matches load (and may create) the settings file.
+    // Each match gets a fresh seed, kept in its recording so the match can be replayed.
+    std::random_device entropy;
+    links_.reserve(rooms);
+    matches_.reserve(rooms);
+    for (std::size_t room_id = 0; room_id < rooms; ++room_id) {
+        const auto id = static_cast<std::uint16_t>(room_id);
+        MatchOptions options;
+        options.seed = (static_cast<std::uint64_t>(entropy()) << 32) | entropy();
+        options.pipelined_snapshots = pipelined_snapshots_;
+        if (!record_dir.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(record_dir, ec);
+            options.record_path = (std::filesystem::path(record_dir) /
+                                   ("room" + std::to_string(room_id) + "-" + std::to_string(options.seed) + ".rtrp"))
+                                      .string();
+        }
+        links_.push_back(std::make_unique<NetworkRoomLink>(server_, id));
+        matches_.push_back(std::make_unique<Match>(id, *links_.back(), options));
+    }
+}
+
+RoomManager::~RoomManager() {
+    stop();
+}
+
+void RoomManager::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    const std::size_t cores = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    workers_.reserve(worker_count_);
+    for (std::size_t worker = 0; worker < worker_count_; ++worker) {
+        workers_.emplace_back([this, worker] { worker_loop(worker); });
+        pin_to_core(workers_.back(), worker % cores);
+        if (pipelined_snapshots_) {
+            snapshot_threads_.emplace_back([this, worker] { snapshot_loop(worker); });
+        }
+    }
+    std::cout << "[rooms] " << matches_.size() << " room(s) on " << worker_count_ << " worker thread(s)"
+              << (pipelined_snapshots_ ? ", snapshots on their own threads\n" : ", snapshots inline\n");
+}
+
+void RoomManager::stop() {
+    running_ = false;
+    for (auto& signal : snapshot_signals_) {
+        // Under the lock, so a snapshot thread cannot miss it between its check and its wait.
+        std::lock_guard<std::mutex> lock(signal.mutex);
+        signal.ready.notify_one();
+    }
+    join();
+}
+
+void RoomManager::join() {
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+    for (auto& thread : snapshot_threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    snapshot_threads_.clear();
+}
+
+std::vector<Match*> RoomManager::worker_rooms(std::size_t worker_index) const {
+    std::vector<Match*> rooms;
+    for (std::size_t room_id = worker_index; room_id < matches_.size(); room_id += worker_count_) {
+        rooms.push_back(matches_[room_id].get());
+    }
+    return rooms;
+}
+
+void RoomManager::worker_loop(std::size_t worker_index) {
+    const auto rooms = worker_rooms(worker_index);
+
+    using Clock = engine::core::TickClock::Clock;
+    engine::core::TickClock clock(tick_options_);
+    clock.reset(Clock::now());
+    auto next_report = Clock::now() + kStatsInterval;
+    auto& metrics = worker_metrics_[worker_index];
+    std::uint64_t overruns = 0;  // Up to the last report, which resets the clock's stats
+    std::uint64_t skipped = 0;
+    while (running_) {
+        clock.wait();
+        const auto started = Clock::now();
+        for (auto* match : rooms) {
+            match->tick();
+        }
+        if (pipelined_snapshots_) {
+            auto& signal = snapshot_signals_[worker_index];
+            {
+                std::lock_guard<std::mutex> lock(signal.mutex);
+                ++signal.rounds;
+            }
+            signal.ready.notify_one();
+        }
+        const auto finished = Clock::now();
+        clock.finish_tick(started, finished);
+        metrics.ticks.fetch_add(1, std::memory_order_relaxed);
+        metrics.overruns.store(overruns + clock.stats().overruns, std::memory_order_relaxed);
+        metrics.skipped.store(skipped + clock.stats().skipped, std::memory_order_relaxed);
+        if (finished >= next_report) {
+            report_ticks(worker_index, clock.stats());
+            overruns += clock.stats().overruns;
+            skipped += clock.stats().skipped;
+            clock.reset_stats();
+            next_report = finished + kStatsInterval;
+        }
+    }
+}
+
+void RoomManager::snapshot_loop(std::size_t worker_index) {
+    const auto rooms = worker_rooms(worker_index);
+    auto& signal = snapshot_signals_[worker_index];
+    std::uint64_t rounds = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(signal.mutex);
+            signal.ready.wait(lock, [&] { return signal.rounds != rounds || !running_; });
+            if (!running_) {
+                return;
+            }
+            rounds = signal.rounds;
+        }
+        // Rounds that came in meanwhile were folded into the newest sample by the match.
+        for (auto* match : rooms) {
+            match->send_snapshot();
+        }
+    }
+}
+
+void RoomManager::report_ticks(std::size_t worker_index, const engine::core::TickStats& stats) {
+    const auto ms = [](std::chrono::nanoseconds value) {
+        return std::chrono::duration<double, std::milli>(value).count();
+    };
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(2) << "[rooms] Worker " << worker_index << ": "
+         << stats.work.count() << " ticks, work p50 " << ms(stats.work.percentile(0.5)) << " ms, p99 "
+         << ms(stats.work.percentile(0.99)) << " ms, max " << ms(stats.work.max()) << " ms; interval p99 "
+         << ms(stats.interval.percentile(0.99)) << " ms; " << stats.overruns << " overrun(s), " << stats.skipped
+         << " skipped\n";
+    std::cout << line.str();
+}
+
+void RoomManager::pin_to_core(std::thread& thread, std::size_t core) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    if (pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) != 0) {
+        std::cerr << "[rooms] Could not pin worker to core " << core << "\n";
+    }
+#else
+    (void)thread;
+    (void)core;
+#endif
+}
+
+}  // namespace server
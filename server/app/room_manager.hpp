@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine/core/tick_clock.hpp"
+#include "match.hpp"
+#include "metrics.hpp"
+#include "network_server.hpp"
+
+namespace server {
+
+/**
+ * @brief Owns every match of the process and the worker threads that tick them.
+ *
+ * Room `r` runs on worker `r % worker_count`, so a match always ticks on the
+ * same thread; on Linux worker `w` is also pinned to core `w % cores`. Each
+ * worker ticks its rooms back to back on a TickClock at NetworkServer::kTickRate, and logs its
+ * tick timings every kStatsInterval. Rooms are created up front and live until
+ * the manager is destroyed.
+ *
+ * With pipelined snapshots every worker has a snapshot thread beside it, left
+ * unpinned: after each round of ticks the worker wakes it, and it encodes and sends
+ * the snapshots of the same rooms while the worker waits for the next tick.
+ */
+class RoomManager {
+public:
+    static constexpr std::chrono::seconds kStatsInterval{10};
+
+    // `worker_count` 0 picks min(room_count, hardware threads). `ticks_per_second` in
+    // `tick` is ignored: every worker runs at
+    // NetworkServer::kTickRate. A non-empty `record_dir` records every room to a replay
+    // file there (room<id>-<seed>.rtrp). `pipelined_snapshots` false sends each room's
+    // snapshots from its tick instead of a snapshot thread.
+    RoomManager(NetworkServer& server,
+                std::size_t worker_count = 0,
+                engine::core::TickClock::Options tick = {},
+                const std::string& record_dir = {},
+                bool pipelined_snapshots = true);
+    ~RoomManager();
+
+    RoomManager(const RoomManager&) = delete;
+    RoomManager& operator=(const RoomManager&) = delete;
+
+    void start();
+    void stop();
+    // Blocks until stop() is called from another thread.
+    void join();
+
+    std::size_t worker_count() const { return worker_count_; }
+    std::size_t room_count() const { return matches_.size(); }
+
+    // For the metrics endpoint; safe to read from any thread.
+    const Match& match(std::size_t room_id) const { return *matches_[room_id]; }
+    const WorkerMetrics& worker_metrics(std::size_t worker_index) const { return worker_metrics_[worker_index]; }
+
+private:
+    // A worker's rounds of ticks, counted for its snapshot thread.
+    struct SnapshotSignal {
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::uint64_t rounds{0};
+    };
+
+    std::vector<Match*> worker_rooms(std::size_t worker_index) const;
+    void worker_loop(std::size_t worker_index);
+    void snapshot_loop(std::size_t worker_index);
+    static void report_ticks(std::size_t worker_index, const engine::core::TickStats& stats);
+    static void pin_to_core(std::thread& thread, std::size_t core);
+
+    NetworkServer& server_;
+    std::size_t worker_count_;
+    engine::core::TickClock::Options tick_options_;
+    std::vector<std::unique_ptr<NetworkRoomLink>> links_;  // Indexed by room id
+    std::vector<std::unique_ptr<Match>> matches_;         // Indexed by room id
+    bool pipelined_snapshots_;
+    std::vector<std::thread> workers_;
+    std::vector<std::thread> snapshot_threads_;  // Indexed like workers_, empty unless pipelined
+    std::vector<WorkerMetrics> worker_metrics_;  // Indexed like workers_, fixed after construction
+    std::vector<SnapshotSignal> snapshot_signals_;  // Indexed like workers_, fixed after construction
+    std::atomic_bool running_{false};
+};
+
+}  // namespace server
@@ -1,14 +1,31 @@
 #include "apply_input_system.hpp"
 
+#include "engine/game/components/core/position.hpp"
 #include "engine/game/components/core/velocity.hpp"
 #include "engine/game/components/gameplay/faction.hpp"
 #include "engine/game/components/gameplay/input_state.hpp"
 #include "engine/game/components/gameplay/spectator.hpp"
+#include "engine/game/systems/world/movement_system.hpp"
 
+#include <algorithm>
 #include <iostream>
 
 namespace server::systems {
 
+namespace {
+constexpr std::uint16_t kInputShoot = 1u << 4;
+constexpr std::uint16_t kInputUltimate = 1u << 6;
+
+void apply_mask(engine::game::components::InputState& input, std::uint16_t mask) {
+    input.up    = (mask & (1u << 0)) != 0;
+    input.down  = (mask & (1u << 1)) != 0;
+    input.left  = (mask & (1u << 2)) != 0;
+    input.right = (mask & (1u << 3)) != 0;
+    input.shoot = (mask & kInputShoot) != 0;
+    input.ultimate = (mask & kInputUltimate) != 0;
+}
+}  // namespace
+
 void ApplyInputSystem::register_player_entity(std::uint16_t player_id,
                                              std::uint16_t entity_id) {
     player_to_entity_[player_id] = entity_id;
@@ -18,19 +35,42 @@ void ApplyInputSystem::register_player_entity(std::uint16_t player_id,
 
 void ApplyInputSystem::set_player_input(std::uint16_t player_id,
                                        std::uint16_t input_mask,
-                                       std::uint32_t sequence) {
+                                       std::uint32_t sequence,
+                                       std::uint32_t client_time_ms,
+                                       std::uint8_t view_delay_ticks) {
     auto& buffer = player_inputs_[player_id];
 
-    // Drop duplicate or out-of-order packets
+    // Drop packets older than what the last tick consumed
     if (sequence <= buffer.last_sequence) {
         return;
     }
 
-    buffer.last_sequence = sequence;
-    buffer.last_input_mask = input_mask;
+    auto* begin = buffer.pending.data();
+    auto* end = begin + buffer.pending_count;
+    auto* slot = std::lower_bound(begin, end, sequence,
+                                  [](const TimedInput& input, std::uint32_t seq) { return input.sequence < seq; });
+    if (slot != end && slot->sequence == sequence) {
+        return;  // Duplicate
+    }
+    if (buffer.pending_count == kInputRingSize) {
+        // Full: consume the oldest now, it would have been held for an instant at most.
+        if (slot == begin) {
+            return;
+        }
+        buffer.last_sequence = begin->sequence;
+        buffer.last_input_mask = begin->input_mask;
+        buffer.view_delay_ticks = begin->view_delay_ticks;
+        std::move(begin + 1, slot, begin);
+        --slot;
+        --end;
+        --buffer.pending_count;
+    }
+    std::move_backward(slot, end, end + 1);
+    *slot = TimedInput{sequence, input_mask, client_time_ms, view_delay_ticks};
+    ++buffer.pending_count;
 }
 
-void ApplyInputSystem::update(rtype::ecs::registry& registry) {
+void ApplyInputSystem::update(rtype::ecs::registry& registry, float dt) {
     auto& velocities   = registry.get_components<engine::game::components::Velocity>();
     auto& input_states = registry.get_components<engine::game::components::InputState>();
 
@@ -57,15 +97,61 @@ void ApplyInputSystem::update(rtype::ecs::registry& registry) {
         auto& input = *input_states[entity_id];
 
         auto it = player_inputs_.find(player_id);
-        std::uint16_t mask =
-            (it == player_inputs_.end()) ? 0u : it->second.last_input_mask;
-
-        input.up    = (mask & (1u << 0)) != 0;
-        input.down  = (mask & (1u << 1)) != 0;
-        input.left  = (mask & (1u << 2)) != 0;
-        input.right = (mask & (1u << 3)) != 0;
-        input.shoot = (mask & (1u << 4)) != 0;
-        input.ultimate = (mask & (1u << 6)) != 0;
+        if (it == player_inputs_.end()) {
+            apply_mask(input, 0);
+            input.shoot_tapped = false;
+            continue;
+        }
+        auto& buffer = it->second;
+
+        // Walk the tick: each mask is held from its input's offset until the next one.
+        std::uint16_t mask = buffer.last_input_mask;
+        std::uint16_t pressed = 0;  // Bits held at any point during the tick
+        float held_from = 0.0f;
+        float dx = 0.0f;
+        float dy = 0.0f;
+        bool tapped = false;
+        float lead = 0.0f;
+        auto hold = [&](float until) {
+            engine::game::components::InputState held{};
+            apply_mask(held, mask);
+            const auto velocity = rtype::game::player_velocity(held);
+            dx += velocity.vx * (until - held_from);
+            dy += velocity.vy * (until - held_from);
+            held_from = until;
+        };
+        const auto first_time = buffer.pending[0].client_time_ms;
+        for (std::size_t i = 0; i < buffer.pending_count; ++i) {
+            const auto& next = buffer.pending[i];
+            const auto since_first = static_cast<std::int32_t>(next.client_time_ms - first_time);
+            const float at = std::clamp(static_cast<float>(since_first) / 1000.0f, held_from, dt);
+            hold(at);
+            if (!tapped && (mask & kInputShoot) == 0 && (next.input_mask & kInputShoot) != 0) {
+                tapped = true;
+                lead = dt - at;
+            }
+            mask = next.input_mask;
+            pressed |= mask;
+            buffer.last_sequence = next.sequence;
+            buffer.view_delay_ticks = next.view_delay_ticks;
+        }
+        hold(dt);
+        buffer.pending_count = 0;
+        buffer.last_input_mask = mask;
+
+        apply_mask(input, mask);
+        input.ultimate = input.ultimate || (pressed & kInputUltimate) != 0;  // A tap still counts
+        input.shoot_tapped = tapped;
+        input.shoot_lead = lead;
+        input.view_delay_ticks = buffer.view_delay_ticks;
+
+        // MovementSystem moves the ship at the newest mask's velocity for the whole tick;
+        // make up the difference for the time the earlier masks were held.
+        if (auto* position = registry.try_get<engine::game::components::Position>(entity)) {
+            const auto velocity = rtype::game::player_velocity(input);
+            position->x += dx - velocity.vx * dt;
+            position->y += dy - velocity.vy * dt;
+        }
     }
 }
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "engine/core/registry.hpp"
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <unordered_map>
 #include "engine/game/components/gameplay/input_state.hpp"
@@ -23,26 +25,50 @@ public:
     void register_player_entity(std::uint16_t player_id, std::uint16_t entity_id);
 
     /**
-     * @brief Store input for a specific player
+     * @brief Queue an input for a specific player
      * @param player_id Player identifier
      * @param input_mask Bitmask of pressed keys
+     * @param sequence Packet sequence; orders the player's inputs, duplicates are dropped
+     * @param client_time_ms Client clock when the input was sampled
+     * @param view_delay_ticks Age in ticks of the snapshot the player saw when sending it
      */
     void set_player_input(std::uint16_t player_id,
                         std::uint16_t input_mask,
-                        std::uint32_t sequence);
+                        std::uint32_t sequence,
+                        std::uint32_t client_time_ms,
+                        std::uint8_t view_delay_ticks = 0);
 
     /**
-     * @brief Apply stored inputs to player entities
+     * @brief Apply every queued input to player entities, in sequence order
+     *
+     * The inputs received during a tick are laid out on it by client timestamp,
+     * the first one at the start of the tick; each mask holds until the next.
+     * InputState ends up with the newest mask, which MovementSystem integrates over
+     * the whole tick, and the position is corrected for the time the earlier masks
+     * were held. A trigger pressed anywhere in the tick sets InputState::shoot_tapped.
      * @param registry ECS registry containing entities
+     * @param dt Tick duration in seconds
      */
-    void update(rtype::ecs::registry& registry);
+    void update(rtype::ecs::registry& registry, float dt);
     void remove_player(std::uint16_t player_id, rtype::ecs::registry& registry);
 
 
 private:
+    struct TimedInput {
+        std::uint32_t sequence = 0;
+        std::uint16_t input_mask = 0;
+        std::uint32_t client_time_ms = 0;
+        std::uint8_t view_delay_ticks = 0;
+    };
+
+    static constexpr std::size_t kInputRingSize = 32;  // Inputs queued per player between two ticks
+
     struct PlayerInputBuffer {
-        std::uint32_t last_sequence = 0;
-        std::uint16_t last_input_mask = 0;
+        std::array<TimedInput, kInputRingSize> pending{};  // Sorted by sequence
+        std::size_t pending_count = 0;
+        std::uint32_t last_sequence = 0;    // Newest input consumed
+        std::uint16_t last_input_mask = 0;  // Held since the previous tick
+        std::uint8_t view_delay_ticks = 0;  // Of the newest input consumed
     };
 
     std::unordered_map<std::uint16_t, PlayerInputBuffer> player_inputs_;
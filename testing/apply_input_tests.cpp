@@ -0,0 +1,101 @@
+#include <doctest/doctest.h>
+
+#include <cstdint>
+
+#include "apply_input_system.hpp"
+#include "engine/core/registry.hpp"
+#include "engine/game/components/core/position.hpp"
+#include "engine/game/components/core/velocity.hpp"
+#include "engine/game/components/gameplay/faction.hpp"
+#include "engine/game/components/gameplay/input_state.hpp"
+#include "engine/game/systems/world/movement_system.hpp"
+
+namespace {
+
+constexpr float kDt = 1.0f / 60.0f;
+constexpr std::uint16_t kRight = 1u << 3;
+constexpr std::uint16_t kShoot = 1u << 4;
+constexpr std::uint16_t kPlayerId = 1;
+
+struct World {
+    rtype::ecs::registry reg;
+    rtype::ecs::entity_t ship{0};
+    server::systems::ApplyInputSystem inputs;
+    rtype::game::MovementSystem movement;
+
+    World() {
+        reg.register_component<engine::game::components::Position>();
+        reg.register_component<engine::game::components::Velocity>();
+        reg.register_component<engine::game::components::InputState>();
+        reg.register_component<engine::game::components::FactionComponent>();
+        ship = reg.spawn_entity();
+        reg.emplace_component<engine::game::components::Position>(ship, 100.f, 100.f);
+        reg.emplace_component<engine::game::components::Velocity>(ship, 0.f, 0.f);
+        reg.emplace_component<engine::game::components::FactionComponent>(ship, engine::game::components::Faction::PLAYER);
+        inputs.register_player_entity(kPlayerId, static_cast<std::uint16_t>(static_cast<std::size_t>(ship)));
+    }
+
+    void tick() {
+        inputs.update(reg, kDt);
+        movement.run(reg, kDt);
+    }
+
+    const engine::game::components::InputState& input() {
+        return *reg.try_get<engine::game::components::InputState>(ship);
+    }
+    float x() { return reg.try_get<engine::game::components::Position>(ship)->x; }
+};
+
+}  // namespace
+
+TEST_CASE("a key held for part of a tick moves the ship for just that long") {
+    World world;
+    world.inputs.set_player_input(kPlayerId, kRight, 1, 1000);
+    world.inputs.set_player_input(kPlayerId, 0, 2, 1008);  // Released 8 ms later, same tick
+    world.tick();
+    CHECK_FALSE(world.input().right);
+    CHECK(world.x() == doctest::Approx(100.f + 200.f * 0.008f));
+
+    // Pressed again 4 ms into the next tick: held for the remaining 12.7 ms.
+    world.inputs.set_player_input(kPlayerId, kRight, 3, 2000);
+    world.tick();
+    const float before = world.x();
+    world.inputs.set_player_input(kPlayerId, 0, 4, 3000);
+    world.inputs.set_player_input(kPlayerId, kRight, 5, 3004);
+    world.tick();
+    CHECK(world.x() - before == doctest::Approx(200.f * (kDt - 0.004f)));
+}
+
+TEST_CASE("a shot tapped within one tick is not lost") {
+    World world;
+    world.inputs.set_player_input(kPlayerId, kShoot, 1, 500);
+    world.inputs.set_player_input(kPlayerId, 0, 2, 505);
+    world.tick();
+    CHECK_FALSE(world.input().shoot);
+    CHECK(world.input().shoot_tapped);
+    CHECK(world.input().shoot_lead == doctest::Approx(kDt));
+
+    world.tick();
+    CHECK_FALSE(world.input().shoot_tapped);
+}
+
+TEST_CASE("inputs are consumed in sequence order, once") {
+    World world;
+    world.inputs.set_player_input(kPlayerId, kShoot, 3, 1010);
+    world.inputs.set_player_input(kPlayerId, kRight, 1, 1000);
+    world.inputs.set_player_input(kPlayerId, 0, 2, 1005);
+    world.inputs.set_player_input(kPlayerId, 0, 2, 1005);  // Duplicate
+    world.tick();
+    // Right for 5 ms, then nothing, then the trigger from 10 ms on.
+    CHECK(world.x() == doctest::Approx(100.f + 200.f * 0.005f));
+    CHECK(world.input().shoot);
+    CHECK(world.input().shoot_tapped);
+    CHECK(world.input().shoot_lead == doctest::Approx(kDt - 0.010f));
+
+    // Anything at or before the last consumed sequence arrives too late.
+    world.inputs.set_player_input(kPlayerId, kRight, 2, 1005);
+    world.tick();
+    CHECK_FALSE(world.input().right);
+    CHECK(world.input().shoot);
+    CHECK_FALSE(world.input().shoot_tapped);
+}
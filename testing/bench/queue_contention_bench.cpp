@@ -0,0 +1,105 @@
+// Contention benchmark: engine::net::ThreadSafeQueue (mutex + condition variable)
+// versus the lock-free MpscRingQueue / SpscRingQueue used on the packet path.
+// N producer threads push, one consumer drains with try_pop(), like the server's
+// game thread polling inputs.
+//
+// Usage: rtype_queue_bench [items_per_producer] [max_producers]
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine/net/ring_queue.hpp"
+#include "engine/net/thread_safe_queue.hpp"
+
+namespace {
+
+// Roughly the size of a server InputCommand.
+struct Item {
+    std::uint16_t player_id{0};
+    std::uint16_t input_mask{0};
+    std::uint32_t client_time_ms{0};
+    std::uint32_t sequence{0};
+};
+
+template <typename Push, typename Pop>
+double run(std::size_t producers, std::size_t items_per_producer, Push push, Pop pop) {
+    const std::size_t total = producers * items_per_producer;
+    std::atomic_bool go{false};
+    std::vector<std::thread> threads;
+    threads.reserve(producers);
+    for (std::size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            while (!go) {
+                std::this_thread::yield();
+            }
+            for (std::size_t i = 0; i < items_per_producer; ++i) {
+                Item item{static_cast<std::uint16_t>(p), 0, 0, static_cast<std::uint32_t>(i)};
+                while (!push(item)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    go = true;
+    std::size_t received = 0;
+    while (received < total) {
+        if (pop()) {
+            ++received;
+        } else {
+            std::this_thread::yield();  // Stay fair when threads outnumber cores.
+        }
+    }
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return static_cast<double>(total) / seconds;
+}
+
+void print_row(const char* name, std::size_t producers, double ops) {
+    std::cout << "  " << std::left << std::setw(20) << name << std::right << std::setw(3) << producers
+              << " producer(s)" << std::setw(14) << static_cast<std::uint64_t>(ops) << " items/s\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t items = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const std::size_t max_producers = argc > 2 ? std::stoul(argv[2]) : 4;
+    constexpr std::size_t kCapacity = 1024;
+
+    std::cout << "[bench] " << items << " items per producer, ring capacity " << kCapacity << "\n";
+    for (std::size_t producers = 1; producers <= max_producers; producers *= 2) {
+        {
+            engine::net::ThreadSafeQueue<Item> queue;
+            print_row("ThreadSafeQueue", producers,
+                      run(producers, items,
+                          [&](const Item& item) { queue.push(item); return true; },
+                          [&] { return queue.try_pop().has_value(); }));
+        }
+        {
+            engine::net::MpscRingQueue<Item> queue(kCapacity);
+            print_row("MpscRingQueue", producers,
+                      run(producers, items,
+                          [&](const Item& item) { return queue.push(item); },
+                          [&] { return queue.try_pop().has_value(); }));
+        }
+        if (producers == 1) {
+            engine::net::SpscRingQueue<Item> queue(kCapacity);
+            print_row("SpscRingQueue", producers,
+                      run(producers, items,
+                          [&](const Item& item) { return queue.push(item); },
+                          [&] { return queue.try_pop().has_value(); }));
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,145 @@
+// Snapshot compression benchmark: size and per-snapshot cost of SnapshotCompressor
+// (engine/net/compression.hpp) on snapshots built by NetworkSendSystem, for full
+// snapshots and for one-tick deltas, with 'entities' moving entities in the world.
+//
+// Usage: rtype_compression_bench [entities] [ticks]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "engine/core/registry.hpp"
+#include "engine/game/components/core/position.hpp"
+#include "engine/game/components/core/velocity.hpp"
+#include "engine/game/components/gameplay/faction.hpp"
+#include "engine/game/components/gameplay/game_stats.hpp"
+#include "engine/game/components/gameplay/health.hpp"
+#include "engine/game/components/gameplay/lives.hpp"
+#include "engine/game/components/network/owner.hpp"
+#include "engine/game/systems/network/network_send_system.hpp"
+#include "engine/net/compression.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+namespace components = engine::game::components;
+
+struct Totals {
+    std::size_t snapshots{0};
+    std::size_t compressed{0};
+    std::size_t raw_bytes{0};
+    std::size_t wire_bytes{0};  // Compressed when it paid off, raw otherwise
+    double compress_us{0.0};
+    double inflate_us{0.0};
+};
+
+rtype::ecs::registry make_world(std::size_t entities) {
+    rtype::ecs::registry reg;
+    reg.register_component<components::Position>();
+    reg.register_component<components::Velocity>();
+    reg.register_component<components::GameStats>();
+    reg.register_component<components::Health>();
+    reg.register_component<components::Lives>();
+    reg.register_component<components::Owner>();
+    reg.register_component<components::FactionComponent>();
+    auto stats = reg.spawn_entity();
+    reg.emplace_component<components::GameStats>(stats, 0u, 1u);
+    for (std::size_t i = 0; i < entities; ++i) {
+        auto entity = reg.spawn_entity();
+        const bool player = i < 4;
+        reg.emplace_component<components::Position>(entity, static_cast<float>(i * 13 % 1920),
+                                                    static_cast<float>(i * 29 % 1080));
+        reg.emplace_component<components::Velocity>(entity, player ? 0.f : -120.f, 0.f);
+        reg.emplace_component<components::Health>(entity, player ? 100 : 30, player ? 100 : 30);
+        reg.emplace_component<components::FactionComponent>(
+            entity, player ? components::Faction::PLAYER : components::Faction::ENEMY);
+        if (player) {
+            reg.emplace_component<components::Lives>(entity, 3, 3);
+            reg.emplace_component<components::Owner>(entity, static_cast<std::uint16_t>(i + 1));
+        }
+    }
+    return reg;
+}
+
+void step(rtype::ecs::registry& reg) {
+    reg.view<components::Position>([&reg](auto entity, components::Position& position) {
+        if (const auto* velocity = reg.try_get<components::Velocity>(entity)) {
+            position.x += velocity->vx / 60.f;
+            if (position.x < 0.f) {
+                position.x += 1920.f;
+            }
+        }
+    });
+}
+
+void measure(const engine::net::SnapshotMessage& snapshot, engine::net::SnapshotCompressor& compressor, Totals& totals) {
+    static engine::net::SnapshotMessage compressed;
+    static std::vector<std::uint8_t> payload;
+    static std::vector<std::uint8_t> scratch;
+    ++totals.snapshots;
+    totals.raw_bytes += snapshot.blob.size();
+
+    const auto start = Clock::now();
+    const bool paid = compressor.compress(snapshot, compressed);
+    const auto compressed_at = Clock::now();
+    totals.compress_us += std::chrono::duration<double, std::micro>(compressed_at - start).count();
+    if (!paid) {
+        totals.wire_bytes += snapshot.blob.size();
+        return;
+    }
+    ++totals.compressed;
+    totals.wire_bytes += compressed.blob.size();
+
+    engine::net::encode_snapshot_payload(compressed, payload);
+    auto view = engine::net::decode_snapshot_view(payload);
+    const auto inflate_start = Clock::now();
+    if (!view || !engine::net::inflate_snapshot(*view, scratch) || scratch != snapshot.blob) {
+        std::cerr << "[bench] Round trip mismatch at tick " << snapshot.tick << "\n";
+        std::exit(1);
+    }
+    totals.inflate_us += std::chrono::duration<double, std::micro>(Clock::now() - inflate_start).count();
+}
+
+void print_row(const char* name, const Totals& totals) {
+    const auto n = static_cast<double>(std::max<std::size_t>(totals.snapshots, 1));
+    const auto kept = static_cast<double>(std::max<std::size_t>(totals.compressed, 1));
+    std::cout << "  " << std::left << std::setw(8) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(9) << static_cast<double>(totals.raw_bytes) / n << " B raw" << std::setw(9)
+              << static_cast<double>(totals.wire_bytes) / n << " B sent" << std::setw(7)
+              << 100.0 * static_cast<double>(totals.wire_bytes) / static_cast<double>(std::max<std::size_t>(totals.raw_bytes, 1))
+              << " %" << std::setw(6) << totals.compressed << "/" << totals.snapshots << " compressed"
+              << std::setprecision(2) << std::setw(8) << totals.compress_us / n << " us/compress" << std::setw(8)
+              << totals.inflate_us / kept << " us/inflate\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t entities = argc > 1 ? std::stoul(argv[1]) : 60;
+    const std::size_t ticks = argc > 2 ? std::stoul(argv[2]) : 2000;
+
+    auto reg = make_world(entities);
+    rtype::game::NetworkSendSystem send;
+    engine::net::SnapshotCompressor full_compressor;
+    engine::net::SnapshotCompressor delta_compressor;
+    Totals full;
+    Totals delta;
+    for (std::uint32_t tick = 1; tick <= ticks; ++tick) {
+        step(reg);
+        send.capture(reg, tick, false);
+        measure(send.snapshot_for(0), full_compressor, full);
+        if (tick > 1) {
+            measure(send.snapshot_for(tick - 1), delta_compressor, delta);
+        }
+    }
+
+    std::cout << "[bench] " << entities << " entities, " << ticks << " ticks\n";
+    print_row("full", full);
+    print_row("delta", delta);
+    return 0;
+}
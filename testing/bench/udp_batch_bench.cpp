@@ -0,0 +1,166 @@
+// Loopback throughput benchmark for engine::net::UdpSocket.
+// Compares one syscall per datagram (send_to / receive_from) against the
+// batched path (send_batch / receive_batch -> sendmmsg / recvmmsg on Linux).
+//
+// Usage: rtype_udp_bench [packet_count] [payload_bytes] [batch_size]
+
+#include <asio.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine/net/packet.hpp"
+#include "engine/net/udp_socket.hpp"
+
+namespace {
+
+constexpr std::uint8_t kStopMarker = 0xFF;
+
+// CPU time consumed by the calling thread, so results read as "packets per core".
+double thread_cpu_seconds() {
+#if defined(__linux__)
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+#else
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+struct SideResult {
+    std::size_t packets{0};
+    double wall_seconds{0.0};
+    double cpu_seconds{0.0};
+};
+
+struct RunResult {
+    SideResult sender;
+    SideResult receiver;
+};
+
+RunResult run(bool batched, std::size_t packet_count, std::size_t payload_bytes, std::size_t batch_size) {
+    asio::io_context io;
+    engine::net::UdpSocket receiver(io);
+    receiver.bind(0);
+    receiver.native().set_option(asio::socket_base::receive_buffer_size(4 * 1024 * 1024));
+    const asio::ip::udp::endpoint target(asio::ip::address_v4::loopback(),
+                                         receiver.native().local_endpoint().port());
+
+    engine::net::UdpSocket sender(io);
+    sender.bind(0);
+
+    RunResult result;
+    std::atomic_bool receiver_done{false};
+
+    std::thread receive_thread([&] {
+        std::vector<std::array<std::uint8_t, engine::net::kMaxPacketSize>> storage(batch_size);
+        std::vector<engine::net::IncomingDatagram> slots(batch_size);
+        for (std::size_t i = 0; i < batch_size; ++i) {
+            slots[i].buffer = storage[i];
+        }
+        const auto cpu_start = thread_cpu_seconds();
+        const auto wall_start = std::chrono::steady_clock::now();
+        bool stop = false;
+        while (!stop) {
+            std::error_code ec;
+            std::size_t received = 0;
+            if (batched) {
+                received = receiver.receive_batch(slots, ec);
+            } else {
+                slots[0].size = receiver.native().receive_from(
+                    asio::buffer(slots[0].buffer.data(), slots[0].buffer.size()), slots[0].endpoint, 0, ec);
+                received = ec ? 0 : 1;
+            }
+            for (std::size_t i = 0; i < received; ++i) {
+                if (slots[i].size > 0 && slots[i].buffer[0] == kStopMarker) {
+                    stop = true;
+                } else {
+                    ++result.receiver.packets;
+                }
+            }
+        }
+        result.receiver.wall_seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+        result.receiver.cpu_seconds = thread_cpu_seconds() - cpu_start;
+        receiver_done = true;
+    });
+
+    std::vector<std::uint8_t> payload(payload_bytes, 0x42);
+    std::vector<engine::net::OutgoingDatagram> batch(
+        batch_size, engine::net::OutgoingDatagram{payload, target});
+
+    const auto cpu_start = thread_cpu_seconds();
+    const auto wall_start = std::chrono::steady_clock::now();
+    std::size_t sent = 0;
+    while (sent < packet_count) {
+        std::error_code ec;
+        if (batched) {
+            const auto chunk = std::min(batch_size, packet_count - sent);
+            sent += sender.send_batch(std::span<const engine::net::OutgoingDatagram>(batch.data(), chunk), ec);
+        } else {
+            sender.native().send_to(asio::buffer(payload.data(), payload.size()), target, 0, ec);
+            if (!ec) {
+                ++sent;
+            }
+        }
+        if (ec) {
+            std::cerr << "[bench] send error: " << ec.message() << std::endl;
+            break;
+        }
+    }
+    result.sender.packets = sent;
+    result.sender.wall_seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    result.sender.cpu_seconds = thread_cpu_seconds() - cpu_start;
+
+    // Keep nudging the receiver until it has drained the socket and seen the marker.
+    const std::array<std::uint8_t, 1> stop{kStopMarker};
+    while (!receiver_done) {
+        std::error_code ec;
+        sender.native().send_to(asio::buffer(stop.data(), stop.size()), target, 0, ec);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    receive_thread.join();
+    return result;
+}
+
+void print_side(const char* label, const SideResult& side) {
+    const double pps = side.wall_seconds > 0.0 ? static_cast<double>(side.packets) / side.wall_seconds : 0.0;
+    const double per_core = side.cpu_seconds > 0.0 ? static_cast<double>(side.packets) / side.cpu_seconds : 0.0;
+    std::cout << "  " << std::left << std::setw(9) << label
+              << std::right << std::setw(10) << side.packets << " pkts"
+              << std::setw(14) << static_cast<std::uint64_t>(pps) << " pkt/s"
+              << std::setw(14) << static_cast<std::uint64_t>(per_core) << " pkt/s/core" << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t packet_count = argc > 1 ? std::stoul(argv[1]) : 200000;
+    const std::size_t payload_bytes = argc > 2 ? std::stoul(argv[2]) : 256;
+    const std::size_t batch_size =
+        std::clamp<std::size_t>(argc > 3 ? std::stoul(argv[3]) : 32, 1, engine::net::kMaxDatagramBatch);
+
+    std::cout << "[bench] UDP loopback, " << packet_count << " datagrams of " << payload_bytes
+              << " bytes, batch=" << batch_size << "\n";
+
+    const auto single = run(false, packet_count, payload_bytes, batch_size);
+    std::cout << "send_to / receive_from\n";
+    print_side("sender", single.sender);
+    print_side("receiver", single.receiver);
+
+    const auto batched = run(true, packet_count, payload_bytes, batch_size);
+    std::cout << "send_batch / receive_batch\n";
+    print_side("sender", batched.sender);
+    print_side("receiver", batched.receiver);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,50 @@
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "engine/net/serializer.hpp"
+
+TEST_CASE("bit writer and reader round-trip fields of any width") {
+    std::vector<std::uint8_t> bytes;
+    engine::net::BitWriter writer(bytes);
+    writer.write_bits(5, 3);
+    writer.write_bool(true);
+    writer.write_bits(0xABCD, 16);
+    writer.write_bits(0xDEADBEEF, 32);
+    writer.write_bits(0x1FF, 7);  // Only the low 7 bits are kept
+    writer.flush();
+    CHECK(bytes.size() == (3 + 1 + 16 + 32 + 7 + 7) / 8);
+
+    engine::net::BitReader reader(bytes);
+    std::uint32_t value = 0;
+    bool flag = false;
+    REQUIRE(reader.read_bits(3, value));
+    CHECK(value == 5u);
+    REQUIRE(reader.read_bool(flag));
+    CHECK(flag);
+    REQUIRE(reader.read_bits(16, value));
+    CHECK(value == 0xABCDu);
+    REQUIRE(reader.read_bits(32, value));
+    CHECK(value == 0xDEADBEEFu);
+    REQUIRE(reader.read_bits(7, value));
+    CHECK(value == 0x7Fu);
+    CHECK_FALSE(reader.read_bits(8, value));  // Only padding left
+}
+
+TEST_CASE("quantized ranges clamp and keep the advertised precision") {
+    constexpr engine::net::QuantizedRange range{-512.0f, 1536.0f, 14};
+    const float step = (range.max - range.min) / static_cast<float>(range.max_code());
+
+    CHECK(range.quantize(-10000.f) == 0u);
+    CHECK(range.quantize(10000.f) == range.max_code());
+    CHECK(range.dequantize(0) == doctest::Approx(-512.f));
+    CHECK(range.dequantize(range.max_code()) == doctest::Approx(1536.f));
+
+    for (float value = -500.f; value < 1500.f; value += 13.37f) {
+        const float snapped = range.snap(value);
+        CHECK(std::abs(snapped - value) <= step / 2 + 1e-3f);
+        CHECK(range.snap(snapped) == snapped);  // Stable once quantized
+    }
+}
@@ -0,0 +1,89 @@
+#include <doctest/doctest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "engine/net/clock_sync.hpp"
+#include "engine/net/packet.hpp"
+
+namespace {
+
+using engine::net::ClockSync;
+
+// One exchange at client time `t0`: `up` and `down` ms each way, `held` ms on the server,
+// whose clock runs `offset` ms ahead of the client's.
+bool exchange(ClockSync& sync, std::uint32_t t0, std::uint32_t offset, std::uint32_t up, std::uint32_t down,
+              std::uint32_t held = 1) {
+    const std::uint32_t t1 = t0 + offset + up;
+    const std::uint32_t t2 = t1 + held;
+    const std::uint32_t t3 = t2 - offset + down;
+    return sync.on_exchange(t0, t1, t2, t3);
+}
+
+}  // namespace
+
+TEST_CASE("clock sync measures the round trip net of server time and the clock offset") {
+    ClockSync sync;
+    CHECK_FALSE(sync.synced());
+    REQUIRE(exchange(sync, 1000, 250000, 20, 20, 3));
+    CHECK(sync.synced());
+    CHECK(sync.last_rtt_ms() == doctest::Approx(40.0));
+    CHECK(sync.offset_ms() == doctest::Approx(250000.0));
+    CHECK(sync.to_server_ms(5000) == 255000u);
+}
+
+TEST_CASE("clock sync takes the offset from the least queued exchange") {
+    ClockSync sync;
+    REQUIRE(exchange(sync, 1000, 5000, 15, 15));
+    // Queueing on the way up skews these by half the extra delay each.
+    for (std::uint32_t i = 1; i < ClockSync::kWindow; ++i) {
+        REQUIRE(exchange(sync, 1000 + i * 500, 5000, 15 + 10 * i, 15));
+    }
+    CHECK(sync.offset_ms() == doctest::Approx(5000.0));
+    CHECK(sync.min_rtt_ms() == doctest::Approx(30.0));
+    CHECK(sync.rtt_ms() > 30.0);
+    CHECK(sync.jitter_ms() > 0.0);
+
+    // Once out of the window, the clean sample no longer counts.
+    REQUIRE(exchange(sync, 6000, 5000, 25, 15));
+    CHECK(sync.offset_ms() == doctest::Approx(5005.0));
+}
+
+TEST_CASE("clock sync handles wrap-around and rejects inconsistent exchanges") {
+    ClockSync sync;
+    // The client clock wraps between send and receive, the server's is behind it.
+    REQUIRE(exchange(sync, 0xFFFFFFF0u, static_cast<std::uint32_t>(-100000), 12, 12));
+    CHECK(sync.last_rtt_ms() == doctest::Approx(24.0));
+    CHECK(sync.offset_ms() == doctest::Approx(-100000.0));
+
+    CHECK_FALSE(sync.on_exchange(1000, 2000, 1990, 1050));  // Server sent before receiving
+    CHECK_FALSE(sync.on_exchange(1000, 2000, 2100, 1050));  // Held longer than the round trip
+    CHECK(sync.offset_ms() == doctest::Approx(-100000.0));
+}
+
+TEST_CASE("pongs carry the ping and the server clock, echoed pings only the ping") {
+    engine::net::PongMessage pong{};
+    pong.ping = engine::net::PingMessage{1234, 40, 29, 30};
+    pong.server_receive_ms = 777;
+    pong.server_send_ms = 779;
+    std::vector<std::uint8_t> payload;
+    engine::net::append_pong_payload(pong, payload);
+
+    auto decoded = engine::net::decode_pong_payload(payload);
+    REQUIRE(decoded);
+    CHECK(decoded->ping.client_time_ms == 1234);
+    CHECK(decoded->has_server_time);
+    CHECK(decoded->server_receive_ms == 777);
+    CHECK(decoded->server_send_ms == 779);
+
+    // The server still reads the Ping part as a Ping.
+    auto ping = engine::net::decode_ping_payload(payload);
+    REQUIRE(ping);
+    CHECK(ping->expected == 30);
+
+    payload.resize(payload.size() - 8);  // Server that echoes Pings unchanged
+    decoded = engine::net::decode_pong_payload(payload);
+    REQUIRE(decoded);
+    CHECK(decoded->ping.client_time_ms == 1234);
+    CHECK_FALSE(decoded->has_server_time);
+}
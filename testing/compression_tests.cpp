@@ -0,0 +1,165 @@
+#include <doctest/doctest.h>
+
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "engine/net/compression.hpp"
+#include "engine/net/packet.hpp"
+
+namespace {
+
+// Entity-like records: a changing position next to fields that repeat across entities.
+std::vector<std::uint8_t> repetitive_blob(std::size_t entities) {
+    static constexpr std::uint8_t kRepeated[] = {3, 0, 100, 0, 3, 0, 0, 0};  // Sprite, hp_max, lives_max, owner
+    std::vector<std::uint8_t> blob;
+    for (std::size_t i = 0; i < entities; ++i) {
+        const auto id = static_cast<std::uint16_t>(i + 1);
+        blob.push_back(static_cast<std::uint8_t>(id & 0xFF));
+        blob.push_back(static_cast<std::uint8_t>(id >> 8));
+        blob.push_back(static_cast<std::uint8_t>(i * 37));  // Position
+        blob.push_back(static_cast<std::uint8_t>(i * 11));
+        blob.insert(blob.end(), std::begin(kRepeated), std::end(kRepeated));
+    }
+    return blob;
+}
+
+std::vector<std::uint8_t> round_trip(std::span<const std::uint8_t> data) {
+    engine::net::LzCodec codec;
+    std::vector<std::uint8_t> compressed;
+    codec.compress(data, compressed);
+    std::vector<std::uint8_t> restored;
+    REQUIRE(engine::net::LzCodec::decompress(compressed, restored, data.size()));
+    return restored;
+}
+
+}  // namespace
+
+TEST_CASE("the LZ codec restores what it compressed") {
+    const auto entities = repetitive_blob(200);
+    CHECK(round_trip(entities) == entities);
+
+    std::vector<std::uint8_t> run(5000, 0);  // One long match (length bytes past 255)
+    CHECK(round_trip(run) == run);
+
+    std::mt19937 rng(9);
+    std::vector<std::uint8_t> noise(3000);  // Long literal runs, hardly any match
+    for (auto& byte : noise) {
+        byte = static_cast<std::uint8_t>(rng());
+    }
+    CHECK(round_trip(noise) == noise);
+
+    CHECK(round_trip(std::vector<std::uint8_t>{}).empty());
+    CHECK(round_trip(std::vector<std::uint8_t>{1, 2, 3}) == std::vector<std::uint8_t>{1, 2, 3});
+
+    engine::net::LzCodec codec;
+    std::vector<std::uint8_t> compressed;
+    codec.compress(entities, compressed);
+    CHECK(compressed.size() * 4 < entities.size() * 3);
+}
+
+TEST_CASE("malformed LZ streams are rejected") {
+    const auto data = repetitive_blob(50);
+    engine::net::LzCodec codec;
+    std::vector<std::uint8_t> compressed;
+    codec.compress(data, compressed);
+    std::vector<std::uint8_t> out;
+
+    CHECK_FALSE(engine::net::LzCodec::decompress(compressed, out, data.size() - 1));
+    CHECK_FALSE(engine::net::LzCodec::decompress(compressed, out, data.size() + 1));
+    auto truncated = compressed;
+    truncated.resize(truncated.size() / 2);
+    CHECK_FALSE(engine::net::LzCodec::decompress(truncated, out, data.size()));
+    // A match reaching back before the start of the output.
+    const std::vector<std::uint8_t> bad_offset{0x10, 0xAA, 0x09, 0x00};
+    CHECK_FALSE(engine::net::LzCodec::decompress(bad_offset, out, 5));
+    const std::vector<std::uint8_t> zero_offset{0x10, 0xAA, 0x00, 0x00};
+    CHECK_FALSE(engine::net::LzCodec::decompress(zero_offset, out, 5));
+}
+
+TEST_CASE("compressed snapshots inflate back to the original blob") {
+    engine::net::SnapshotMessage raw;
+    raw.tick = 42;
+    raw.flags = 0x05;
+    raw.last_processed_input = 7;
+    raw.blob = repetitive_blob(100);
+
+    engine::net::SnapshotCompressor compressor;
+    engine::net::SnapshotMessage compressed;
+    REQUIRE(compressor.compress(raw, compressed));
+    CHECK(compressed.flags == (0x05 | engine::net::kSnapshotFlagCompressed));
+    CHECK(compressed.tick == 42u);
+    CHECK(compressed.blob.size() < raw.blob.size());
+
+    std::vector<std::uint8_t> payload;
+    engine::net::encode_snapshot_payload(compressed, payload);
+    auto view = engine::net::decode_snapshot_view(payload);
+    REQUIRE(view.has_value());
+    std::vector<std::uint8_t> scratch;
+    REQUIRE(engine::net::inflate_snapshot(*view, scratch));
+    CHECK(view->flags == 0x05);
+    CHECK(std::vector<std::uint8_t>(view->blob.begin(), view->blob.end()) == raw.blob);
+
+    // Uncompressed snapshots pass through untouched; garbage is refused.
+    auto plain = engine::net::decode_snapshot_view(payload);
+    plain->flags = 0x05;
+    const auto* before = plain->blob.data();
+    REQUIRE(engine::net::inflate_snapshot(*plain, scratch));
+    CHECK(plain->blob.data() == before);
+    auto corrupt = engine::net::decode_snapshot_view(payload);
+    corrupt->blob = corrupt->blob.first(corrupt->blob.size() - 3);
+    CHECK_FALSE(engine::net::inflate_snapshot(*corrupt, scratch));
+}
+
+TEST_CASE("the compressor skips snapshots it cannot shrink and backs off") {
+    engine::net::SnapshotCompressor compressor;
+    engine::net::SnapshotMessage out;
+
+    engine::net::SnapshotMessage tiny;
+    tiny.blob.assign(engine::net::SnapshotCompressor::kMinBlobSize - 1, 0);
+    CHECK_FALSE(compressor.compress(tiny, out));
+    CHECK(compressor.stats().attempts == 0);
+
+    engine::net::SnapshotMessage noise;
+    std::mt19937 rng(1);
+    noise.blob.resize(600);
+    for (auto& byte : noise.blob) {
+        byte = static_cast<std::uint8_t>(rng());
+    }
+    for (std::uint32_t i = 0; i < engine::net::SnapshotCompressor::kMissesBeforeBackoff; ++i) {
+        CHECK_FALSE(compressor.compress(noise, out));
+    }
+    CHECK(compressor.stats().attempts == engine::net::SnapshotCompressor::kMissesBeforeBackoff);
+
+    // Backing off: even compressible snapshots go out raw for a while, without any work.
+    engine::net::SnapshotMessage good;
+    good.blob = repetitive_blob(100);
+    for (std::uint32_t i = 0; i < engine::net::SnapshotCompressor::kBackoffSnapshots; ++i) {
+        CHECK_FALSE(compressor.compress(good, out));
+    }
+    CHECK(compressor.stats().attempts == engine::net::SnapshotCompressor::kMissesBeforeBackoff);
+    CHECK(compressor.compress(good, out));
+}
+
+TEST_CASE("compression is negotiated in Hello and Welcome") {
+    engine::net::HelloMessage hello{};
+    hello.room_id = 2;
+    hello.features = engine::net::kFeatureSnapshotCompression;
+    std::vector<std::uint8_t> payload;
+    engine::net::encode_hello_payload(hello, payload);
+    CHECK(engine::net::decode_hello_payload(payload).features == engine::net::kFeatureSnapshotCompression);
+    payload.pop_back();  // A client from before the field
+    CHECK(engine::net::decode_hello_payload(payload).features == 0);
+    CHECK(engine::net::decode_hello_payload(payload).room_id == 2);
+
+    engine::net::WelcomeMessage welcome{};
+    welcome.player_id = 4;
+    welcome.features = engine::net::kFeatureSnapshotCompression;
+    engine::net::encode_welcome_payload(welcome, payload);
+    CHECK(engine::net::decode_welcome_payload(payload)->features == engine::net::kFeatureSnapshotCompression);
+    payload.pop_back();
+    REQUIRE(engine::net::decode_welcome_payload(payload).has_value());
+    CHECK(engine::net::decode_welcome_payload(payload)->features == 0);
+}
@@ -0,0 +1,112 @@
+#include <doctest/doctest.h>
+
+#include <cstdint>
+#include <utility>
+
+#include "engine/core/registry.hpp"
+#include "engine/game/components/core/position.hpp"
+#include "engine/game/components/gameplay/boss_phase.hpp"
+#include "engine/game/components/gameplay/collider.hpp"
+#include "engine/game/components/gameplay/enemy_type.hpp"
+#include "engine/game/components/gameplay/faction.hpp"
+#include "engine/game/components/gameplay/health.hpp"
+#include "engine/game/components/gameplay/killer.hpp"
+#include "engine/game/components/gameplay/projectile.hpp"
+#include "engine/game/components/gameplay/ultimate_projectile.hpp"
+#include "engine/game/components/network/owner.hpp"
+#include "engine/game/systems/gameplay/collision_system.hpp"
+
+namespace {
+
+using namespace engine::game::components;
+
+constexpr float kEnemySpeed = 5.f;  // Pixels per tick, leftwards
+
+struct World {
+    rtype::ecs::registry reg;
+    rtype::game::CollisionSystem collisions;
+    rtype::ecs::entity_t enemy{0};
+    std::uint32_t tick{0};
+
+    World() {
+        reg.register_component<Position>();
+        reg.register_component<Collider>();
+        reg.register_component<FactionComponent>();
+        reg.register_component<Projectile>();
+        reg.register_component<Health>();
+        reg.register_component<UltimateProjectile>();
+        reg.register_component<EnemyTypeComponent>();
+        reg.register_component<BossPhase>();
+        reg.register_component<Killer>();
+        reg.register_component<Owner>();
+        enemy = spawn_enemy(500.f);
+    }
+
+    rtype::ecs::entity_t spawn_enemy(float x) {
+        auto entity = reg.spawn_entity();
+        reg.emplace_component<Position>(entity, x, 100.f);
+        reg.emplace_component<Collider>(entity, 20.f, 20.f, false);
+        reg.emplace_component<FactionComponent>(entity, Faction::ENEMY);
+        reg.emplace_component<Health>(entity, 100, 100);
+        return entity;
+    }
+
+    // Moves the enemies, then records the tick as its snapshot would show it.
+    void advance(int ticks) {
+        for (int i = 0; i < ticks; ++i) {
+            reg.view<Position, FactionComponent>([](std::size_t, Position& pos, const FactionComponent& faction) {
+                if (faction.faction_value == Faction::ENEMY) {
+                    pos.x -= kEnemySpeed;
+                }
+            });
+            collisions.record_history(reg, ++tick);
+        }
+    }
+
+    rtype::ecs::entity_t shoot(float x, std::uint8_t rewind_ticks) {
+        auto entity = reg.spawn_entity();
+        reg.emplace_component<Position>(entity, x, 105.f);
+        reg.emplace_component<Collider>(entity, 8.f, 8.f, false);
+        reg.emplace_component<FactionComponent>(entity, Faction::PLAYER);
+        Projectile projectile{};
+        projectile.rewind_ticks = rewind_ticks;
+        reg.add_component(entity, std::move(projectile));
+        return entity;
+    }
+
+    int health(rtype::ecs::entity_t entity) { return reg.try_get<Health>(entity)->current; }
+};
+
+}  // namespace
+
+TEST_CASE("player projectiles hit enemies where the shooter saw them") {
+    World world;
+    world.advance(10);  // Enemy now at x=450, it was at x=480 six ticks ago
+    const float seen_x = 500.f - kEnemySpeed * 4.f;
+
+    world.shoot(seen_x + 5.f, 0);
+    world.collisions.run(world.reg, 0.016f);
+    CHECK(world.health(world.enemy) == 100);  // Not where the enemy is now
+
+    world.shoot(seen_x + 5.f, 7);  // Simulating tick 11, the client saw tick 4
+    world.collisions.run(world.reg, 0.016f);
+    CHECK(world.health(world.enemy) == 90);
+}
+
+TEST_CASE("rewinds are bounded and skip enemies spawned since") {
+    World world;
+    world.advance(30);
+
+    // Rewinds past the window are capped at kMaxRewindTicks.
+    const float oldest_x = 500.f - kEnemySpeed * static_cast<float>(31 - rtype::game::CollisionSystem::kMaxRewindTicks);
+    world.shoot(oldest_x + 5.f, 200);
+    world.collisions.run(world.reg, 0.016f);
+    CHECK(world.health(world.enemy) == 90);
+
+    // An enemy that did not exist back then is tested where it is now.
+    auto late = world.spawn_enemy(300.f);
+    world.advance(2);
+    world.shoot(300.f - 2.f * kEnemySpeed + 5.f, 6);
+    world.collisions.run(world.reg, 0.016f);
+    CHECK(world.health(late) == 90);
+}
@@ -0,0 +1,132 @@
+#include <doctest/doctest.h>
+
+#include <array>
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+#include "link_model.hpp"
+
+namespace {
+
+// Sends `count` datagrams 1 ms apart; returns how many got through (first copy only).
+std::size_t run(netsim::ImpairedLink& link, std::size_t count, std::array<double, 2>& last) {
+    std::size_t delivered = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (link.admit(static_cast<double>(i), last) > 0) {
+            ++delivered;
+        }
+    }
+    return delivered;
+}
+
+}  // namespace
+
+TEST_CASE("an impaired link is reproducible from its seed") {
+    netsim::LinkProfile profile;
+    profile.latency_ms = 75.0;
+    profile.jitter_ms = 10.0;
+    profile.loss = 0.05;
+    profile.duplicate = 0.01;
+    profile.reorder = 0.02;
+
+    netsim::ImpairedLink a(42);
+    netsim::ImpairedLink b(42);
+    a.set_profile(profile);
+    b.set_profile(profile);
+    std::array<double, 2> at_a{};
+    std::array<double, 2> at_b{};
+    for (int i = 0; i < 1000; ++i) {
+        const auto copies = a.admit(i * 16.0, at_a);
+        REQUIRE(copies == b.admit(i * 16.0, at_b));
+        for (std::size_t c = 0; c < copies; ++c) {
+            CHECK(at_a[c] == at_b[c]);
+        }
+    }
+    CHECK(a.stats().dropped == b.stats().dropped);
+    CHECK(a.stats().dropped > 0);
+    CHECK(a.stats().reordered > 0);
+}
+
+TEST_CASE("loss, latency and jitter stay within the profile") {
+    netsim::LinkProfile profile;
+    profile.latency_ms = 75.0;
+    profile.jitter_ms = 10.0;
+    profile.loss = 0.05;
+    netsim::ImpairedLink link(7);
+    link.set_profile(profile);
+
+    std::array<double, 2> at{};
+    double previous = 0.0;
+    std::size_t delivered = 0;
+    for (int i = 0; i < 20000; ++i) {
+        const double now = i * 5.0;
+        if (link.admit(now, at) == 0) {
+            continue;
+        }
+        ++delivered;
+        CHECK(at[0] >= now + 65.0);
+        CHECK(at[0] <= now + 85.0);
+        CHECK(at[0] >= previous);  // Jitter alone never reorders
+        previous = at[0];
+    }
+    const double loss = 1.0 - static_cast<double>(delivered) / 20000.0;
+    CHECK(loss == doctest::Approx(0.05).epsilon(0.2));
+}
+
+TEST_CASE("burst loss drops runs of datagrams") {
+    netsim::LinkProfile profile;
+    profile.burst_enter = 0.01;
+    profile.burst_exit = 0.2;  // Bursts of 5 datagrams on average
+    netsim::ImpairedLink link(3);
+    link.set_profile(profile);
+
+    std::array<double, 2> at{};
+    std::size_t bursts = 0;
+    std::size_t lost = 0;
+    bool losing = false;
+    for (int i = 0; i < 50000; ++i) {
+        const bool dropped = link.admit(i, at) == 0;
+        lost += dropped ? 1 : 0;
+        bursts += (dropped && !losing) ? 1 : 0;
+        losing = dropped;
+    }
+    REQUIRE(bursts > 0);
+    CHECK(static_cast<double>(lost) / static_cast<double>(bursts) == doctest::Approx(5.0).epsilon(0.2));
+
+    link.set_profile(netsim::LinkProfile{});
+    std::array<double, 2> last{};
+    CHECK(run(link, 100, last) >= 95);  // Leaves the burst within a few datagrams
+}
+
+TEST_CASE("a profile script switches phases over time") {
+    std::istringstream text(
+        "# 150 ms RTT, 5% loss\n"
+        "latency = 75\n"
+        "loss = 0.05\n"
+        "\n"
+        "at 10\n"
+        "down.latency = 200   # server to client only\n"
+        "up.burst_enter = 0.02\n");
+    netsim::ProfileScript script;
+    std::string error;
+    REQUIRE(script.load(text, error));
+    REQUIRE(script.phases().size() == 2);
+
+    const auto& first = script.phases()[script.phase_at(9.9)];
+    CHECK(first.up.latency_ms == 75.0);
+    CHECK(first.down.loss == 0.05);
+    const auto& second = script.phases()[script.phase_at(10.0)];
+    CHECK(second.up.latency_ms == 75.0);
+    CHECK(second.down.latency_ms == 200.0);
+    CHECK(second.up.burst_enter == 0.02);
+    CHECK(second.down.burst_enter == 0.0);
+    CHECK(second.down.loss == 0.05);
+
+    CHECK_FALSE(script.apply_line("bandwidth = 10", error));
+    CHECK_FALSE(script.apply_line("loss = 1.5", error));
+    CHECK_FALSE(script.apply_line("at 5", error));
+    std::istringstream broken("latency = 50\nlatency 60\n");
+    CHECK_FALSE(netsim::ProfileScript{}.load(broken, error));
+    CHECK(error.rfind("line 2:", 0) == 0);
+}
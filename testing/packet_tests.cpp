@@ -0,0 +1,266 @@
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "engine/net/packet.hpp"
+
+TEST_CASE("snapshot prefix plus shared blob matches a fully serialized packet") {
+    engine::net::SnapshotMessage snapshot{};
+    snapshot.tick = 1234;
+    snapshot.flags = 1;
+    snapshot.paused = false;
+    snapshot.blob = {1, 2, 3, 4, 5, 6, 7};
+
+    engine::net::PacketHeader header;
+    header.type = static_cast<std::uint8_t>(engine::net::MessageType::Snapshot);
+    engine::net::SnapshotPrefix prefix{};
+    engine::net::encode_snapshot_prefix(header, snapshot, prefix);
+    engine::net::patch_packet_sequence(prefix, 42);
+    engine::net::patch_snapshot_last_input(prefix, 99);
+
+    std::vector<std::uint8_t> gathered(prefix.begin(), prefix.end());
+    gathered.insert(gathered.end(), snapshot.blob.begin(), snapshot.blob.end());
+
+    engine::net::Packet packet;
+    packet.header = header;
+    packet.header.sequence = 42;
+    auto per_client = snapshot;
+    per_client.last_processed_input = 99;
+    engine::net::encode_snapshot_payload(per_client, packet.payload);
+    CHECK(gathered == engine::net::serialize(packet));
+
+    auto decoded_packet = engine::net::deserialize(gathered);
+    REQUIRE(decoded_packet.has_value());
+    CHECK(decoded_packet->header.sequence == 42u);
+    auto decoded = engine::net::decode_snapshot_payload(decoded_packet->payload);
+    REQUIRE(decoded.has_value());
+    CHECK(decoded->tick == 1234u);
+    CHECK(decoded->last_processed_input == 99u);
+    CHECK(decoded->blob == snapshot.blob);
+}
+
+namespace {
+
+// Builds every datagram of a snapshot the way NetworkServer::broadcast_snapshot does.
+std::vector<std::vector<std::uint8_t>> build_snapshot_datagrams(const engine::net::SnapshotMessage& snapshot) {
+    const auto count = engine::net::snapshot_datagram_count(snapshot.blob.size());
+    std::vector<std::vector<std::uint8_t>> datagrams;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto head = engine::net::encode_snapshot_head(snapshot, i, count);
+        engine::net::patch_snapshot_head(head, static_cast<std::uint32_t>(i), 77);
+        std::vector<std::uint8_t> bytes(head.bytes.begin(), head.bytes.begin() + static_cast<std::ptrdiff_t>(head.size));
+        const auto slice = engine::net::snapshot_blob_slice(snapshot.blob, i, count);
+        bytes.insert(bytes.end(), slice.begin(), slice.end());
+        datagrams.push_back(std::move(bytes));
+    }
+    return datagrams;
+}
+
+engine::net::SnapshotMessage make_large_snapshot(std::uint32_t tick, std::size_t blob_size) {
+    engine::net::SnapshotMessage snapshot{};
+    snapshot.tick = tick;
+    snapshot.blob.resize(blob_size);
+    for (std::size_t i = 0; i < blob_size; ++i) {
+        snapshot.blob[i] = static_cast<std::uint8_t>(i * 7 + tick);
+    }
+    return snapshot;
+}
+
+std::optional<std::span<const std::uint8_t>> feed(engine::net::SnapshotReassembler& reassembler,
+                                                  const std::vector<std::uint8_t>& datagram,
+                                                  engine::net::SnapshotReassembler::Clock::time_point now) {
+    auto packet = engine::net::deserialize(datagram);
+    REQUIRE(packet.has_value());
+    REQUIRE(packet->header.type == static_cast<std::uint8_t>(engine::net::MessageType::SnapshotFragment));
+    auto fragment = engine::net::decode_fragment_payload(packet->payload);
+    REQUIRE(fragment.has_value());
+    return reassembler.add(*fragment, now);
+}
+
+}  // namespace
+
+TEST_CASE("large snapshots are fragmented under the MTU and reassembled in any order") {
+    const auto snapshot = make_large_snapshot(500, 4000);
+    auto datagrams = build_snapshot_datagrams(snapshot);
+    REQUIRE(datagrams.size() == 3);
+    for (const auto& datagram : datagrams) {
+        CHECK(datagram.size() <= engine::net::kMaxPacketSize);
+    }
+
+    engine::net::SnapshotReassembler reassembler;
+    const auto now = engine::net::SnapshotReassembler::Clock::now();
+    CHECK_FALSE(feed(reassembler, datagrams[2], now).has_value());
+    CHECK_FALSE(feed(reassembler, datagrams[0], now).has_value());
+    CHECK_FALSE(feed(reassembler, datagrams[0], now).has_value());  // Duplicate
+    auto payload = feed(reassembler, datagrams[1], now);
+    REQUIRE(payload.has_value());
+
+    auto decoded = engine::net::decode_snapshot_payload(*payload);
+    REQUIRE(decoded.has_value());
+    CHECK(decoded->tick == 500u);
+    CHECK(decoded->last_processed_input == 77u);
+    CHECK(decoded->blob == snapshot.blob);
+    CHECK(reassembler.pending() == 0);
+}
+
+TEST_CASE("incomplete fragmented snapshots are dropped, never delivered") {
+    engine::net::SnapshotReassembler reassembler(std::chrono::milliseconds(100));
+    const auto start = engine::net::SnapshotReassembler::Clock::now();
+
+    // Tick 10 loses its last fragment and times out.
+    auto lost = build_snapshot_datagrams(make_large_snapshot(10, 3000));
+    CHECK_FALSE(feed(reassembler, lost[0], start).has_value());
+    CHECK_FALSE(feed(reassembler, lost[1], start).has_value());
+
+    // Tick 11 starts, tick 12 completes first and supersedes it.
+    auto superseded = build_snapshot_datagrams(make_large_snapshot(11, 3000));
+    CHECK_FALSE(feed(reassembler, superseded[0], start + std::chrono::milliseconds(150)).has_value());
+    auto newest = build_snapshot_datagrams(make_large_snapshot(12, 3000));
+    CHECK_FALSE(feed(reassembler, newest[0], start + std::chrono::milliseconds(150)).has_value());
+    CHECK_FALSE(feed(reassembler, newest[1], start + std::chrono::milliseconds(150)).has_value());
+    auto payload = feed(reassembler, newest[2], start + std::chrono::milliseconds(150));
+    REQUIRE(payload.has_value());
+    CHECK(engine::net::decode_snapshot_payload(*payload)->tick == 12u);
+
+    CHECK(reassembler.dropped() == 2);
+    CHECK(reassembler.pending() == 0);
+    // Late fragments of the abandoned snapshots are ignored.
+    CHECK_FALSE(feed(reassembler, lost[2], start + std::chrono::milliseconds(160)).has_value());
+    CHECK_FALSE(feed(reassembler, superseded[1], start + std::chrono::milliseconds(160)).has_value());
+    CHECK(reassembler.pending() == 0);
+}
+
+TEST_CASE("fragmented snapshots keep coming across a tick wrap and a sender restart") {
+    engine::net::SnapshotReassembler reassembler;
+    const auto now = engine::net::SnapshotReassembler::Clock::now();
+    const auto deliver = [&](std::uint32_t tick) {
+        std::optional<std::uint32_t> delivered;
+        for (const auto& datagram : build_snapshot_datagrams(make_large_snapshot(tick, 3000))) {
+            if (auto payload = feed(reassembler, datagram, now)) {
+                delivered = engine::net::decode_snapshot_payload(*payload)->tick;
+            }
+        }
+        return delivered;
+    };
+
+    CHECK(deliver(0xFFFFFFFEu) == 0xFFFFFFFEu);
+    CHECK(deliver(1) == 1u);                 // Wrapped: 1 comes after 0xFFFFFFFE
+    CHECK_FALSE(deliver(0xFFFFFFFFu));       // Late, behind 1
+    CHECK_FALSE(deliver(1));                 // Duplicate
+
+    CHECK(deliver(50000) == 50000u);
+    CHECK_FALSE(deliver(50000 - engine::net::SnapshotReassembler::kRestartDistance + 1));  // Merely late
+    CHECK(deliver(3) == 3u);                 // Far behind: the server restarted
+    CHECK(deliver(4) == 4u);
+}
+
+TEST_CASE("snapshots that fit the MTU still use a single Snapshot datagram") {
+    const auto snapshot = make_large_snapshot(3, 200);
+    auto datagrams = build_snapshot_datagrams(snapshot);
+    REQUIRE(datagrams.size() == 1);
+    auto packet = engine::net::deserialize(datagrams[0]);
+    REQUIRE(packet.has_value());
+    CHECK(packet->header.type == static_cast<std::uint8_t>(engine::net::MessageType::Snapshot));
+    auto decoded = engine::net::decode_snapshot_payload(packet->payload);
+    REQUIRE(decoded.has_value());
+    CHECK(decoded->blob == snapshot.blob);
+}
+
+TEST_CASE("hello carries the room id and older payloads join room 0") {
+    engine::net::HelloMessage hello{};
+    std::snprintf(hello.player_name, sizeof(hello.player_name), "%s", "pilot");
+    hello.start_level = 3;
+    hello.difficulty = 2;
+    hello.room_id = 17;
+    std::vector<std::uint8_t> payload;
+    engine::net::encode_hello_payload(hello, payload);
+
+    auto decoded = engine::net::decode_hello_payload(payload);
+    CHECK(std::string(decoded.player_name) == "pilot");
+    CHECK(decoded.start_level == 3);
+    CHECK(decoded.difficulty == 2);
+    CHECK(decoded.room_id == 17);
+
+    payload.resize(payload.size() - 2);  // Client built before rooms existed
+    decoded = engine::net::decode_hello_payload(payload);
+    CHECK(decoded.difficulty == 2);
+    CHECK(decoded.room_id == 0);
+}
+
+TEST_CASE("inputs repeat the previous ones and older payloads carry none") {
+    engine::net::InputMessage input{};
+    input.player_id = 2;
+    input.input_mask = 0b01001;
+    input.client_time_ms = 5000;
+    input.ack_tick = 40;
+    input.previous = {engine::net::PreviousInput{1, 0b01000, 4990},
+                      engine::net::PreviousInput{3, 0b00000, 4950},
+                      engine::net::PreviousInput{4, 0b10000, 4949}};
+    input.previous_count = 3;
+    std::vector<std::uint8_t> payload;
+    engine::net::encode_input_payload(input, payload);
+    CHECK(payload.size() == 12 + 1 + 3 * 5);
+
+    auto decoded = engine::net::decode_input_payload(payload);
+    REQUIRE(decoded);
+    REQUIRE(decoded->previous_count == 3);
+    for (std::size_t i = 0; i < 3; ++i) {
+        CHECK(decoded->previous[i].sequence_back == input.previous[i].sequence_back);
+        CHECK(decoded->previous[i].input_mask == input.previous[i].input_mask);
+        CHECK(decoded->previous[i].client_time_ms == input.previous[i].client_time_ms);
+    }
+
+    // An input too far back for the gap fields ends the list.
+    input.previous[1].client_time_ms = input.previous[0].client_time_ms - 70000;
+    engine::net::encode_input_payload(input, payload);
+    decoded = engine::net::decode_input_payload(payload);
+    REQUIRE(decoded);
+    CHECK(decoded->previous_count == 1);
+
+    payload.resize(12);  // Client built before input redundancy
+    decoded = engine::net::decode_input_payload(payload);
+    REQUIRE(decoded);
+    CHECK(decoded->ack_tick == 40);
+    CHECK(decoded->previous_count == 0);
+}
+
+TEST_CASE("redundant inputs survive lost and reordered datagrams, once each") {
+    // The client sends masks 1..8 on sequences 10..17, each datagram repeating the last three.
+    std::vector<std::vector<std::uint8_t>> datagrams;
+    for (std::uint32_t n = 0; n < 8; ++n) {
+        engine::net::InputMessage input{};
+        input.input_mask = static_cast<std::uint16_t>(n + 1);
+        input.client_time_ms = 1000 + n * 16;
+        for (std::uint32_t back = 1; back <= engine::net::kInputRedundancy && back <= n; ++back) {
+            input.previous[back - 1] =
+                engine::net::PreviousInput{back, static_cast<std::uint16_t>(n + 1 - back), 1000 + (n - back) * 16};
+            input.previous_count = static_cast<std::uint8_t>(back);
+        }
+        datagrams.emplace_back();
+        engine::net::encode_input_payload(input, datagrams.back());
+    }
+
+    // Lose 11, 12 and 14; deliver 16 before 15, then 13 late and 16 twice.
+    std::vector<std::uint32_t> delivered;
+    std::vector<std::uint16_t> masks;
+    std::uint32_t newest = 0;
+    for (std::uint32_t sequence : {10u, 13u, 16u, 15u, 13u, 16u, 17u}) {
+        auto input = engine::net::decode_input_payload(datagrams[sequence - 10]);
+        REQUIRE(input);
+        engine::net::for_each_new_input(*input, sequence, newest,
+                                        [&](std::uint32_t seq, std::uint16_t mask, std::uint32_t time) {
+                                            delivered.push_back(seq);
+                                            masks.push_back(mask);
+                                            CHECK(time == 1000 + (seq - 10) * 16);
+                                        });
+    }
+    CHECK(delivered == std::vector<std::uint32_t>{10, 11, 12, 13, 14, 15, 16, 17});
+    CHECK(masks == std::vector<std::uint16_t>{1, 2, 3, 4, 5, 6, 7, 8});
+    CHECK(newest == 17);
+}
@@ -0,0 +1,159 @@
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "engine/game/systems/network/game_events.hpp"
+#include "engine/net/reliable_channel.hpp"
+
+namespace {
+
+using engine::net::ReliableChannel;
+using namespace std::chrono_literals;
+
+constexpr std::size_t kMaxPayload = 1200;
+
+std::vector<std::uint8_t> message(std::uint16_t value) {
+    return {static_cast<std::uint8_t>(value & 0xFF), static_cast<std::uint8_t>(value >> 8)};
+}
+
+std::uint16_t value_of(const std::vector<std::uint8_t>& bytes) {
+    return static_cast<std::uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+}  // namespace
+
+TEST_CASE("reliable channel delivers every message in order over a lossy link") {
+    ReliableChannel sender(50ms);
+    ReliableChannel receiver(50ms);
+    constexpr std::uint16_t kCount = 200;
+    for (std::uint16_t i = 0; i < kCount; ++i) {
+        REQUIRE(sender.send(message(i)));
+    }
+
+    std::vector<std::uint16_t> delivered;
+    std::vector<std::uint8_t> payload;
+    auto now = ReliableChannel::Clock::time_point{};
+    // Deterministic pseudo-random loss: roughly half the datagrams in each direction.
+    std::uint32_t seed = 12345;
+    auto delivered_by_link = [&seed] {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 16) % 2 == 0;
+    };
+    for (int step = 0; step < 2000 && sender.unacked() > 0; ++step) {
+        now += 20ms;
+        if (sender.write_packet(payload, now, 64) && delivered_by_link()) {
+            REQUIRE(receiver.read_packet(payload));
+        }
+        while (auto received = receiver.receive()) {
+            delivered.push_back(value_of(*received));
+        }
+        if (receiver.write_packet(payload, now, kMaxPayload) && delivered_by_link()) {
+            REQUIRE(sender.read_packet(payload));
+        }
+    }
+
+    CHECK(sender.unacked() == 0);
+    REQUIRE(delivered.size() == kCount);
+    for (std::uint16_t i = 0; i < kCount; ++i) {
+        CHECK(delivered[i] == i);
+    }
+}
+
+TEST_CASE("reliable channel resends only after the timeout and stops once acked") {
+    ReliableChannel sender(100ms);
+    ReliableChannel receiver;
+    REQUIRE(sender.send(message(7)));
+
+    std::vector<std::uint8_t> payload;
+    const auto start = ReliableChannel::Clock::time_point{} + 1s;
+    REQUIRE(sender.write_packet(payload, start, kMaxPayload));
+    CHECK_FALSE(sender.write_packet(payload, start + 50ms, kMaxPayload));  // Not due yet
+    REQUIRE(sender.write_packet(payload, start + 100ms, kMaxPayload));     // Lost the first one: resend
+
+    REQUIRE(receiver.read_packet(payload));
+    REQUIRE(receiver.read_packet(payload));  // A duplicate is delivered only once
+    auto received = receiver.receive();
+    REQUIRE(received);
+    CHECK(value_of(*received) == 7);
+    CHECK_FALSE(receiver.receive());
+
+    CHECK(receiver.ack_owed());
+    REQUIRE(receiver.write_packet(payload, start, kMaxPayload));
+    CHECK_FALSE(receiver.ack_owed());
+    REQUIRE(sender.read_packet(payload));
+    CHECK(sender.unacked() == 0);
+    CHECK_FALSE(sender.write_packet(payload, start + 1s, kMaxPayload));
+}
+
+TEST_CASE("reliable channel acks messages received past a gap") {
+    ReliableChannel sender(100ms);
+    ReliableChannel receiver;
+    std::vector<std::uint8_t> payload;
+    const auto start = ReliableChannel::Clock::time_point{} + 1s;
+
+    // One message per datagram: 0 is lost, 1 and 2 arrive.
+    REQUIRE(sender.send(message(0)));
+    REQUIRE(sender.write_packet(payload, start, kMaxPayload));
+    REQUIRE(sender.send(message(1)));
+    REQUIRE(sender.write_packet(payload, start, kMaxPayload));
+    REQUIRE(receiver.read_packet(payload));
+    REQUIRE(sender.send(message(2)));
+    REQUIRE(sender.write_packet(payload, start, kMaxPayload));
+    REQUIRE(receiver.read_packet(payload));
+    CHECK_FALSE(receiver.receive());  // Held back until 0 arrives
+
+    REQUIRE(receiver.write_packet(payload, start, kMaxPayload));
+    REQUIRE(sender.read_packet(payload));
+    CHECK(sender.unacked() == 1);  // Only 0 is still outstanding
+
+    // The resend carries 0 alone, after which everything is handed out in order.
+    REQUIRE(sender.write_packet(payload, start + 100ms, kMaxPayload));
+    CHECK(payload.size() == ReliableChannel::kHeaderSize + ReliableChannel::kMessageHeaderSize + 2);
+    REQUIRE(receiver.read_packet(payload));
+    for (std::uint16_t i = 0; i < 3; ++i) {
+        auto received = receiver.receive();
+        REQUIRE(received);
+        CHECK(value_of(*received) == i);
+    }
+}
+
+TEST_CASE("reliable channel rejects oversized messages and malformed packets") {
+    ReliableChannel channel;
+    CHECK_FALSE(channel.send(std::vector<std::uint8_t>(ReliableChannel::kMaxMessageSize + 1, 0)));
+
+    std::vector<std::uint8_t> payload(ReliableChannel::kHeaderSize, 0);
+    payload.back() = 1;  // Claims a message that is not there
+    CHECK_FALSE(channel.read_packet(payload));
+}
+
+TEST_CASE("game events round-trip through their encoding") {
+    const rtype::game::GameEvent event{
+        .type = rtype::game::GameEventType::PlayerDied,
+        .tick = 1234,
+        .entity_id = 42,
+        .player_id = 3,
+        .value = 2,
+        .x = 100.5f,
+        .y = -20.f,
+    };
+    std::vector<std::uint8_t> bytes;
+    rtype::game::encode_game_event(event, bytes);
+    CHECK(bytes.size() == rtype::game::kGameEventSize);
+
+    auto decoded = rtype::game::decode_game_event(bytes);
+    REQUIRE(decoded);
+    CHECK(decoded->type == event.type);
+    CHECK(decoded->tick == event.tick);
+    CHECK(decoded->entity_id == event.entity_id);
+    CHECK(decoded->player_id == event.player_id);
+    CHECK(decoded->value == event.value);
+    CHECK(decoded->x == event.x);
+    CHECK(decoded->y == event.y);
+
+    bytes[0] = 0xFF;  // Unknown type
+    CHECK_FALSE(rtype::game::decode_game_event(bytes));
+    bytes.pop_back();
+    CHECK_FALSE(rtype::game::decode_game_event(bytes));
+}
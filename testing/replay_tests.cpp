@@ -0,0 +1,271 @@
+#include <doctest/doctest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "match.hpp"
+#include "replay.hpp"
+
+namespace {
+
+// A file under the system temp directory, removed when the test ends.
+struct TempFile {
+    std::string path;
+
+    explicit TempFile(const std::string& name)
+        : path((std::filesystem::temp_directory_path() / ("rtype_" + name + ".rtrp")).string()) {}
+    ~TempFile() {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+};
+
+std::vector<std::uint8_t> read_bytes(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+void write_bytes(const std::string& path, const std::vector<std::uint8_t>& bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+server::ReplayHeader make_header() {
+    server::ReplayHeader header;
+    header.room_id = 3;
+    header.seed = 0x0123456789ABCDEFull;
+    header.settings.difficulty = -2;  // Hand-edited configs can hold anything
+    header.settings.enemies_per_wave = 7;
+    header.settings.kills_per_wave = 11;
+    header.settings.player_lives = 5;
+    header.settings.infinite_lives = true;
+    header.settings.enemy_spawn_rate = 1.75f;
+    return header;
+}
+
+server::PlayerEvent joined(std::uint16_t player_id) {
+    return server::PlayerEvent{.kind = server::PlayerEvent::Kind::Joined,
+                               .player_id = player_id,
+                               .start_level = 2,
+                               .difficulty = 3};
+}
+
+server::InputCommand input_at(std::uint16_t player_id, std::uint32_t sequence, std::uint16_t mask) {
+    return server::InputCommand{.player_id = player_id,
+                                .input_mask = mask,
+                                .client_time_ms = sequence * 16 + 3,
+                                .sequence = sequence,
+                                .view_tick = sequence > 2 ? sequence - 2 : 0};
+}
+
+bool same_input(const server::InputCommand& a, const server::InputCommand& b) {
+    return a.player_id == b.player_id && a.input_mask == b.input_mask && a.client_time_ms == b.client_time_ms &&
+           a.sequence == b.sequence && a.view_tick == b.view_tick;
+}
+
+// Stands in for the network: two players join and press pseudo-random keys every frame.
+class ScriptedLink final : public server::RoomLink {
+public:
+    void set_frame(std::uint64_t frame) {
+        frame_ = frame;
+        events_sent_ = false;
+        inputs_sent_ = 0;
+    }
+
+    std::optional<server::InputCommand> poll_input() override {
+        if (frame_ < 5 || inputs_sent_ == players_) {
+            return std::nullopt;
+        }
+        state_ = state_ * 1664525u + 1013904223u;
+        const auto player_id = static_cast<std::uint16_t>(++inputs_sent_);
+        return input_at(player_id, ++sequence_, static_cast<std::uint16_t>((state_ >> 16) & 0x1F));
+    }
+
+    std::optional<server::PlayerEvent> poll_event() override {
+        if (events_sent_ || (frame_ != 0 && frame_ != 40)) {
+            return std::nullopt;
+        }
+        events_sent_ = true;
+        return joined(static_cast<std::uint16_t>(++players_));
+    }
+
+    void broadcast_snapshot(const server::NetworkServer::SnapshotEncoder&) override {}
+    void send_event(std::span<const std::uint8_t>) override {}
+    void flush_events() override {}
+
+private:
+    std::uint64_t frame_{0};
+    bool events_sent_{false};
+    std::uint16_t players_{0};
+    std::uint16_t inputs_sent_{0};
+    std::uint32_t sequence_{0};
+    std::uint32_t state_{12345};
+};
+
+// Plays a loaded replay the way run_replay does and returns the final checksum.
+std::uint64_t replay_checksum(const server::Replay& replay) {
+    server::ReplayLink link(replay);
+    server::MatchOptions options;
+    options.seed = replay.header.seed;
+    options.settings = &replay.header.settings;
+    server::Match match(replay.header.room_id, link, options);
+    for (std::uint64_t frame = 0; frame < replay.frames; ++frame) {
+        link.set_frame(frame);
+        match.tick();
+    }
+    return match.state_checksum();
+}
+
+}  // namespace
+
+TEST_CASE("a replay file round-trips its header, events and inputs") {
+    TempFile file("round_trip");
+    const auto header = make_header();
+    {
+        server::ReplayWriter writer(file.path, header);
+        REQUIRE(writer.is_open());
+        for (std::uint64_t frame = 0; frame < 130; ++frame) {
+            if (frame == 0) {
+                writer.event(frame, joined(1));
+            }
+            if (frame % 25 == 3) {
+                writer.input(frame, input_at(1, static_cast<std::uint32_t>(frame), static_cast<std::uint16_t>(frame)));
+            }
+            if (frame == 100) {
+                writer.event(frame, server::PlayerEvent{.kind = server::PlayerEvent::Kind::Left, .player_id = 1});
+            }
+            writer.end_frame(frame);
+        }
+    }
+
+    std::string error;
+    const auto replay = server::load_replay(file.path, error);
+    REQUIRE_MESSAGE(replay.has_value(), error);
+    CHECK(replay->complete);
+    CHECK(replay->frames == 130);
+    CHECK(replay->header.room_id == header.room_id);
+    CHECK(replay->header.seed == header.seed);
+    CHECK(replay->header.settings.difficulty == -2);
+    CHECK(replay->header.settings.enemies_per_wave == 7);
+    CHECK(replay->header.settings.kills_per_wave == 11);
+    CHECK(replay->header.settings.player_lives == 5);
+    CHECK(replay->header.settings.infinite_lives);
+    CHECK(replay->header.settings.enemy_spawn_rate == 1.75f);
+
+    REQUIRE(replay->events.size() == 2);
+    CHECK(replay->events[0].first == 0);
+    CHECK(replay->events[0].second.kind == server::PlayerEvent::Kind::Joined);
+    CHECK(replay->events[0].second.player_id == 1);
+    CHECK(replay->events[0].second.start_level == 2);
+    CHECK(replay->events[0].second.difficulty == 3);
+    CHECK(replay->events[1].first == 100);
+    CHECK(replay->events[1].second.kind == server::PlayerEvent::Kind::Left);
+
+    REQUIRE(replay->inputs.size() == 6);
+    for (std::size_t i = 0; i < replay->inputs.size(); ++i) {
+        const auto frame = 3 + 25 * i;
+        CHECK(replay->inputs[i].first == frame);
+        CHECK(same_input(replay->inputs[i].second,
+                         input_at(1, static_cast<std::uint32_t>(frame), static_cast<std::uint16_t>(frame))));
+    }
+}
+
+TEST_CASE("a replay cut mid-record loads up to its last flush and is flagged incomplete") {
+    TempFile file("cut");
+    TempFile cut("cut_copy");
+    std::vector<std::uint8_t> flushed;
+    {
+        server::ReplayWriter writer(file.path, make_header());
+        writer.event(0, joined(1));
+        for (std::uint64_t frame = 0; frame < 2 * server::ReplayWriter::kFlushFrames; ++frame) {
+            writer.input(frame, input_at(1, static_cast<std::uint32_t>(frame) + 1, 0x10));
+            writer.end_frame(frame);
+        }
+        // What a crash right now would leave: everything up to the Frames marker of frame 120.
+        flushed = read_bytes(file.path);
+        writer.input(130, input_at(1, 500, 0x01));
+        writer.end_frame(130);
+    }
+    const auto whole = read_bytes(file.path);
+    REQUIRE(whole.size() > flushed.size() + 3);
+    // The writer crashes while writing the input of frame 130.
+    const auto cut_at = whole.begin() + static_cast<std::ptrdiff_t>(flushed.size() + 3);
+    write_bytes(cut.path, std::vector<std::uint8_t>(whole.begin(), cut_at));
+
+    std::string error;
+    const auto replay = server::load_replay(cut.path, error);
+    REQUIRE_MESSAGE(replay.has_value(), error);
+    CHECK_FALSE(replay->complete);
+    CHECK(replay->frames == 2 * server::ReplayWriter::kFlushFrames);
+    CHECK(replay->events.size() == 1);
+    REQUIRE(replay->inputs.size() == 2 * server::ReplayWriter::kFlushFrames);
+    CHECK(replay->inputs.back().first == 2 * server::ReplayWriter::kFlushFrames - 1);
+}
+
+TEST_CASE("corrupt records and foreign files are rejected") {
+    TempFile file("corrupt");
+    std::vector<std::uint8_t> header_only;
+    {
+        server::ReplayWriter writer(file.path, make_header());
+        header_only = read_bytes(file.path);
+    }
+
+    auto corrupt = header_only;
+    corrupt.insert(corrupt.end(), {0x00, 0x09, 0x01, 0x02, 0x03});  // Frame +0, unknown kind 9, then more bytes: not a cut
+    write_bytes(file.path, corrupt);
+    std::string error;
+    CHECK_FALSE(server::load_replay(file.path, error).has_value());
+    CHECK(error.find("corrupt record") != std::string::npos);
+
+    auto wrong_version = header_only;
+    wrong_version[sizeof(server::kReplayMagic)] = static_cast<std::uint8_t>(server::kReplayVersion + 1);
+    write_bytes(file.path, wrong_version);
+    CHECK_FALSE(server::load_replay(file.path, error).has_value());
+    CHECK(error.find("unsupported replay version") != std::string::npos);
+
+    write_bytes(file.path, {'n', 'o', 'p', 'e', 0x02, 0x00});
+    CHECK_FALSE(server::load_replay(file.path, error).has_value());
+    CHECK(error.find("not a replay file") != std::string::npos);
+}
+
+TEST_CASE("a recorded match replays to the same world, every time") {
+    TempFile file("match");
+    engine::game::GameSettings settings;
+    settings.infinite_lives = true;  // Keep both ships playing the whole recording
+    std::uint64_t live_checksum = 0;
+    {
+        ScriptedLink link;
+        server::MatchOptions options;
+        options.seed = 0xC0FFEE;
+        options.settings = &settings;
+        options.record_path = file.path;
+        server::Match match(0, link, options);
+        for (std::uint64_t frame = 0; frame < 600; ++frame) {
+            link.set_frame(frame);
+            match.tick();
+        }
+        live_checksum = match.state_checksum();
+    }
+
+    std::string error;
+    const auto replay = server::load_replay(file.path, error);
+    REQUIRE_MESSAGE(replay.has_value(), error);
+    CHECK(replay->complete);
+    CHECK(replay->frames == 600);
+    CHECK(replay->events.size() == 2);
+    CHECK(replay->inputs.size() > 1000);
+
+    CHECK(replay_checksum(*replay) == live_checksum);
+    CHECK(replay_checksum(*replay) == live_checksum);
+
+    auto reseeded = *replay;
+    reseeded.header.seed += 1;
+    CHECK(replay_checksum(reseeded) != live_checksum);
+}
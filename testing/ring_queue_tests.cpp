@@ -0,0 +1,89 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "engine/net/ring_queue.hpp"
+
+TEST_CASE("ring queue pops in FIFO order and rounds capacity up") {
+    engine::net::SpscRingQueue<int> queue(5);
+    CHECK(queue.capacity() == 8u);
+    CHECK(queue.empty());
+    for (int i = 0; i < 8; ++i) {
+        CHECK(queue.push(i));
+    }
+    CHECK(queue.size() == 8u);
+    for (int i = 0; i < 8; ++i) {
+        auto value = queue.try_pop();
+        REQUIRE(value.has_value());
+        CHECK(*value == i);
+    }
+    CHECK_FALSE(queue.try_pop().has_value());
+}
+
+TEST_CASE("ring queue reject policy keeps the oldest elements") {
+    engine::net::MpscRingQueue<int> queue(4, engine::net::OverflowPolicy::Reject);
+    for (int i = 0; i < 4; ++i) {
+        CHECK(queue.push(i));
+    }
+    CHECK_FALSE(queue.push(4));
+    CHECK(queue.dropped() == 1u);
+    CHECK(*queue.try_pop() == 0);
+}
+
+TEST_CASE("ring queue drop-oldest policy keeps the newest elements") {
+    engine::net::SpscRingQueue<int> queue(4, engine::net::OverflowPolicy::DropOldest);
+    for (int i = 0; i < 10; ++i) {
+        CHECK(queue.push(i));
+    }
+    CHECK(queue.dropped() == 6u);
+    for (int i = 6; i < 10; ++i) {
+        CHECK(*queue.try_pop() == i);
+    }
+    CHECK(queue.empty());
+}
+
+TEST_CASE("mpsc ring queue delivers every element exactly once under contention") {
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 20000;
+    engine::net::MpscRingQueue<std::uint32_t> queue(256);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                const auto value = static_cast<std::uint32_t>(p * kPerProducer + i);
+                while (!queue.push(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> seen(kProducers * kPerProducer, 0);
+    std::vector<int> last_from(kProducers, -1);
+    bool in_order = true;
+    for (int received = 0; received < kProducers * kPerProducer;) {
+        if (auto value = queue.try_pop()) {
+            ++seen[*value];
+            const int producer = static_cast<int>(*value) / kPerProducer;
+            const int index = static_cast<int>(*value) % kPerProducer;
+            in_order = in_order && index > last_from[static_cast<std::size_t>(producer)];
+            last_from[static_cast<std::size_t>(producer)] = index;
+            ++received;
+        }
+    }
+    for (auto& thread : producers) {
+        thread.join();
+    }
+
+    CHECK(in_order);
+    bool exactly_once = true;
+    for (const int count : seen) {
+        exactly_once = exactly_once && count == 1;
+    }
+    CHECK(exactly_once);
+    CHECK(queue.empty());
+}
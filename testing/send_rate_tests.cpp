@@ -0,0 +1,93 @@
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "engine/net/packet.hpp"
+#include "engine/net/send_rate.hpp"
+
+namespace {
+
+using engine::net::PingMessage;
+using engine::net::SendRateController;
+using namespace std::chrono_literals;
+
+// One Ping report every 500 ms, as the client sends them, for `duration`.
+void report(SendRateController& controller, SendRateController::Clock::time_point& now,
+            std::chrono::milliseconds duration, std::uint16_t rtt_ms, std::uint16_t received, std::uint16_t expected) {
+    for (auto elapsed = 0ms; elapsed < duration; elapsed += 500ms) {
+        now += 500ms;
+        controller.on_report(PingMessage{0, rtt_ms, received, expected}, now);
+    }
+}
+
+}  // namespace
+
+TEST_CASE("send rate stays at full speed on a clean link") {
+    SendRateController controller;
+    auto now = SendRateController::Clock::time_point{} + 1h;
+    report(controller, now, 10s, 40, 30, 30);
+    CHECK(controller.rate().interval_ticks == 1);
+    CHECK(controller.rate().budget_percent == 100);
+    CHECK(controller.loss() == doctest::Approx(0.0));
+}
+
+TEST_CASE("send rate steps down on loss and shrinks snapshots") {
+    SendRateController controller;
+    auto now = SendRateController::Clock::time_point{} + 1h;
+    report(controller, now, 500ms, 40, 26, 30);  // 13% loss
+    CHECK(controller.rate().interval_ticks == 2);
+    CHECK(controller.rate().budget_percent == 50);
+
+    // At most one step per hold period.
+    report(controller, now, 500ms, 40, 14, 15);
+    CHECK(controller.rate().interval_ticks == 2);
+    report(controller, now, 500ms, 40, 14, 15);
+    CHECK(controller.rate().interval_ticks == 3);
+    report(controller, now, 5s, 40, 8, 10);
+    CHECK(controller.rate().interval_ticks == 3);  // Slowest level
+}
+
+TEST_CASE("send rate backs off when the round trip grows before any loss") {
+    SendRateController controller;
+    auto now = SendRateController::Clock::time_point{} + 1h;
+    report(controller, now, 2s, 30, 30, 30);
+    CHECK(controller.rate().interval_ticks == 1);
+
+    // Queues filling up: RTT climbs, nothing is lost yet.
+    report(controller, now, 3s, 200, 30, 30);
+    CHECK(controller.queue_delay_ms() > 60.0);
+    CHECK(controller.rate().interval_ticks > 1);
+    CHECK(controller.rate().budget_percent == 100);
+}
+
+TEST_CASE("send rate recovers one level at a time once the link is clean") {
+    SendRateController controller;
+    auto now = SendRateController::Clock::time_point{} + 1h;
+    report(controller, now, 2s, 40, 20, 30);
+    REQUIRE(controller.rate().interval_ticks == 3);
+
+    // Loss must decay below the threshold and stay there for the probe time.
+    report(controller, now, 3s, 40, 10, 10);
+    CHECK(controller.rate().interval_ticks == 3);
+    report(controller, now, 5s, 40, 10, 10);
+    CHECK(controller.rate().interval_ticks == 2);
+    report(controller, now, 3s, 40, 15, 15);
+    CHECK(controller.rate().interval_ticks == 1);
+    CHECK(controller.rate().budget_percent == 100);
+}
+
+TEST_CASE("ping reports round-trip and older empty pings are ignored") {
+    const PingMessage ping{123456, 42, 29, 30};
+    std::vector<std::uint8_t> payload;
+    engine::net::append_ping_payload(ping, payload);
+    auto decoded = engine::net::decode_ping_payload(payload);
+    REQUIRE(decoded);
+    CHECK(decoded->client_time_ms == ping.client_time_ms);
+    CHECK(decoded->rtt_ms == ping.rtt_ms);
+    CHECK(decoded->received == ping.received);
+    CHECK(decoded->expected == ping.expected);
+
+    CHECK_FALSE(engine::net::decode_ping_payload({}));
+}
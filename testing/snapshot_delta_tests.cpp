@@ -0,0 +1,356 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "engine/core/registry.hpp"
+#include "engine/game/components/core/position.hpp"
+#include "engine/game/components/core/velocity.hpp"
+#include "engine/game/components/gameplay/faction.hpp"
+#include "engine/game/components/gameplay/game_stats.hpp"
+#include "engine/game/components/network/owner.hpp"
+#include "engine/game/systems/network/network_send_system.hpp"
+#include "engine/game/systems/network/snapshot_codec.hpp"
+
+namespace {
+
+rtype::ecs::registry make_registry() {
+    rtype::ecs::registry reg;
+    reg.register_component<engine::game::components::Position>();
+    reg.register_component<engine::game::components::Velocity>();
+    reg.register_component<engine::game::components::GameStats>();
+    auto stats = reg.spawn_entity();
+    reg.emplace_component<engine::game::components::GameStats>(stats, 0u, 1u);
+    for (int i = 0; i < 20; ++i) {
+        auto entity = reg.spawn_entity();
+        reg.emplace_component<engine::game::components::Position>(entity, static_cast<float>(i) * 10.f, 50.f);
+        reg.emplace_component<engine::game::components::Velocity>(entity, 0.f, 0.f);
+    }
+    return reg;
+}
+
+// Ids of the entities written in a packed snapshot.
+std::vector<std::uint16_t> sent_ids(const engine::net::SnapshotMessage& snapshot) {
+    std::vector<std::uint16_t> ids;
+    auto view = rtype::game::parse_snapshot_blob(snapshot.blob, snapshot.flags);
+    REQUIRE(view.has_value());
+    engine::net::BitReader reader(view->entities);
+    for (std::size_t i = 0; i < view->entity_count; ++i) {
+        std::uint16_t id = 0;
+        rtype::game::EntityState state{};
+        REQUIRE(rtype::game::read_entity_id(reader, id));
+        REQUIRE(rtype::game::read_entity_fields(reader, state));
+        ids.push_back(id);
+    }
+    return ids;
+}
+
+}  // namespace
+
+TEST_CASE("per-client deltas rebuild the exact full snapshot on the client") {
+    auto reg = make_registry();
+    rtype::game::NetworkSendSystem send;
+    rtype::game::SnapshotDeltaDecoder decoder;
+
+    send.capture(reg, 1, false);
+    const auto& first = send.snapshot_for(0);
+    CHECK((first.flags & rtype::game::kSnapshotFlagFull) != 0);
+    REQUIRE(decoder.decode(first).has_value());
+
+    // Move one entity, remove one, add one.
+    reg.try_get<engine::game::components::Position>(rtype::ecs::entity_t{3})->x = 999.f;
+    reg.kill_entity(rtype::ecs::entity_t{5});
+    auto added = reg.spawn_entity();
+    reg.emplace_component<engine::game::components::Position>(added, 1.f, 2.f);
+
+    send.capture(reg, 2, false);
+    const auto full = send.snapshot_for(0);
+    const auto& delta = send.snapshot_for(1);
+    CHECK((delta.flags & rtype::game::kSnapshotFlagDelta) != 0);
+    CHECK(delta.blob.size() < full.blob.size());
+    CHECK(&send.snapshot_for(1) == &delta);  // Encoded once per baseline
+
+    auto view = rtype::game::parse_snapshot_blob(delta.blob, delta.flags);
+    REQUIRE(view.has_value());
+    CHECK(view->baseline_tick == 1u);
+    CHECK(view->entity_count == 2);
+    REQUIRE(view->removed_count() == 1);
+    CHECK(view->removed_id(0) == 5);
+    CHECK(view->removed_reason(0) == rtype::game::DespawnReason::Destroyed);
+
+    auto rebuilt = decoder.decode(delta);
+    REQUIRE(rebuilt.has_value());
+    CHECK(rebuilt->flags == rtype::game::kSnapshotFlagFull);
+    auto expected = rtype::game::SnapshotDeltaDecoder{}.decode(full);
+    REQUIRE(expected.has_value());
+    // Same entities and stats, followed by the delta's despawn record.
+    REQUIRE(rebuilt->blob.size() == expected->blob.size() + 2 + rtype::game::kDespawnRecordSize);
+    CHECK(std::equal(expected->blob.begin(), expected->blob.end(), rebuilt->blob.begin()));
+    auto rebuilt_view = rtype::game::parse_snapshot_blob(rebuilt->blob, rebuilt->flags);
+    REQUIRE(rebuilt_view.has_value());
+    REQUIRE(rebuilt_view->removed_count() == 1);
+    CHECK(rebuilt_view->removed_id(0) == 5);
+}
+
+TEST_CASE("despawn records carry the noted or inferred reason") {
+    auto reg = make_registry();
+    rtype::game::NetworkSendSystem send;
+    rtype::game::SnapshotDeltaDecoder decoder;
+
+    // Entity 4 is about to cross the right edge of the screen.
+    reg.try_get<engine::game::components::Position>(rtype::ecs::entity_t{4})->x = 1915.f;
+    reg.try_get<engine::game::components::Velocity>(rtype::ecs::entity_t{4})->vx = 600.f;
+    send.capture(reg, 1, false);
+    REQUIRE(decoder.decode(send.snapshot_for(0)).has_value());
+
+    send.note_despawn(3, rtype::game::DespawnReason::Killed);
+    for (const rtype::ecs::entity_id_t id : {3u, 4u, 5u}) {
+        reg.kill_entity(rtype::ecs::entity_t{id});
+    }
+    send.capture(reg, 2, false);
+    // Still reported against an older baseline, after more ticks went by.
+    send.capture(reg, 3, false);
+    const auto& delta = send.snapshot_for(1);
+    REQUIRE((delta.flags & rtype::game::kSnapshotFlagDelta) != 0);
+
+    auto view = rtype::game::parse_snapshot_blob(delta.blob, delta.flags);
+    REQUIRE(view.has_value());
+    REQUIRE(view->removed_count() == 3);
+    CHECK(view->removed_id(0) == 3);
+    CHECK(view->removed_reason(0) == rtype::game::DespawnReason::Killed);
+    CHECK(view->removed_id(1) == 4);
+    CHECK(view->removed_reason(1) == rtype::game::DespawnReason::OffScreen);
+    CHECK(view->removed_id(2) == 5);
+    CHECK(view->removed_reason(2) == rtype::game::DespawnReason::Destroyed);
+
+    auto rebuilt = decoder.decode(delta);
+    REQUIRE(rebuilt.has_value());
+    auto rebuilt_view = rtype::game::parse_snapshot_blob(rebuilt->blob, rebuilt->flags);
+    REQUIRE(rebuilt_view.has_value());
+    CHECK(rebuilt_view->entity_count == 17);
+    REQUIRE(rebuilt_view->removed_count() == 3);
+    CHECK(rebuilt_view->removed_reason(1) == rtype::game::DespawnReason::OffScreen);
+}
+
+TEST_CASE("deltas need a baseline both sides still hold") {
+    auto reg = make_registry();
+    rtype::game::NetworkSendSystem send;
+    rtype::game::SnapshotDeltaDecoder decoder;
+
+    send.capture(reg, 1, false);
+    send.capture(reg, 2, false);
+    const auto& delta = send.snapshot_for(1);
+    REQUIRE((delta.flags & rtype::game::kSnapshotFlagDelta) != 0);
+    CHECK_FALSE(decoder.decode(delta).has_value());  // Tick 1 never reached this client
+
+    // Baselines older than the history fall back to a full snapshot.
+    send.capture(reg, 1 + rtype::game::NetworkSendSystem::kHistorySize, false);
+    CHECK((send.snapshot_for(1).flags & rtype::game::kSnapshotFlagFull) != 0);
+    CHECK((send.snapshot_for(0).flags & rtype::game::kSnapshotFlagFull) != 0);
+}
+
+TEST_CASE("packed entities round-trip at wire precision and stay under 10 bytes") {
+    rtype::game::EntityState moving;
+    moving.x = 640.37f;
+    moving.y = -20.9f;
+    moving.vx = -300.f;
+    moving.vy = 12.34f;
+    moving.sprite_id = 3;
+
+    auto expected = moving;
+    rtype::game::quantize(expected);
+    CHECK(std::abs(expected.x - moving.x) <= 0.07f);
+    CHECK(std::abs(expected.y - moving.y) <= 0.07f);
+    CHECK(std::abs(expected.vy - moving.vy) <= 0.07f);
+
+    // New entity (reference = defaults): position, velocity and sprite are written.
+    std::vector<std::uint8_t> bytes;
+    engine::net::BitWriter writer(bytes);
+    rtype::game::write_entity(writer, 42, expected, rtype::game::EntityState{});
+    // Next tick only the position moved.
+    auto next = expected;
+    next.x -= 5.f;
+    rtype::game::quantize(next);
+    rtype::game::write_entity(writer, 42, next, expected);
+    writer.flush();
+    CHECK(bytes.size() < 2 * 10);
+
+    engine::net::BitReader reader(bytes);
+    std::uint16_t id = 0;
+    rtype::game::EntityState decoded{};
+    REQUIRE(rtype::game::read_entity_id(reader, id));
+    REQUIRE(rtype::game::read_entity_fields(reader, decoded));
+    CHECK(id == 42);
+    CHECK(decoded == expected);
+    auto decoded_next = decoded;
+    REQUIRE(rtype::game::read_entity_id(reader, id));
+    REQUIRE(rtype::game::read_entity_fields(reader, decoded_next));
+    CHECK(decoded_next == next);
+    CHECK(reader.bits_remaining() < 8);
+}
+
+TEST_CASE("packed snapshots average under 10 bytes per moving entity") {
+    auto reg = make_registry();
+    rtype::game::NetworkSendSystem send;
+    send.capture(reg, 1, false);
+    reg.view<engine::game::components::Position>([](std::size_t, auto& pos) { pos.x -= 3.f; });
+    send.capture(reg, 2, false);
+
+    const auto& delta = send.snapshot_for(1);
+    auto view = rtype::game::parse_snapshot_blob(delta.blob, delta.flags);
+    REQUIRE(view.has_value());
+    REQUIRE(view->entity_count == 20);
+    CHECK(view->entities.size() < 20 * 10);
+}
+
+TEST_CASE("budgeted snapshots stay under budget and converge to the full world") {
+    rtype::ecs::registry reg;
+    reg.register_component<engine::game::components::Position>();
+    for (int i = 0; i < 300; ++i) {
+        auto entity = reg.spawn_entity();
+        reg.emplace_component<engine::game::components::Position>(entity, static_cast<float>(i), 100.f);
+    }
+    rtype::game::NetworkSendSystem send;
+    send.set_replication_budget(256);
+    rtype::game::SnapshotDeltaDecoder decoder;
+
+    std::uint32_t acked = 0;
+    std::optional<engine::net::SnapshotMessage> decoded;
+    for (std::uint32_t tick = 1; tick <= 20; ++tick) {
+        send.capture(reg, tick, false);
+        const auto& snapshot = send.snapshot_for(1, acked);
+        CHECK(snapshot.blob.size() <= 256);
+        decoded = decoder.decode(snapshot);
+        REQUIRE(decoded.has_value());
+        acked = tick;
+    }
+    auto expected = rtype::game::SnapshotDeltaDecoder{}.decode(send.snapshot_for(0));
+    REQUIRE(expected.has_value());
+    CHECK(decoded->blob == expected->blob);
+}
+
+TEST_CASE("the shared full snapshot is only encoded when a client is sent it") {
+    auto reg = make_registry();
+    rtype::game::NetworkSendSystem send;
+    send.set_debug_logging(true);  // Logs "type=FULL" for each full encoding
+    std::ostringstream log;
+    auto* const previous = std::cout.rdbuf(log.rdbuf());
+    const auto full_encodings = [&log] {
+        const auto text = log.str();
+        std::size_t count = 0;
+        for (auto pos = text.find("type=FULL"); pos != std::string::npos; pos = text.find("type=FULL", pos + 1)) {
+            ++count;
+        }
+        return count;
+    };
+
+    send.capture(reg, 1, false);
+    send.snapshot_for(1, 0);  // Budgeted, no baseline: the client's own full view
+    send.capture(reg, 2, false);
+    send.snapshot_for(1, 1);  // Budgeted delta
+    const auto budgeted = full_encodings();
+    send.snapshot_for(0);
+    send.snapshot_for(0);  // Encoded once per tick
+    const auto total = full_encodings();
+    std::cout.rdbuf(previous);
+
+    CHECK(budgeted == 1);
+    CHECK(total == 2);
+}
+
+TEST_CASE("a lower budget share shrinks each client's snapshot") {
+    rtype::ecs::registry reg;
+    reg.register_component<engine::game::components::Position>();
+    for (int i = 0; i < 300; ++i) {
+        auto entity = reg.spawn_entity();
+        reg.emplace_component<engine::game::components::Position>(entity, static_cast<float>(i), 100.f);
+    }
+    rtype::game::NetworkSendSystem send;
+    send.set_replication_budget(512);
+    send.capture(reg, 1, false);
+    const auto full_share = send.snapshot_for(1, 0).blob.size();
+    const auto half_share = send.snapshot_for(2, 0, 50).blob.size();
+    CHECK(full_share > 256);
+    CHECK(half_share <= 256);
+}
+
+TEST_CASE("priority accumulation favours the client's ship without starving the rest") {
+    rtype::ecs::registry reg;
+    reg.register_component<engine::game::components::Position>();
+    reg.register_component<engine::game::components::Owner>();
+    reg.register_component<engine::game::components::FactionComponent>();
+    auto ship = reg.spawn_entity();
+    reg.emplace_component<engine::game::components::Position>(ship, 100.f, 100.f);
+    reg.emplace_component<engine::game::components::Owner>(ship, std::uint16_t{7});
+    for (int i = 0; i < 100; ++i) {
+        auto enemy = reg.spawn_entity();
+        reg.emplace_component<engine::game::components::Position>(enemy, 200.f + static_cast<float>(i) * 10.f, 300.f);
+        reg.emplace_component<engine::game::components::FactionComponent>(enemy, engine::game::components::Faction::ENEMY);
+    }
+    const auto ship_id = static_cast<std::uint16_t>(static_cast<rtype::ecs::entity_id_t>(ship));
+
+    rtype::game::NetworkSendSystem send;
+    send.set_replication_budget(200);  // Roughly a quarter of the entities per tick
+    std::vector<std::uint32_t> last_sent(101, 0);
+    std::uint32_t worst_gap = 0;
+    std::uint32_t acked = 0;
+    for (std::uint32_t tick = 1; tick <= 60; ++tick) {
+        // Everything moves every tick, so every entity always has a pending change.
+        reg.view<engine::game::components::Position>([](std::size_t, auto& pos) { pos.x += 1.f; });
+        send.capture(reg, tick, false);
+        const auto& snapshot = send.snapshot_for(7, acked);
+        CHECK(snapshot.blob.size() <= 200);
+        const auto ids = sent_ids(snapshot);
+        CHECK(std::find(ids.begin(), ids.end(), ship_id) != ids.end());
+        for (const auto id : ids) {
+            if (tick > 10) {
+                worst_gap = std::max(worst_gap, tick - last_sent[id]);
+            }
+            last_sent[id] = tick;
+        }
+        acked = tick;
+    }
+    for (std::uint16_t id = 0; id <= 100; ++id) {
+        CHECK(last_sent[id] > 50);
+    }
+    CHECK(worst_gap <= 10);
+}
+
+TEST_CASE("sampling and committing apart matches capture, superseded samples included") {
+    auto reg = make_registry();
+    rtype::game::NetworkSendSystem reference;
+    rtype::game::NetworkSendSystem pipelined;
+    rtype::game::NetworkSendSystem::Capture first;
+    rtype::game::NetworkSendSystem::Capture second;
+
+    reference.capture(reg, 1, false);
+    pipelined.sample(reg, 1, false, first);
+    pipelined.commit(first);
+
+    // Tick 2 removes entity 3 with a noted reason; its capture is superseded by tick 3's.
+    reference.note_despawn(3, rtype::game::DespawnReason::Killed);
+    pipelined.note_despawn(3, rtype::game::DespawnReason::Killed);
+    reg.kill_entity(rtype::ecs::entity_t{3});
+    reference.capture(reg, 2, false);
+    pipelined.sample(reg, 2, false, first);
+    reg.try_get<engine::game::components::Position>(rtype::ecs::entity_t{6})->y = 80.f;
+    reference.capture(reg, 3, false);
+    pipelined.sample(reg, 3, false, second);
+    rtype::game::NetworkSendSystem::fold(first, second);
+    pipelined.commit(second);
+
+    CHECK(pipelined.snapshot_for(0).blob == reference.snapshot_for(0).blob);
+    const auto& delta = pipelined.snapshot_for(1);
+    CHECK(delta.blob == reference.snapshot_for(1).blob);
+    auto view = rtype::game::parse_snapshot_blob(delta.blob, delta.flags);
+    REQUIRE(view.has_value());
+    REQUIRE(view->removed_count() == 1);
+    CHECK(view->removed_id(0) == 3);
+    CHECK(view->removed_reason(0) == rtype::game::DespawnReason::Killed);
+}
@@ -0,0 +1,102 @@
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <cstdint>
+
+#include "engine/core/tick_clock.hpp"
+
+namespace {
+
+using engine::core::OverrunPolicy;
+using engine::core::TickClock;
+using namespace std::chrono_literals;
+
+const TickClock::Clock::time_point kEpoch{1s};
+
+// Where tick `n` of a 60 Hz clock reset at kEpoch is due.
+TickClock::Clock::time_point slot(std::int64_t n) {
+    return kEpoch + std::chrono::nanoseconds(n * 1'000'000'000 / 60);
+}
+
+TickClock make_clock(OverrunPolicy policy) {
+    TickClock::Options options;
+    options.ticks_per_second = 60;
+    options.policy = policy;
+    TickClock clock(options);
+    clock.reset(kEpoch);
+    return clock;
+}
+
+}  // namespace
+
+TEST_CASE("tick deadlines follow an exact grid without drift") {
+    auto clock = make_clock(OverrunPolicy::Skip);
+    CHECK(clock.deadline() == kEpoch);
+    for (int i = 0; i < 600; ++i) {
+        // Every tick starts late by a wake-up delay and takes a while, within budget.
+        const auto started = clock.deadline() + 300us;
+        clock.finish_tick(started, started + 5ms);
+    }
+    // 600 ticks at 60 Hz: exactly ten seconds, where a rounded 16 ms period would give 9.6.
+    CHECK(clock.deadline() == kEpoch + 10s);
+    CHECK(clock.stats().overruns == 0);
+    CHECK(clock.stats().work.count() == 600);
+    CHECK(clock.stats().interval.count() == 599);
+    CHECK(clock.stats().interval.percentile(0.99) <= 17ms);
+}
+
+TEST_CASE("catch up runs late ticks back to back, up to a limit") {
+    auto clock = make_clock(OverrunPolicy::CatchUp);
+    const auto period = clock.period();
+    clock.finish_tick(kEpoch, kEpoch + period * 3 + 1ms);
+    CHECK(clock.stats().overruns == 1);
+    CHECK(clock.stats().skipped == 0);
+    CHECK(clock.deadline() == slot(1));  // Already due: the next tick runs at once
+
+    auto far_behind = make_clock(OverrunPolicy::CatchUp);
+    far_behind.finish_tick(kEpoch, kEpoch + period * 11 + 1ms);
+    // Ten whole slots went by; four are caught up, the rest dropped.
+    CHECK(far_behind.stats().skipped == 6);
+    CHECK(far_behind.deadline() == slot(7));
+}
+
+TEST_CASE("skip drops late ticks and keeps the original phase") {
+    auto clock = make_clock(OverrunPolicy::Skip);
+    const auto period = clock.period();
+    clock.finish_tick(kEpoch, kEpoch + period * 2 + 1ms);
+    CHECK(clock.stats().overruns == 1);
+    CHECK(clock.stats().skipped == 2);
+    CHECK(clock.deadline() == slot(3));
+    CHECK(clock.deadline() > kEpoch + period * 2 + 1ms);
+}
+
+TEST_CASE("slow down shifts the schedule to the end of the late tick") {
+    auto clock = make_clock(OverrunPolicy::SlowDown);
+    const auto period = clock.period();
+    const auto finished = kEpoch + period * 2 + 1ms;
+    clock.finish_tick(kEpoch, finished);
+    CHECK(clock.stats().overruns == 1);
+    CHECK(clock.stats().skipped == 0);
+    CHECK(clock.deadline() == finished);  // The next tick starts right away
+
+    clock.finish_tick(finished, finished + 1ms);
+    CHECK(clock.stats().interval.count() == 1);  // The interval across the shift still counts
+    CHECK(clock.deadline() == finished + period);
+}
+
+TEST_CASE("tick histograms report percentiles at bucket resolution") {
+    engine::core::TickHistogram histogram;
+    CHECK(histogram.percentile(0.5) == 0ns);
+    for (int i = 0; i < 99; ++i) {
+        histogram.record(1ms);
+    }
+    histogram.record(80ms);  // Past the last bucket: reported as the exact maximum
+    CHECK(histogram.percentile(0.5) == 1050us);
+    CHECK(histogram.percentile(0.99) == 1050us);
+    CHECK(histogram.percentile(1.0) == 80ms);
+    CHECK(histogram.max() == 80ms);
+    CHECK(histogram.sum() == 99ms + 80ms);
+    CHECK(histogram.count_at_most(1ms) == 0);  // 1 ms samples sit in the bucket ending at 1.05 ms
+    CHECK(histogram.count_at_most(2ms) == 99);
+    CHECK(histogram.count_at_most(1s) == 99);  // The clamped bucket has no upper bound
+}
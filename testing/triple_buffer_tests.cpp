@@ -0,0 +1,67 @@
+#include <doctest/doctest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "engine/net/triple_buffer.hpp"
+
+TEST_CASE("triple buffer hands over each published value once") {
+    engine::net::TripleBuffer<int> buffer;
+    CHECK(buffer.take() == nullptr);
+
+    buffer.back() = 1;
+    CHECK_FALSE(buffer.publish());
+    auto* taken = buffer.take();
+    REQUIRE(taken != nullptr);
+    CHECK(*taken == 1);
+    CHECK(buffer.take() == nullptr);
+
+    buffer.back() = 2;
+    buffer.publish();
+    CHECK(*buffer.take() == 2);
+}
+
+TEST_CASE("triple buffer supersedes an untaken value and lets the producer fold it") {
+    engine::net::TripleBuffer<std::vector<int>> buffer;
+    buffer.back() = {1};
+    buffer.publish();
+    buffer.back() = {2};
+    const bool superseded = buffer.publish([](std::vector<int>& older, std::vector<int>& newer) {
+        newer.insert(newer.begin(), older.begin(), older.end());
+    });
+    CHECK(superseded);
+
+    auto* taken = buffer.take();
+    REQUIRE(taken != nullptr);
+    CHECK(*taken == std::vector<int>{1, 2});
+    CHECK(buffer.take() == nullptr);
+    // The superseded slot comes back to the producer for reuse.
+    CHECK(buffer.back() == std::vector<int>{1});
+}
+
+TEST_CASE("triple buffer consumer sees increasing values and ends on the newest") {
+    constexpr std::uint32_t kValues = 100000;
+    engine::net::TripleBuffer<std::uint32_t> buffer;
+
+    std::thread producer([&buffer] {
+        for (std::uint32_t value = 1; value <= kValues; ++value) {
+            buffer.back() = value;
+            buffer.publish();
+        }
+    });
+
+    std::uint32_t last = 0;
+    bool increasing = true;
+    while (last != kValues) {
+        if (const auto* value = buffer.take()) {
+            increasing = increasing && *value > last;
+            last = *value;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    CHECK(increasing);
+    CHECK(buffer.take() == nullptr);
+}
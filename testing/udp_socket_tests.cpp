@@ -0,0 +1,51 @@
+#include <doctest/doctest.h>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <system_error>
+#include <vector>
+
+#include "engine/net/udp_socket.hpp"
+
+TEST_CASE("send_batch skips a datagram the kernel refuses and sends the rest") {
+    asio::io_context io;
+    engine::net::UdpSocket receiver(io);
+    receiver.bind(0);
+    engine::net::UdpSocket sender(io);
+    sender.bind(0);
+    const asio::ip::udp::endpoint target(asio::ip::make_address_v4("127.0.0.1"),
+                                         receiver.native().local_endpoint().port());
+    // Broadcasting without SO_BROADCAST fails with EACCES, like an unreachable client would.
+    const asio::ip::udp::endpoint refused(asio::ip::address_v4::broadcast(), target.port());
+
+    const std::array<std::uint8_t, 1> first{1};
+    const std::array<std::uint8_t, 1> lost{2};
+    const std::array<std::uint8_t, 1> last{3};
+    const std::array<std::uint8_t, 1> tail{9};
+    const std::vector<engine::net::OutgoingDatagram> batch{
+        {first, target}, {lost, refused}, {lost, refused}, {last, target, tail}};
+
+    std::error_code ec;
+    CHECK(sender.send_batch(batch, ec) == 2);
+    CHECK(ec == std::errc::permission_denied);
+
+    std::array<std::array<std::uint8_t, 8>, 4> storage{};
+    std::array<engine::net::IncomingDatagram, 4> slots{};
+    for (std::size_t i = 0; i < slots.size(); ++i) {
+        slots[i].buffer = storage[i];
+    }
+    std::vector<std::vector<std::uint8_t>> received;
+    // Loopback delivers during the send: whatever arrived is queued by now.
+    while (received.size() < 2 && receiver.native().available() > 0) {
+        const auto count = receiver.receive_batch(std::span(slots).first(2 - received.size()), ec);
+        REQUIRE_FALSE(ec);
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto& slot = slots[i];
+            received.emplace_back(slot.buffer.begin(), slot.buffer.begin() + static_cast<std::ptrdiff_t>(slot.size));
+        }
+    }
+    REQUIRE(received.size() == 2);
+    CHECK(received[0] == std::vector<std::uint8_t>{1});
+    CHECK(received[1] == std::vector<std::uint8_t>{3, 9});
+}
@@ -0,0 +1,286 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "engine/core/registry.hpp"
+#include "engine/game/components/core/position.hpp"
+#include "engine/game/components/core/velocity.hpp"
+#include "engine/game/components/gameplay/game_stats.hpp"
+#include "engine/game/systems/network/network_send_system.hpp"
+#include "engine/game/systems/network/snapshot_codec.hpp"
+#include "engine/net/packet.hpp"
+#include "network_client.hpp"
+#include "network_server.hpp"
+
+// Counts heap allocations made by every thread while a test asks for it: the server's
+// listener and the client's listen thread do their share of the packet work. The whole
+// replaceable set goes through malloc/free so that every new meets its own delete.
+namespace {
+std::atomic_bool g_counting{false};
+std::atomic<std::size_t> g_allocations{0};
+
+void* allocate(std::size_t size, std::size_t alignment) noexcept {
+    if (g_counting.load(std::memory_order_relaxed)) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    size = size == 0 ? 1 : size;
+    if (alignment <= alignof(std::max_align_t)) {
+        return std::malloc(size);
+    }
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+void* allocate_or_throw(std::size_t size, std::size_t alignment) {
+    if (void* memory = allocate(size, alignment)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+}  // namespace
+
+void* operator new(std::size_t size) {
+    return allocate_or_throw(size, 0);
+}
+void* operator new[](std::size_t size) {
+    return allocate_or_throw(size, 0);
+}
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, 0);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, 0);
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+void operator delete(void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+void operator delete[](void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+
+namespace {
+
+struct AllocationCounter {
+    AllocationCounter() {
+        g_allocations = 0;
+        g_counting = true;
+    }
+    ~AllocationCounter() { g_counting = false; }
+
+    std::size_t stop() {
+        g_counting = false;
+        return g_allocations;
+    }
+};
+
+// Enough entities for a snapshot of several datagrams, in rows that compress well.
+constexpr int kEntities = 400;
+
+rtype::ecs::registry make_world() {
+    rtype::ecs::registry reg;
+    reg.register_component<engine::game::components::Position>();
+    reg.register_component<engine::game::components::Velocity>();
+    reg.register_component<engine::game::components::GameStats>();
+    auto stats = reg.spawn_entity();
+    reg.emplace_component<engine::game::components::GameStats>(stats, 0u, 1u);
+    for (int i = 0; i < kEntities; ++i) {
+        auto entity = reg.spawn_entity();
+        reg.emplace_component<engine::game::components::Position>(
+            entity, static_cast<float>(i % 40) * 40.f, static_cast<float>(i / 40) * 60.f);
+        reg.emplace_component<engine::game::components::Velocity>(entity, -120.f, 0.f);
+    }
+    return reg;
+}
+
+void step_world(rtype::ecs::registry& reg) {
+    reg.view<engine::game::components::Position, engine::game::components::Velocity>(
+        [](std::size_t, auto& pos, const auto& vel) {
+            pos.x += vel.vx / 60.f;
+            if (pos.x < 0.f) {
+                pos.x += 1600.f;
+            }
+        });
+}
+
+template <typename Predicate>
+bool wait_for(Predicate done) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+// A room's tick thread and a client's game thread, played in lockstep by the test over
+// loopback: the real NetworkServer broadcast and event flush, the real NetworkClient
+// receive path (fragment reassembly, inflate, delta decode) and the input back.
+struct Session {
+    server::NetworkServer server{1};
+    NetworkClient client;
+    rtype::game::NetworkSendSystem send;
+    server::NetworkServer::SnapshotEncoder encoder;
+    std::size_t raw_bytes{0};  // Blob bytes the encoder handed out, before compression
+    std::uint32_t inputs_received{0};
+
+    Session() : client("127.0.0.1", start_server(server)) {
+        // Large enough for the whole world in every delta: snapshots span several datagrams.
+        send.set_replication_budget(16 * 1024);
+        encoder = [this](std::uint16_t client_id, std::uint32_t acked_tick,
+                         engine::net::SendRate rate) -> const engine::net::SnapshotMessage& {
+            const auto& snapshot = send.snapshot_for(client_id, acked_tick, rate.budget_percent);
+            raw_bytes += snapshot.blob.size();
+            return snapshot;
+        };
+    }
+
+    ~Session() {
+        server.stop();
+        // shutdown() leaves the listen and ping threads to notice on their own.
+        client.shutdown();
+        std::this_thread::sleep_for(std::chrono::milliseconds(600));
+    }
+
+    static std::uint16_t start_server(server::NetworkServer& server) {
+        server.start(0);
+        return server.port();
+    }
+
+    // One tick: the server sends the snapshot, the client takes it in and answers with an input.
+    bool tick(rtype::ecs::registry& reg, std::uint32_t tick) {
+        step_world(reg);
+        send.capture(reg, tick, false);
+        server.broadcast_snapshot(0, encoder);
+        server.flush_events(0);
+
+        const bool decoded = wait_for([&] {
+            auto snapshot = client.poll_snapshot();
+            if (!snapshot) {
+                return false;
+            }
+            const bool current = snapshot->tick == tick;
+            client.release_snapshot(std::move(*snapshot));
+            return current;
+        });
+        client.send_input(static_cast<std::uint16_t>(tick & 0x0F));
+        return decoded && wait_for([&] {
+            while (auto input = server.poll_input(0)) {
+                if (input->input_mask == (tick & 0x0F)) {
+                    ++inputs_received;
+                    return true;
+                }
+            }
+            return false;
+        });
+    }
+};
+
+}  // namespace
+
+TEST_CASE("server broadcast and client receive do not allocate per packet in steady state") {
+    auto reg = make_world();
+    Session session;
+    REQUIRE(session.client.connect("alloc", 1, 1));
+    REQUIRE(wait_for([&] { return session.server.poll_event(0).has_value(); }));
+    const auto clients = session.server.clients();
+    REQUIRE(clients->size() == 1);
+    const auto& info = *clients->begin()->second;
+
+    std::uint32_t tick = 1;
+    // Warm-up: history, client views, scratch and recycled buffers grow to the world's size.
+    for (; tick <= 200; ++tick) {
+        REQUIRE(session.tick(reg, tick));
+    }
+
+    const auto datagrams_before = info.datagrams_sent.load();
+    const auto bytes_before = info.bytes_sent.load();
+    const auto raw_before = session.raw_bytes;
+    std::size_t allocations = 0;
+    {
+        AllocationCounter counter;
+        for (; tick <= 400; ++tick) {
+            if (!session.tick(reg, tick)) {
+                break;
+            }
+        }
+        allocations = counter.stop();
+    }
+    CHECK(tick == 401);
+    CHECK(allocations == 0);
+    CHECK(session.inputs_received == 400);
+
+    // What went through: every snapshot fragmented, and compressed below its raw size.
+    CHECK(info.datagrams_sent.load() - datagrams_before >= 2 * 200);
+    CHECK(info.bytes_sent.load() - bytes_before < session.raw_bytes - raw_before);
+}
+
+TEST_CASE("fixed buffers refuse writes past their capacity") {
+    engine::net::FixedBuffer<8> buffer;
+    engine::net::begin_packet(buffer, engine::net::PacketHeader{});
+    CHECK(buffer.size() == engine::net::kPacketHeaderSize);
+    CHECK_FALSE(buffer.overflowed());
+
+    engine::net::write_value(buffer, std::uint8_t{1});
+    CHECK(buffer.size() == engine::net::kPacketHeaderSize);
+    CHECK(buffer.overflowed());
+
+    buffer.clear();
+    CHECK_FALSE(buffer.overflowed());
+    engine::net::write_value(buffer, std::uint32_t{7});
+    auto bytes = buffer.bytes();
+    std::uint32_t value = 0;
+    REQUIRE(engine::net::read_value(bytes, value));
+    CHECK(value == 7);
+}